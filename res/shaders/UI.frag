@@ -2,18 +2,16 @@
 out vec4 FragColor;
 
 in vec2 TexCoord;
+in vec4 Color;
+in float IsText;
 
-uniform bool isText;
 uniform sampler2D texture1;
-uniform vec3 textColor;
-uniform vec3 color;
-uniform float alpha;
 
 void main()
 {
-    if (isText) {
+    if (IsText > 0.5) {
         vec4 sampled = vec4(1.0, 1.0, 1.0, texture(texture1, TexCoord).r);
-        vec4 texColor = vec4(textColor, 1.0) * sampled;
+        vec4 texColor = vec4(Color.rgb, 1.0) * sampled;
         if(texColor.a < 0.5)
             discard;
         FragColor = vec4(texColor.rgb, 1.0f);
@@ -22,6 +20,6 @@ void main()
         vec4 texColor = texture(texture1, TexCoord);
         if(texColor.a < 0.5)
             discard;
-        FragColor = texColor * vec4(color, alpha);
+        FragColor = texColor * Color;
     }
-}
\ No newline at end of file
+}
@@ -1,11 +1,17 @@
 #version 430 core
 layout (location = 0) in vec3 aPos;
 layout (location = 2) in vec2 aTexCoord;
+layout (location = 3) in vec4 aColor;
+layout (location = 4) in float aIsText;
 
 out vec2 TexCoord;
+out vec4 Color;
+out float IsText;
 
 void main()
 {
     gl_Position = vec4(aPos, 1.0);
     TexCoord = aTexCoord;
-}
\ No newline at end of file
+    Color = aColor;
+    IsText = aIsText;
+}
@@ -2,55 +2,66 @@
 layout(location = 0) in vec3 aPos;
 layout(location = 1) in vec3 aNormal;
 layout(location = 2) in vec2 aTexCoords;
-layout(location = 5) in ivec4 boneIds;
+layout(location = 5) in uvec4 boneIds;
 layout(location = 6) in vec4 weights;
+// per instance
+layout(location = 7) in mat4 instanceModel;
+layout(location = 11) in vec3 instanceColor;
+layout(location = 12) in vec2 instanceTexStrech;
+layout(location = 13) in int instanceBonesOffset;
 
 out vec2 TexCoords;
 out vec3 Normal;
 out vec3 FragPos;
-out vec4 FragPosLightSpace;
+flat out vec3 InstanceColor;
 
 uniform mat4 projection;
 uniform mat4 view;
 uniform mat4 model;
-uniform mat4 lightSpaceMatrix = mat4(0.0f);
 
 const int MAX_BONES = 15;
 const int MAX_BONE_INFLUENCE = 4;
-uniform mat4 finalBonesMatrices[MAX_BONES];
+// final bone matrices of every animated object drawn this frame
+layout(std430, binding = 0) readonly buffer BonePalette {
+    mat4 bonesMatrices[];
+};
+uniform int bonesOffset = 0;
 
 uniform bool isAnimated = false;
+uniform bool isInstanced = false;
 uniform vec2 texStrech = vec2(1, 1);
 
 void main()
 {
+    mat4 modelMatrix = isInstanced ? instanceModel : model;
+    int firstBone = isInstanced ? instanceBonesOffset : bonesOffset;
+    vec2 texCoordsStrech = isInstanced ? instanceTexStrech : texStrech;
+    InstanceColor = instanceColor;
 
     if (isAnimated == true) {
         vec4 totalPosition = vec4(0.0f);
         for(int i = 0 ; i < MAX_BONE_INFLUENCE ; i++)
         {
-            if(boneIds[i] == -1)
+            if(weights[i] == 0.0f)
             continue;
             if(boneIds[i] >= MAX_BONES)
             {
                 totalPosition = vec4(aPos,1.0f);
                 break;
             }
-            vec4 localPosition = finalBonesMatrices[boneIds[i]] * vec4(aPos, 1.0f);
+            vec4 localPosition = bonesMatrices[firstBone + int(boneIds[i])] * vec4(aPos, 1.0f);
             totalPosition += localPosition * weights[i];
         }
 
-        FragPos = vec3(model * totalPosition);
-        TexCoords = vec2(aTexCoords.x * texStrech.x, aTexCoords.y * texStrech.y);
-        Normal = mat3(transpose(inverse(model))) * aNormal;
-        FragPosLightSpace = lightSpaceMatrix * vec4(FragPos, 1.0);
-        gl_Position =  projection * view * model * totalPosition;
+        FragPos = vec3(modelMatrix * totalPosition);
+        TexCoords = vec2(aTexCoords.x * texCoordsStrech.x, aTexCoords.y * texCoordsStrech.y);
+        Normal = mat3(transpose(inverse(modelMatrix))) * aNormal;
+        gl_Position =  projection * view * modelMatrix * totalPosition;
     }
     else {
-        FragPos = vec3(model * vec4(aPos, 1.0));
-        TexCoords = vec2(aTexCoords.x * texStrech.x, aTexCoords.y * texStrech.y);
-        Normal = mat3(transpose(inverse(model))) * aNormal;
-        FragPosLightSpace = lightSpaceMatrix * vec4(FragPos, 1.0);
-        gl_Position = projection * view * model * vec4(aPos, 1.0);
+        FragPos = vec3(modelMatrix * vec4(aPos, 1.0));
+        TexCoords = vec2(aTexCoords.x * texCoordsStrech.x, aTexCoords.y * texCoordsStrech.y);
+        Normal = mat3(transpose(inverse(modelMatrix))) * aNormal;
+        gl_Position = projection * view * modelMatrix * vec4(aPos, 1.0);
     }
 }
\ No newline at end of file
@@ -1,6 +1,10 @@
 #version 430
 
-out vec4 FragColor;
+layout (location = 0) out vec4 FragColor;
+// the sky has no geometry, zero w marks it for deferredLighting.frag and post processing
+layout (location = 1) out vec4 FragPosition;
+layout (location = 2) out vec4 FragNormal;
+layout (location = 3) out vec4 FragSceneColor;
 
 in vec3 TexCoords;
 uniform samplerCube skybox;
@@ -8,4 +12,7 @@ uniform samplerCube skybox;
 void main()
 {
     FragColor = texture(skybox, TexCoords);
+    FragPosition = vec4(0.0f);
+    FragNormal = vec4(0.0f);
+    FragSceneColor = FragColor;
 }
@@ -0,0 +1,50 @@
+#version 430
+
+// OUTPUT
+// ------
+
+layout (location = 0) out vec4 screenTexture;
+layout (location = 1) out vec4 textureColor;
+
+#include "lighting.glsl"
+
+// SHADER PASSED VALUES
+// --------------------
+
+in vec2 TexCoords;
+
+// UNIFORMS
+// --------
+
+// written by basic.frag with isDeferred set
+uniform sampler2D gAlbedo;
+uniform sampler2D gPosition;
+uniform sampler2D gNormal;
+// reflection, refraction
+uniform sampler2D gMaterial;
+
+// MAIN
+// ----
+
+// same shading as the forward path of basic.frag, done once per pixel
+void main()
+{
+    ivec2 pixel = ivec2(gl_FragCoord.xy);
+    vec4 albedo = texelFetch(gAlbedo, pixel, 0);
+    vec4 position = texelFetch(gPosition, pixel, 0);
+
+    // pixels without geometry, e.g. the skybox, are already final, their normal isn't read
+    if (position.w == 0.0f) {
+        screenTexture = albedo;
+        textureColor = albedo;
+        return;
+    }
+
+    vec3 N = normalize(texelFetch(gNormal, pixel, 0).xyz);
+    vec2 material = texelFetch(gMaterial, pixel, 0).rg;
+
+    vec3[2] lighting = CalculateLighting(position.xyz, N, albedo.rgb, material);
+
+    textureColor = vec4(lighting[0], 1.0f);
+    screenTexture = vec4(lighting[1], 1.0f);
+}
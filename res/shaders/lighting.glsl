@@ -0,0 +1,268 @@
+// Lighting shared by basic.frag and deferredLighting.frag, Shader pastes it where they include it
+
+// STRUCTS
+// -------
+
+// ambient and diffuse are already multiplied by light color
+struct DirectionalLight {
+    vec4 direction;
+    vec4 ambient;
+    vec4 diffuse;
+};
+
+struct PointLight {
+    // w is range
+    vec4 position;
+    // constant, linear, quadratic
+    vec4 attenuation;
+    vec4 ambient;
+    vec4 diffuse;
+};
+
+struct SpotLight {
+    // w is range
+    vec4 position;
+    // w is cutOff
+    vec4 direction;
+    // constant, linear, quadratic, outerCutOff
+    vec4 attenuation;
+    vec4 ambient;
+    vec4 diffuse;
+};
+
+struct LightCluster {
+    uint offset;
+    uint pointLightsCount;
+    uint spotLightsCount;
+    uint padding;
+};
+
+// CONSTANTS
+// ---------
+
+// same as in LightClusters.h
+#define CLUSTER_GRID_X 16
+#define CLUSTER_GRID_Y 9
+#define CLUSTER_GRID_Z 24
+// same as in ShadowManager.h
+#define MAX_CASCADES 4
+
+// UNIFORMS
+// --------
+
+uniform sampler2DArray shadowMap;
+uniform samplerCube skybox;
+
+// EXTERNALLY SET VARIABLES
+// ------------------------
+
+uniform vec3 viewPos;
+uniform mat4 view;
+uniform int cascadesCount = 0;
+// view space depth at which every cascade ends
+uniform float cascadeSplits[MAX_CASCADES];
+uniform mat4 lightSpaceMatrices[MAX_CASCADES];
+uniform int directionalLightsCount = 0;
+uniform vec2 clusterTileSize;
+uniform float clusterScale;
+uniform float clusterBias;
+
+layout(std430, binding = 1) readonly buffer DirectionalLights {
+    DirectionalLight directionalLights[];
+};
+layout(std430, binding = 2) readonly buffer PointLights {
+    PointLight pointLights[];
+};
+layout(std430, binding = 3) readonly buffer SpotLights {
+    SpotLight spotLights[];
+};
+layout(std430, binding = 4) readonly buffer LightClusters {
+    LightCluster clusters[];
+};
+layout(std430, binding = 5) readonly buffer LightIndices {
+    uint lightIndices[];
+};
+
+// LIGHT FUNCTIONS
+// ---------------
+
+vec3[2] CalculateDirectionalLight(DirectionalLight light, vec3 normal, vec3 albedo)
+{
+    vec3 lightDir = normalize(-light.direction.xyz);
+    // diffuse shading
+    float diff = max(dot(normal, lightDir), 0.0);
+    // combine results
+    vec3 ambient = light.ambient.rgb * albedo;
+    vec3 diffuse = light.diffuse.rgb * diff * albedo;
+    vec3[2] lightSettings = {ambient, diffuse};
+    return lightSettings;
+}
+
+vec3[2] CalculatePointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 albedo)
+{
+    vec3 lightDir = normalize(light.position.xyz - fragPos);
+    // diffuse shading
+    float diff = max(dot(normal, lightDir), 0.0);
+    // attenuation
+    float distance = length(light.position.xyz - fragPos);
+    float attenuation = 1.0 / (light.attenuation.x + light.attenuation.y * distance + light.attenuation.z * (distance * distance));
+    // combine results
+    vec3 ambient = light.ambient.rgb * albedo * attenuation;
+    vec3 diffuse = light.diffuse.rgb * diff * albedo * attenuation;
+    vec3[2] lightSettings = {ambient, diffuse};
+    return lightSettings;
+}
+
+vec3[2] CalculateSpotLight(SpotLight light, vec3 normal, vec3 fragPos, vec3 albedo)
+{
+    vec3 lightDir = normalize(light.position.xyz - fragPos);
+    // diffuse shading
+    float diff = max(dot(normal, lightDir), 0.0);
+    // attenuation
+    float distance = length(light.position.xyz - fragPos);
+    float attenuation = 1.0 / (light.attenuation.x + light.attenuation.y * distance + light.attenuation.z * (distance * distance));
+    // spotlight intensity
+    float theta = dot(lightDir, normalize(-light.direction.xyz));
+    float epsilon = light.direction.w - light.attenuation.w;
+    float intensity = clamp((theta - light.attenuation.w) / epsilon, 0.0, 1.0);
+    // combine results
+    vec3 ambient = light.ambient.rgb * albedo * attenuation * intensity;
+    vec3 diffuse = light.diffuse.rgb * diff * albedo * attenuation * intensity;
+    vec3[2] lightSettings = {ambient, diffuse};
+    return lightSettings;
+}
+
+uint GetClusterIndex(vec3 fragPos)
+{
+    // depth slices are exponential, so the slice is linear in log of view depth
+    float viewDepth = -(view * vec4(fragPos, 1.0f)).z;
+    int slice = int(log(max(viewDepth, 0.0001f)) * clusterScale - clusterBias);
+    ivec2 tile = ivec2(gl_FragCoord.xy / clusterTileSize);
+    ivec3 cluster = clamp(ivec3(tile, slice), ivec3(0), ivec3(CLUSTER_GRID_X - 1, CLUSTER_GRID_Y - 1, CLUSTER_GRID_Z - 1));
+    return uint(cluster.x + CLUSTER_GRID_X * (cluster.y + CLUSTER_GRID_Y * cluster.z));
+}
+
+float ShadowCalculation(vec3 fragPos)
+{
+    if (cascadesCount == 0) return 0.0;
+
+    // first cascade which reaches the fragment
+    float viewDepth = -(view * vec4(fragPos, 1.0f)).z;
+    int cascade = cascadesCount - 1;
+    for (int i = 0; i < cascadesCount; i++) {
+        if (viewDepth < cascadeSplits[i]) {
+            cascade = i;
+            break;
+        }
+    }
+    vec4 fragPosLightSpace = lightSpaceMatrices[cascade] * vec4(fragPos, 1.0f);
+
+    // perform perspective divide
+    vec3 projCoords = fragPosLightSpace.xyz / fragPosLightSpace.w;
+    // transform to [0,1] range
+    projCoords = projCoords * 0.5 + 0.5;
+    // get depth of current fragment from light's perspective
+    float currentDepth = projCoords.z;
+
+    // PCF
+    float shadow = 0.0;
+    vec2 texelSize = 1.0 / textureSize(shadowMap, 0).xy;
+    for(int x = -1; x <= 1; ++x)
+    {
+        for(int y = -1; y <= 1; ++y)
+        {
+            float pcfDepth = texture(shadowMap, vec3(projCoords.xy + vec2(x, y) * texelSize, cascade)).r;
+            shadow += currentDepth > pcfDepth  ? 1.0 : 0.0;
+        }
+    }
+    shadow /= 9.0;
+
+    // keep the shadow at 0.0 when outside the far_plane region of the light's frustum.
+    if(projCoords.z > 1.0) shadow = 0.0;
+
+    return shadow;
+}
+
+// lit color without shadows first, with them second, material is reflection and refraction
+vec3[2] CalculateLighting(vec3 fragPos, vec3 N, vec3 albedo, vec2 material)
+{
+    vec3 V = normalize(viewPos - fragPos);
+
+    vec3 result = vec3(0.0f);
+    vec3 shadowResult = vec3(0.0f);
+
+    vec3[2] lightSettings;
+
+    float shadow = ShadowCalculation(fragPos);
+
+    // phase 1: directional lights
+    for(int i = 0; i < directionalLightsCount; i++){
+        lightSettings = CalculateDirectionalLight(directionalLights[i], N, albedo);
+        result += lightSettings[0] + lightSettings[1];
+        shadowResult += lightSettings[0] + (1 - shadow) * lightSettings[1];
+    }
+
+    // only lights assigned to the fragment's cluster can reach it
+    LightCluster cluster = clusters[GetClusterIndex(fragPos)];
+    uint firstSpotLight = cluster.offset + cluster.pointLightsCount;
+
+    // phase 2: point lights
+    for(uint i = cluster.offset; i < firstSpotLight; i++){
+        lightSettings = CalculatePointLight(pointLights[lightIndices[i]], N, fragPos, albedo);
+        result += lightSettings[0] + lightSettings[1];
+        shadowResult += lightSettings[0] + (1 - shadow) * lightSettings[1];
+    }
+
+    // phase 3: spot lights
+    for(uint i = firstSpotLight; i < firstSpotLight + cluster.spotLightsCount; i++){
+        lightSettings = CalculateSpotLight(spotLights[lightIndices[i]], N, fragPos, albedo);
+        result += lightSettings[0] + lightSettings[1];
+        shadowResult += lightSettings[0] + (1 - shadow) * lightSettings[1];
+    }
+
+    // cel shading and rim light follow the first directional light
+    vec3 sunDirection = directionalLightsCount > 0 ? directionalLights[0].direction.xyz : vec3(0.0f, -1.0f, 0.0f);
+
+    //cel shading
+    float intensity = max(dot(-normalize(sunDirection), N), 0.0);
+
+    if (intensity > 0.8) {
+        intensity = 0.5;
+    }
+    else if (intensity > 0.5) {
+        intensity = 0.50;
+    }
+    else if (intensity > 0.2) {
+        intensity = 0.2;
+    }
+    else {
+        intensity = 0.0;
+    }
+
+    vec3 celColor = vec3(intensity, intensity, intensity);
+
+    result = result + result * celColor;
+    shadowResult = shadowResult + shadowResult * celColor;
+
+    //     rim light
+    float rimLight = pow(max(0, (1 - dot(normalize(-sunDirection), N))), 0.75);
+
+    result = result + result * rimLight;
+    shadowResult = shadowResult + shadowResult * rimLight;
+
+    if(material.x > 0.001) {
+        vec3 R = reflect(-V, N);
+        result = mix(result, texture(skybox, R).rgb, material.x);
+        shadowResult = mix(shadowResult, texture(skybox, R).rgb, material.x);
+    }
+    if(material.y > 0.001) {
+        // How much light bends
+        float ratio = 1.00 / 1.52;
+        vec3 R = refract(-V, N, ratio);
+        result = mix(result, texture(skybox, R).rgb, material.y);
+        shadowResult = mix(shadowResult, texture(skybox, R).rgb, material.y);
+    }
+
+    vec3[2] lighting = {result, shadowResult};
+    return lighting;
+}
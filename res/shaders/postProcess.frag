@@ -8,6 +8,8 @@ uniform sampler2D screenTexture;
 uniform sampler2D texturePosition;
 uniform sampler2D textureNormal;
 uniform sampler2D textureColor;
+// part of the textures covered by the scene, smaller than 1 with dynamic resolution
+uniform vec2 renderScale = vec2(1.0);
 
 // prewitt
 mat3 sx = mat3(
@@ -24,11 +26,13 @@ mat3 sy = mat3(
 
 void main()
 {
-    vec3 diffuse = texture(screenTexture, TexCoords.st).rgb;
+    // linear filtering mustn't reach texels outside of the drawn area
+    vec2 maxTexCoords = renderScale - 0.5 / vec2(textureSize(screenTexture, 0));
+    vec3 diffuse = texture(screenTexture, min(TexCoords.st * renderScale, maxTexCoords)).rgb;
     mat3 I;
     for (int i=0; i<3; i++) {
         for (int j=0; j<3; j++) {
-            vec3 sam  = texelFetch(textureColor, ivec2(gl_FragCoord) + ivec2(i-1,j-1), 0 ).rgb;
+            vec3 sam  = texelFetch(textureColor, ivec2(gl_FragCoord.xy * renderScale) + ivec2(i-1,j-1), 0 ).rgb;
         I[i][j] = length(sam);
         }
     }
@@ -54,10 +58,11 @@ void main()
     float far = 7.5f;
 
     vec2 texSize = textureSize(screenTexture, 0).xy + 2;
-    vec2 fragCoord = gl_FragCoord.xy;
+    vec2 fragCoord = gl_FragCoord.xy * renderScale;
     vec2 texCoord = fragCoord / texSize;
 
-    vec4 position = texture(texturePosition, texCoord);
+    // position used to be stored in RGBA8, the effect is tuned for values clamped to [0, 1]
+    vec4 position = clamp(texture(texturePosition, texCoord), 0.0, 1.0);
 
     float depth = clamp(1.0 - ((far - position.y) / (far - near)), 0.0, 1.0);
 
@@ -69,7 +74,7 @@ void main()
         for (int j = 0; j <= size; ++j) {
             texCoord = (fragCoord + (vec2(i, j) * separation)) / texSize;
 
-            vec4 positionTemp = texture(texturePosition, texCoord);
+            vec4 positionTemp = clamp(texture(texturePosition, texCoord), 0.0, 1.0);
 
             mx = max(mx, abs(position.y - positionTemp.y));
         }
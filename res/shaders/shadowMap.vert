@@ -2,37 +2,46 @@
 layout (location = 0) in vec3 aPos;
 layout(location = 1) in vec3 aNormal;
 layout(location = 2) in vec2 aTexCoords;
-layout(location = 5) in ivec4 boneIds;
+layout(location = 5) in uvec4 boneIds;
 layout(location = 6) in vec4 weights;
+layout(location = 7) in mat4 instanceModel;
+layout(location = 13) in int instanceBonesOffset;
 
 const int MAX_BONES = 15;
 const int MAX_BONE_INFLUENCE = 4;
-uniform mat4 finalBonesMatrices[MAX_BONES];
+// final bone matrices of every animated object drawn this frame
+layout(std430, binding = 0) readonly buffer BonePalette {
+    mat4 bonesMatrices[];
+};
+uniform int bonesOffset = 0;
 
 uniform bool isAnimated = false;
+uniform bool isInstanced = false;
 uniform mat4 lightSpaceMatrix;
 uniform mat4 model;
 
 void main()
 {
+    mat4 modelMatrix = isInstanced ? instanceModel : model;
+    int firstBone = isInstanced ? instanceBonesOffset : bonesOffset;
     if (isAnimated == true) {
         vec4 totalPosition = vec4(0.0f);
         for(int i = 0 ; i < MAX_BONE_INFLUENCE ; i++)
         {
-            if(boneIds[i] == -1)
+            if(weights[i] == 0.0f)
             continue;
             if(boneIds[i] >= MAX_BONES)
             {
                 totalPosition = vec4(aPos,1.0f);
                 break;
             }
-            vec4 localPosition = finalBonesMatrices[boneIds[i]] * vec4(aPos, 1.0f);
+            vec4 localPosition = bonesMatrices[firstBone + int(boneIds[i])] * vec4(aPos, 1.0f);
             totalPosition += localPosition * weights[i];
         }
 
-        gl_Position = lightSpaceMatrix * model * totalPosition;
+        gl_Position = lightSpaceMatrix * modelMatrix * totalPosition;
     }
     else {
-        gl_Position = lightSpaceMatrix * model * vec4(aPos, 1.0f);
+        gl_Position = lightSpaceMatrix * modelMatrix * vec4(aPos, 1.0f);
     }
 }
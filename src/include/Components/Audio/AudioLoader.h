@@ -6,8 +6,8 @@
 #define GLOOMENGINE_AUDIOLOADER_H
 
 #include "ProjectSettings.h"
+#include "LowLevelClasses/VirtualFileSystem.h"
 #include <vector>
-#include <fstream>
 #include <al.h>
 #include <alext.h>
 
@@ -18,8 +18,10 @@ class AudioLoader {
     ALuint source = 0;
     const ALuint *buffers = nullptr;
     // Header values of WAV file
-    std::ifstream file {};
-    long long dataStartSectionPointer = 0;
+    VirtualFile file {};
+    // samples are queued straight from the file's data
+    size_t position = 0;
+    size_t dataStartSectionPointer = 0;
     uint32_t fileSize = 0;
     uint32_t formatLength = 0;
     uint16_t formatType = 0;
@@ -31,7 +33,6 @@ class AudioLoader {
     ALsizei subChunkSize = 0;
     // Remaining amount of data to load
     ALsizei samplesSizeToLoad = 0;
-    ALfloat samples[BUFFER_SIZE] {};
 
 public:
     explicit AudioLoader();
@@ -44,6 +45,8 @@ public:
     const bool FillProcessedBuffers(const ALuint &processedBuffers);
     void CloseFile();
 
+private:
+    bool Read(void* destination, size_t size);
 };
 
 
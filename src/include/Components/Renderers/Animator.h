@@ -8,13 +8,14 @@
 #include <vector>
 
 #include "Drawable.h"
+#include "EngineManagers/AssetManager.h"
 #include "LowLevelClasses/Animation.h"
 #include "ProjectSettings.h"
 
 class Animator : public Drawable {
 private:
     glm::mat4 finalBoneMatrices[BONE_NUMBER];
-	std::shared_ptr<AnimationModel> model;
+	AssetHandle<AnimationModel> model;
 	bool isPlaying = false;
     float blendingTimeInSeconds = 0.35f;
     float blendingTimeInTicks = 0;
@@ -27,8 +28,9 @@ public:
     float currentTime;
     bool blend = true;
 
-    inline static std::unordered_map<int, std::shared_ptr<AnimationModel>> animationModels;
-    inline static std::unordered_map<int, Animation> animations;
+    // models and animations of the scene, clearing it releases them to AssetManager's cache
+    inline static std::unordered_map<int, AssetHandle<AnimationModel>> animationModels;
+    inline static std::unordered_map<int, AssetHandle<Animation>> animations;
 
 public:
     Animator(const std::shared_ptr<GameObject> &parent, int id);
@@ -43,12 +45,15 @@ public:
     void Draw() override;
 
     void Draw(std::shared_ptr<Shader> shader) override;
+    void Record(RenderCommandBuffer& buffer) override;
+    uint64_t GetSortKey(const glm::vec3& cameraPosition) override;
+    Model* GetInstancingModel() override;
 
     void UpdateAnimation(float deltaTime);
     void PlayAnimation(Animation pAnimation);
 	void PauseAnimation();
 
-    glm::mat4* GetFinalBoneMatrices();
+    glm::mat4* GetFinalBoneMatrices() override;
 
 private:
     void CalculateBoneTransform(AssimpNodeData* node, const glm::mat4& parentTransform);
@@ -14,7 +14,7 @@
 
 class CubeMap : public Drawable {
 private:
-    unsigned int textureID;
+    unsigned int textureID = 0;
     std::shared_ptr<Mesh> skyboxMesh;
 public:
     CubeMap(const std::shared_ptr<GameObject> &parent, int id);
@@ -27,6 +27,7 @@ public:
 
     void Draw() override;
     void Draw(std::shared_ptr<Shader> shader) override;
+    uint64_t GetSortKey(const glm::vec3& cameraPosition) override;
 };
 
 
@@ -9,10 +9,13 @@
 #include "glm/gtc/matrix_transform.hpp"
 
 #include <unordered_map>
+#include <cstdint>
 
 #include "Components/Component.h"
 
 class Shader;
+class Model;
+class RenderCommandBuffer;
 
 struct Material {
     glm::vec3 color;
@@ -28,6 +31,10 @@ public:
     Material material = {{1.0f, 1.0f, 1.0f},32.0f,0,0};
     glm::vec2 textScale = glm::vec2(1.0f, 1.0f);
     bool drawShadows = true;
+    // never moves after the scene is loaded, its shadow is cached by ShadowManager
+    bool isStatic = false;
+    // index of the first of this drawable's matrices in RendererManager's bone palette
+    int bonesOffset = 0;
 public:
     Drawable(const std::shared_ptr<GameObject> &parent, int id);
     ~Drawable() override;
@@ -35,6 +42,13 @@ public:
     void Update() override;
     virtual void Draw() = 0;
     virtual void Draw(std::shared_ptr<Shader> shader) = 0;
+    // called from worker threads, must only read state of the drawable
+    virtual void Record(RenderCommandBuffer& buffer);
+    virtual uint64_t GetSortKey(const glm::vec3& cameraPosition);
+    // model drawn with hardware instancing together with other drawables using it, nullptr if not instanced
+    virtual Model* GetInstancingModel();
+    // BONE_NUMBER matrices for animated drawables, nullptr otherwise
+    virtual glm::mat4* GetFinalBoneMatrices();
 
 private:
     void AddToDraw();
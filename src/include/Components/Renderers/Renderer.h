@@ -2,15 +2,17 @@
 #define OPENGLGP_RENDERER_H
 
 #include "Drawable.h"
+#include "EngineManagers/AssetManager.h"
 
 class StaticModel;
 
 class Renderer : public Drawable {
 private:
-    std::shared_ptr<StaticModel> model;
+    AssetHandle<StaticModel> model;
 
 public:
-    inline static std::unordered_map<int, std::shared_ptr<StaticModel>> models;
+    // models of the scene, clearing it releases them to AssetManager's cache
+    inline static std::unordered_map<int, AssetHandle<StaticModel>> models;
     std::string lastLoadedModelPath;
 public:
     Renderer(const std::shared_ptr<GameObject> &parent, int id);
@@ -21,6 +23,9 @@ public:
 
     void Draw() override;
     void Draw(std::shared_ptr<Shader> shader) override;
+    void Record(RenderCommandBuffer& buffer) override;
+    uint64_t GetSortKey(const glm::vec3& cameraPosition) override;
+    Model* GetInstancingModel() override;
 
     void LoadModel(std::string path);
 };
@@ -11,6 +11,8 @@ private:
     std::shared_ptr<GameObject> door;
 
 public:
+    inline static const std::string doorModel = "Buildings/Normal/drzwi.obj";
+
     std::shared_ptr<ShopMenu> shopMenu;
     std::shared_ptr<Image> buttonImage;
 
@@ -43,6 +43,8 @@ private:
     bool tutorial = false;
 
 public:
+    inline static const std::string animationModel = "Crowd/Shopkeeper/Shopkeeper.dae";
+
     std::vector<Strings> texts;
     bool menuActive = false;
 
@@ -55,6 +55,8 @@ private:
     float previousVelocity;
 
 public:
+    inline static const std::string animationModel = "MainHero/MainHeroIdle.dae";
+
     // Music session
     std::shared_ptr<MusicSession> session;
     std::shared_ptr<Menu> activeMenu;
@@ -3,8 +3,7 @@
 
 #include "Components/UI/UIComponent.h"
 #include "Components/UI/Text.h"
-#include "LowLevelClasses/Mesh.h"
-#include <map>
+#include "LowLevelClasses/SpriteAtlas.h"
 #include <ft2build.h>
 #include "glm/matrix.hpp"
 #include "glm/gtc/matrix_transform.hpp"
@@ -12,17 +11,15 @@
 
 class Button : public UIComponent{
 private:
-    unsigned int textureID;
-    unsigned int textureIsActive;
-    std::shared_ptr<Mesh> textureMesh;
-    std::shared_ptr<Mesh> textMesh;
+    Sprite sprite;
+    Sprite spriteIsActive;
     glm::vec2 leftBottom{}, leftTop{}, rightBottom{}, rightTop{};
     int width, height;
     int textX, textY;
     glm::vec3 color = glm::vec3(1);
     glm::vec3 textColor;
     FT_UInt fontSize;
-    std::map<GLchar, Character> Characters;
+    std::shared_ptr<GlyphAtlas> atlas;
     float z = 0.0f;
     glm::vec2 scale = glm::vec2(1);
 
@@ -36,7 +33,6 @@ public:
 public:
     Button(const std::shared_ptr<GameObject> &parent, int id);
 
-    std::shared_ptr<Mesh> CreateMesh(int x, int y, int width, int height);
     /**
     * x from 0 to 1920\n
     * y from 0 to 1080
@@ -61,7 +57,10 @@ public:
     void Update() override;
     void OnDestroy() override;
 
-    void Draw() override;
+    void AddQuads(SpriteBatch& batch) override;
+
+private:
+    void UpdateCorners(int newX, int newY, int newWidth, int newHeight);
 };
 
 
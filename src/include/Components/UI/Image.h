@@ -2,18 +2,18 @@
 #define GLOOMENGINE_IMAGE_H
 
 #include "Components/UI/UIComponent.h"
+#include "LowLevelClasses/SpriteAtlas.h"
 #include "glm/matrix.hpp"
 #include "glm/gtc/matrix_transform.hpp"
 #include <vector>
 #include <memory>
 
-class Mesh;
-
 class Image : public UIComponent {
 private:
-    unsigned int textureID;
-    std::shared_ptr<Mesh> mesh;
+    Sprite sprite;
     glm::vec2 leftBottom{}, leftTop{}, rightBottom{}, rightTop{};
+    // drawn corners in pixels, rotated if the image is
+    glm::vec2 corners[4]{};
     int x = 0, y = 0;
     float z = 0.0f;
     glm::vec2 scale = glm::vec2(1);
@@ -32,7 +32,6 @@ public:
 
     Image(const std::shared_ptr<GameObject> &parent, int id);
 
-    std::shared_ptr<Mesh> CreateMesh();
     /**
     * x from 0 to 1920\n
     * y from 0 to 1080
@@ -42,7 +41,7 @@ public:
     void Update() override;
     void OnDestroy() override;
 
-    void Draw() override;
+    void AddQuads(SpriteBatch& batch) override;
 
     void SetPosition(float x2, float y2) override;
     void SetRotation(float angle) override;
@@ -1,25 +1,18 @@
 #ifndef GLOOMENGINE_TEXT_H
 #define GLOOMENGINE_TEXT_H
 
-#include <map>
 #include <string>
 #include "Components/UI/UIComponent.h"
-#include "LowLevelClasses/Mesh.h"
+#include "glm/glm.hpp"
 #include <ft2build.h>
 #include FT_FREETYPE_H
 
-struct Character {
-    GLuint TextureID;   // ID handle of the glyph texture
-    glm::ivec2 Size;    // Size of glyph
-    glm::ivec2 Bearing;  // Offset from baseline to left/top of glyph
-    GLuint Advance;    // Horizontal offset to advance to next glyph
-};
+class GlyphAtlas;
 
 class Text : public UIComponent {
 private:
-    std::shared_ptr<Mesh> mesh;
-    GLfloat x, y;
-    std::map<GLchar, Character> Characters;
+    std::shared_ptr<GlyphAtlas> atlas;
+    float x, y;
 
 public:
     std::string text;
@@ -30,7 +23,6 @@ public:
 public:
     Text(const std::shared_ptr<GameObject> &parent, int id);
 
-    void CreateMesh(float x, float y);
     /**
     * x from 0 to 1920\n
     * y from 0 to 1080
@@ -41,7 +33,7 @@ public:
 
     void OnDestroy() override;
 
-    void Draw() override;
+    void AddQuads(SpriteBatch& batch) override;
 
     void SetPosition(float x2, float y2) override;
 };
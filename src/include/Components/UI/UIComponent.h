@@ -8,13 +8,17 @@
 #include "Components/Component.h"
 #include "glm/vec3.hpp"
 
+class SpriteBatch;
+
 class UIComponent : public Component{
 public:
     UIComponent(const std::shared_ptr<GameObject>& parent, int id);
     ~UIComponent() override;
 
     void Update() override;
-    virtual void Draw() = 0;
+    // draws the component right away instead of with the rest of UI, e.g. the loading screen
+    virtual void Draw();
+    virtual void AddQuads(SpriteBatch& batch) = 0;
 
     inline virtual void SetPosition(float x2, float y2){};
     inline virtual void SetRotation(float angle){};
@@ -0,0 +1,166 @@
+#ifndef GLOOMENGINE_ASSETMANAGER_H
+#define GLOOMENGINE_ASSETMANAGER_H
+
+#include "LowLevelClasses/ResourceCache.h"
+#include <memory>
+#include <string>
+#include <typeinfo>
+
+// unused models and animations stay cached for later scenes until all cached assets take more than this
+#define ASSET_MEMORY_BUDGET (256 * 1024 * 1024)
+
+template<class T>
+class AssetHandle;
+
+struct CachedAsset {
+    unsigned int id = 0;
+    std::shared_ptr<void> asset;
+    size_t memory = 0;
+    unsigned int usersCount = 0;
+    // value of releasesCount when the last user released it, the lowest one is evicted first
+    unsigned int lastRelease = 0;
+};
+
+/**
+ * @annotation
+ * Owns models and animations loaded from files, each file is loaded once and shared by all its users through handles.
+ * Assets are keyed by their type and normalized path. Assets nobody uses are kept for the next scene, so ones shared
+ * by the main menu and the game aren't loaded again, and evicted, least recently released first, over the budget.
+ */
+class AssetManager {
+private:
+    inline static AssetManager* assetManager;
+
+    ResourceCache<CachedAsset> assets{ASSET_MEMORY_BUDGET};
+    unsigned int lastId = 0;
+
+    // stats of all loads
+    unsigned int requestsCount = 0;
+    unsigned int loadedCount = 0;
+
+public:
+    AssetManager(AssetManager &other) = delete;
+    void operator=(const AssetManager&) = delete;
+    virtual ~AssetManager();
+
+    static AssetManager* GetInstance();
+
+    // @returns an empty handle if the asset isn't cached
+    template<class T>
+    AssetHandle<T> Acquire(const std::string& path);
+    // caches a loaded asset, T has to report its size with GetMemory
+    template<class T>
+    AssetHandle<T> Add(const std::string& path, const std::shared_ptr<T>& asset);
+    // acquires the asset or caches the one made by create if it isn't cached
+    template<class T, class Create>
+    AssetHandle<T> Load(const std::string& path, Create create);
+
+    // every handle adds a user, handles call these themselves
+    void AddUser(unsigned int id);
+    void Release(unsigned int id);
+    void SetMemoryBudget(size_t newMemoryBudget);
+
+    [[nodiscard]] size_t GetMemory() const;
+    [[nodiscard]] size_t GetUnusedMemory() const;
+    [[nodiscard]] size_t GetAssetsCount() const;
+    [[nodiscard]] unsigned int GetRequestsCount() const;
+    [[nodiscard]] unsigned int GetLoadedCount() const;
+    [[nodiscard]] unsigned int GetRevivedCount() const;
+
+    void Free();
+
+private:
+    explicit AssetManager();
+
+    template<class T>
+    static std::string GetKey(const std::string& path);
+    static std::string NormalizePath(const std::string& path);
+    // 0 if the key isn't cached
+    unsigned int AcquireKey(const std::string& key, std::shared_ptr<void>& asset);
+    unsigned int Insert(const std::string& key, std::shared_ptr<void> asset, size_t assetMemory);
+};
+
+/**
+ * @annotation
+ * Typed reference to a cached asset, the asset stays in use until every handle to it is reset or destroyed.
+ */
+template<class T>
+class AssetHandle {
+private:
+    std::shared_ptr<T> asset;
+    // 0 if the handle is empty
+    unsigned int id = 0;
+
+public:
+    AssetHandle() = default;
+    AssetHandle(std::shared_ptr<T> asset, unsigned int id) : asset(std::move(asset)), id(id) {}
+    AssetHandle(const AssetHandle& other) : asset(other.asset), id(other.id) {
+        if (id != 0) AssetManager::GetInstance()->AddUser(id);
+    }
+    AssetHandle(AssetHandle&& other) noexcept : asset(std::move(other.asset)), id(other.id) {
+        other.id = 0;
+    }
+    AssetHandle& operator=(const AssetHandle& other) {
+        if (this == &other) return *this;
+        if (other.id != 0) AssetManager::GetInstance()->AddUser(other.id);
+        Reset();
+        asset = other.asset;
+        id = other.id;
+        return *this;
+    }
+    AssetHandle& operator=(AssetHandle&& other) noexcept {
+        if (this == &other) return *this;
+        Reset();
+        asset = std::move(other.asset);
+        id = other.id;
+        other.id = 0;
+        return *this;
+    }
+    ~AssetHandle() {
+        Reset();
+    }
+
+    void Reset() {
+        if (id != 0) AssetManager::GetInstance()->Release(id);
+        asset.reset();
+        id = 0;
+    }
+
+    [[nodiscard]] T* Get() const { return asset.get(); }
+    [[nodiscard]] const std::shared_ptr<T>& GetShared() const { return asset; }
+    T* operator->() const { return asset.get(); }
+    T& operator*() const { return *asset; }
+    explicit operator bool() const { return asset != nullptr; }
+};
+
+template<class T>
+AssetHandle<T> AssetManager::Acquire(const std::string& path) {
+    std::shared_ptr<void> asset;
+    unsigned int id = AcquireKey(GetKey<T>(path), asset);
+    if (id == 0) return {};
+    return {std::static_pointer_cast<T>(asset), id};
+}
+
+template<class T>
+AssetHandle<T> AssetManager::Add(const std::string& path, const std::shared_ptr<T>& asset) {
+    // loaded twice, the first one stays shared
+    AssetHandle<T> cached = Acquire<T>(path);
+    if (cached) return cached;
+    return {asset, Insert(GetKey<T>(path), asset, asset->GetMemory())};
+}
+
+template<class T, class Create>
+AssetHandle<T> AssetManager::Load(const std::string& path, Create create) {
+    AssetHandle<T> handle = Acquire<T>(path);
+    if (handle) return handle;
+    std::shared_ptr<T> asset = create();
+    return {asset, Insert(GetKey<T>(path), asset, asset->GetMemory())};
+}
+
+template<class T>
+std::string AssetManager::GetKey(const std::string& path) {
+    return std::string(typeid(T).name()) + ":" + NormalizePath(path);
+}
+
+
+#endif //GLOOMENGINE_ASSETMANAGER_H
@@ -34,6 +34,8 @@ private:
 	static void ExtractVec3ToFloat3(glm::vec3 input,float* output);
 	//Conversion from float[3] to vec3 to set it in the object.
 	static glm::vec3 InjectFloat3IntoVec3(float * input);
+	//Static renderers casting shadows, the shadow cache is invalidated when they change.
+	static bool IsStaticCaster(const std::shared_ptr<GameObject>& gameObject);
 	//Function to display RAM and CPU usage.
 	void DisplaySystemInfo();
 	void SaveMenu();
@@ -0,0 +1,76 @@
+#ifndef GLOOMENGINE_FONTMANAGER_H
+#define GLOOMENGINE_FONTMANAGER_H
+
+#include <map>
+#include <set>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+class GlyphAtlas;
+
+// path relative to res/fonts and size in pixels
+typedef std::pair<std::string, unsigned int> FontKey;
+
+/**
+ * @annotation
+ * Owns glyph atlases of every font in use, each (path, size) is rasterized once and shared by all texts.
+ * Fonts listed for a scene in res/ProjectConfig/fonts.json are rasterized on worker threads
+ * while the scene loads, atlases nobody uses anymore are released after a scene change.
+ * The manifest is kept up to date by the texts themselves, fonts a scene requests are added to it and saved.
+ */
+class FontManager {
+private:
+    inline static FontManager* fontManager;
+
+    std::map<FontKey, std::shared_ptr<GlyphAtlas>> fonts;
+    // rasterized by prewarm threads, uploaded once the threads are joined
+    std::vector<std::shared_ptr<GlyphAtlas>> prewarmedFonts;
+    // milliseconds spent rasterizing every prewarmed font, each slot is written by one thread
+    std::vector<float> prewarmTimes;
+    std::vector<std::thread> prewarmThreads;
+    std::map<std::string, std::set<FontKey>> sceneFonts;
+#ifdef DEBUG
+    // scene whose texts request fonts now, until the next scene prewarms
+    std::string activeScene;
+    bool isManifestChanged = false;
+#endif
+
+    // stats of the current scene load
+    std::string loadingScene;
+    unsigned int requestsCount = 0;
+    unsigned int rasterizedCount = 0;
+    float mainThreadTime = 0.0f;
+    // spent rasterizing on prewarm threads, the main thread would spend it without them
+    float workersTime = 0.0f;
+
+public:
+    FontManager(FontManager &other) = delete;
+    void operator=(const FontManager&) = delete;
+    virtual ~FontManager();
+
+    static FontManager* GetInstance();
+
+    void LoadManifest();
+    void Prewarm(const std::string& scene);
+    std::shared_ptr<GlyphAtlas> GetFont(const std::string& path, unsigned int fontSize);
+    void FinishSceneLoad();
+
+    [[nodiscard]] size_t GetMemory() const;
+    [[nodiscard]] size_t GetFontsCount() const;
+
+    void Free();
+
+private:
+    explicit FontManager();
+
+    void WaitForPrewarm();
+#ifdef DEBUG
+    void SaveManifest();
+#endif
+    void ReleaseUnused();
+};
+
+
+#endif //GLOOMENGINE_FONTMANAGER_H
@@ -6,6 +6,7 @@
 #define GLOOMENGINE_POSTPROCESSINGMANAGER_H
 
 #include <memory>
+#include "glm/glm.hpp"
 
 class Shader;
 
@@ -24,12 +25,6 @@ private:
 
     std::shared_ptr<Shader> postProcessingShader;
     unsigned int quadVAO, quadVBO;
-    unsigned int rbo;
-
-public:
-    unsigned int framebuffer;
-    unsigned int  textureScreen, texturePosition, textureNormal, textureColor;
-    unsigned int attachments[4];
 
 public:
     PostProcessingManager(PostProcessingManager &other) = delete;
@@ -38,11 +33,11 @@ public:
 
     static PostProcessingManager* GetInstance();
 
-    void Draw();
+    void Draw(unsigned int textureScreen, unsigned int texturePosition, unsigned int textureNormal,
+              unsigned int textureColor, const glm::vec2& renderScale = glm::vec2(1.0f));
+    void DrawQuad() const;
     void Free() const;
 
-    void WindowResize();
-
 private:
     explicit PostProcessingManager();
 
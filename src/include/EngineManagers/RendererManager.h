@@ -6,12 +6,73 @@
 #include <memory>
 #include <vector>
 #include <map>
+#include <cstdint>
+#include <climits>
+#include <thread>
+
+#include "Components/Renderers/Drawable.h"
+#include "LowLevelClasses/RenderCommandBuffer.h"
+#include "ProjectSettings.h"
 
 class Shader;
-class Drawable;
+class StaticGeometryPool;
+class LightClusters;
 class PointLight;
 class DirectionalLight;
 class SpotLight;
+class Model;
+struct Texture;
+
+#define MAX_BOUND_TEXTURES 8
+// bound texture slot whose sampler uniform isn't set in the current program, no texture has this id
+#define UNKNOWN_TEXTURE UINT_MAX
+// values of DrawCommand::batch for commands drawn one by one and for commands drawn by the first command of their batch
+#define NOT_BATCHED (-1)
+#define BATCHED (-2)
+// recording isn't split into chunks smaller than this, spawning a thread costs more than recording a few drawables
+#define MIN_RECORDED_PER_THREAD 64
+
+// Order of passes inside the render queue, highest bits of the sort key
+enum class RenderPass : uint8_t {
+    Opaque = 0,
+    Skybox = 1
+};
+
+struct DrawCommand {
+    uint64_t key;
+    unsigned int index;
+    int batch;
+};
+
+// per instance vertex attributes, locations 7 - 13 of every mesh
+struct InstanceData {
+    glm::mat4 model;
+    glm::vec3 color;
+    glm::vec2 texStrech;
+    // index of the first bone matrix in the bone palette
+    int bonesOffset;
+};
+
+// consecutive draw commands sharing model and shared part of material
+struct InstanceBatch {
+    Model* model;
+    Material material;
+    bool isAnimated;
+    bool drawShadows;
+    bool isStatic;
+    // drawn by the static geometry pool
+    bool isPooled;
+    unsigned int firstInstance;
+    unsigned int instanceCount;
+};
+
+struct RenderStats {
+    unsigned int drawCalls = 0;
+    unsigned int shaderChanges = 0;
+    unsigned int materialChanges = 0;
+    unsigned int textureBinds = 0;
+    unsigned int vertexArrayBinds = 0;
+};
 
 class RendererManager {
 private:
@@ -22,6 +83,8 @@ public:
     float zNear = 0.1f;
     float zFar = 100.0f;
     glm::mat4 projection{};
+    // size of scene render targets' area drawn this frame, smaller than the window with dynamic resolution
+    glm::ivec2 renderSize{};
 
     // pair of id and ptr to light
     std::map<int, std::shared_ptr<PointLight>> pointLights;
@@ -30,9 +93,37 @@ public:
 
     unsigned int bufferIterator = 0;
     std::shared_ptr<Drawable> drawBuffer[1000];
+    // indices into drawBuffer sorted by key, valid after SortDrawBuffer
+    DrawCommand drawQueue[1000];
+
+    unsigned int batchesCount = 0;
+    unsigned int instancesCount = 0;
+    InstanceBatch instanceBatches[1000];
+    InstanceData instanceData[1000];
+    unsigned int instanceVBO;
+
+    // final bone matrices of every animated drawable in the queue, shader storage buffer at binding 0
+    unsigned int bonesCount = 0;
+    glm::mat4 bonePalette[1000 * BONE_NUMBER];
+    unsigned int bonePaletteSSBO;
+
+    // draws of the sorted queue recorded in parallel, one buffer per thread, replayed in order by every pass
+    std::vector<RenderCommandBuffer> commandBuffers;
+
+    std::shared_ptr<StaticGeometryPool> staticGeometryPool;
+    // per cluster lists of lights, shader storage buffers at bindings 1 - 5
+    std::shared_ptr<LightClusters> lightClusters;
+
+    // state changes drawables asked for and state changes actually sent to GL
+    RenderStats requestedStats;
+    RenderStats issuedStats;
 
     std::shared_ptr<Shader> shader;
     std::shared_ptr<Shader> cubeMapShader;
+    // shades the G-buffer once per pixel when deferredShading is on
+    std::shared_ptr<Shader> lightingShader;
+    // switched at runtime, GloomEngine rebuilds its frame graph when it changes
+    bool deferredShading = false;
 
 public:
     RendererManager(RendererManager &other) = delete;
@@ -46,25 +137,57 @@ public:
     void Draw();
     void DrawObjects();
     void DrawObjects(const std::shared_ptr<Shader>& drawShader);
+    void DrawDynamicObjects(const std::shared_ptr<Shader>& drawShader);
+    void DrawLighting(unsigned int albedo, unsigned int position, unsigned int normal, unsigned int material);
     void AddToDrawBuffer(const std::shared_ptr<Drawable>& DrawableComponent);
+    void SortDrawBuffer();
+
+    static uint64_t CreateSortKey(RenderPass pass, unsigned int shaderId, unsigned int materialKey,
+                                  unsigned int textureSetKey, unsigned int meshKey, float depth);
+    static unsigned int CreateMaterialKey(const Material& material, const glm::vec2& textScale, bool isAnimated);
+
+    void ResetRenderState();
+    void BindShader(const std::shared_ptr<Shader>& drawShader);
+    void ApplyMaterial(const std::shared_ptr<Shader>& drawShader, const Material& material,
+                       const glm::vec2& textScale, bool isAnimated, bool isInstanced = false);
+    void BindTextures(const std::shared_ptr<Shader>& drawShader, const std::vector<Texture>& textures);
+    void BindVertexArray(unsigned int vao);
+    void SetupInstanceAttributes() const;
 
     void UpdateProjection() const;
     void UpdateCamera() const;
 
-    void UpdateLight(int componentId);
+    void UpdateLightClusters();
     void RemoveLight(int componentId);
     void SetFov(float fov);
 private:
     explicit RendererManager();
 
-    void UpdatePointLight(int id, const std::shared_ptr<Shader>& lightShader);
-    void UpdateDirectionalLight(int id, const std::shared_ptr<Shader>& lightShader);
-    void UpdateSpotLight(int id, const std::shared_ptr<Shader>& lightShader);
-    void RemovePointLight(int id, const std::shared_ptr<Shader>& lightShader);
-    void RemoveDirectionalLight(int id, const std::shared_ptr<Shader>& lightShader);
-    void RemoveSpotLight(int id, const std::shared_ptr<Shader>& lightShader);
-
     void ClearBuffer();
+
+    void DrawQueue(const std::shared_ptr<Shader>& drawShader, bool isShadowPass, bool skipStatic = false);
+    void ExecuteCommand(const std::shared_ptr<Shader>& drawShader, const RenderCommand& command);
+    void CreateInstanceBatches();
+    void FillBonePalette();
+    void RecordCommands();
+    void RecordRange(RenderCommandBuffer& buffer, unsigned int begin, unsigned int end);
+    static bool CanShareBatch(const std::shared_ptr<Drawable>& first, const std::shared_ptr<Drawable>& other);
+
+    DrawCommand sortScratch[1000];
+
+    inline static unsigned int maxNumberOfThreads = std::thread::hardware_concurrency() / 2;
+    std::vector<std::thread> threads;
+
+    // cache of the GL state set by the last draw, reset by ResetRenderState
+    unsigned int boundShader = 0;
+    unsigned int boundVao = 0;
+    unsigned int boundTextures[MAX_BOUND_TEXTURES] = {};
+    unsigned int boundTexturesCount = 0;
+    bool isMaterialBound = false;
+    Material boundMaterial{};
+    glm::vec2 boundTextScale{};
+    bool boundIsAnimated = false;
+    bool boundIsInstanced = false;
 };
 
 
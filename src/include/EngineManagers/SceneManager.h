@@ -1,19 +1,56 @@
 #ifndef OPENGLGP_SCENEMANAGER_H
 #define OPENGLGP_SCENEMANAGER_H
 
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <future>
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 #include "nlohmann/json.hpp"
 #include "LowLevelClasses/StaticObjectData.h"
+#include "LowLevelClasses/MapCache.h"
 #include "Interfaces/SaveableStaticObject.h"
+#include "EngineManagers/AssetManager.h"
 #include <string>
+#include <vector>
+
+// milliseconds of a frame spent creating objects of a loading scene, the loading screen is drawn after them
+#define SCENE_LOAD_BUDGET 8.0f
+
+enum class SceneLoadStage {
+    None,
+    // clears the old scene and shows the loading screen
+    Start,
+    // waits for the map parsed on a worker
+    Map,
+    // creates models cooked on workers as they finish
+    Models,
+    StaticObjects,
+    Animations,
+    Game,
+    Finish
+};
+
 
+// model of the loading scene prepared on a worker
+struct PreloadedModel {
+    // relative to res/models like Renderer and Animator take it
+    std::string path;
+    bool isSkinned = false;
+    // textures of its meshes, decoded on TextureManager's workers while the model is created
+    std::vector<std::string> texturePaths;
+};
 
 class GloomEngine;
 class GameObject;
+class StaticModel;
+class AnimationModel;
 //Insert prefab classes here
 class House;
 class Image;
+class Text;
 
 class SceneManager {
 private:
@@ -30,6 +67,34 @@ public:
 
     std::unordered_map<std::string, std::shared_ptr<GameObject>> parents;
 
+private:
+    // scene loaded over several frames, see UpdateLoading
+    SceneLoadStage loadStage = SceneLoadStage::None;
+    std::shared_ptr<Text> loadingProgress;
+    std::future<std::shared_ptr<CookedMap>> loadingMap;
+    // reads files of the game's animations ahead of the main thread
+    std::future<void> readAhead;
+    // models of the map and the game imported and cooked ahead of the main thread
+    std::vector<PreloadedModel> preloadingModels;
+    std::vector<std::future<void>> preloadWorkers;
+    std::atomic<size_t> nextPreloadedModel = 0;
+    // guards preloadedModels, which the workers fill
+    std::mutex preloadMutex;
+    std::deque<PreloadedModel> preloadedModels;
+    // models stay in use until the scene is loaded, unused ones are kept by AssetManager for later spawns
+    std::vector<AssetHandle<StaticModel>> loadedModels;
+    std::vector<AssetHandle<AnimationModel>> loadedAnimationModels;
+    size_t createdModelsCount = 0;
+    std::chrono::steady_clock::time_point preloadStart;
+    // summed over the workers in microseconds, what preloading would take on one thread
+    std::atomic<int64_t> preloadWorkTime = 0;
+    std::atomic<bool> isPreloadCancelled = false;
+    std::shared_ptr<CookedMap> loadingObjects;
+    std::shared_ptr<GameObject> loadingMapObject;
+    size_t loadedObjectsCount = 0;
+    size_t loadedAnimationsCount = 0;
+    std::chrono::steady_clock::time_point loadStart;
+
 public:
     SceneManager(SceneManager &other) = delete;
     void operator=(const SceneManager&) = delete;
@@ -37,14 +102,25 @@ public:
 
     static SceneManager* GetInstance();
 
+    // creates the scene with its camera and shows the loading screen
     void InitializeScene();
+    /**
+     * "MainMenu" is loaded right away, "Scene" starts loading on the next frame and is spread over frames with
+     * the loading screen showing its progress, so it can be requested from components' updates
+     */
     void LoadScene(const std::string& scene);
+    // called by the engine instead of the scene's updates while a scene loads
+    void UpdateLoading();
+    // stops the loading scene and goes back to the main menu
+    void CancelLoading();
+    [[nodiscard]] bool IsLoading() const;
+    // from 0 to 1
+    [[nodiscard]] float GetLoadingProgress() const;
     void ClearScene();
     void Free();
 
 
     void SaveStaticObjects(const std::string &dataDirectoryPath, const std::string &dataFileName);
-    void LoadStaticObjects(const std::string &dataDirectoryPath, const std::string &dataFileName);
     std::shared_ptr<GameObject> CreatePrefabObject(const std::string name);
     std::shared_ptr<GameObject> CreatePrefabObject(const std::string name, const std::string modelPath);
 
@@ -57,12 +133,30 @@ private:
     // Conversion of List of staticObjectData objects into json to be loaded.
     void from_json(const nlohmann::json &json, std::vector<std::shared_ptr<StaticObjectData>>& mapData);
 
-    //IO function that reads map file and returns ready vector of pointers to staticObjData objects.
-    std::vector<std::shared_ptr<StaticObjectData>> LoadMap(std::string dataDirectoryPath, std::string dataFileName);
+    // reads the cooked map, the json is parsed and cooked only if it changed since the map was cooked
+    std::shared_ptr<CookedMap> LoadMap(std::string dataDirectoryPath, std::string dataFileName);
     //IO function that saves map file from list of staticObjData
     void SaveMap(std::vector<std::shared_ptr<StaticObjectData>> mapData, std::string dataDirectoryPath,
                  std::string dataFileName);
     std::map<int, std::shared_ptr<SaveableStaticObject>> FindAllStaticSaveablePrefabs();
+
+    void LoadStaticObject(const std::shared_ptr<GameObject>& map, const CookedMap& cookedMap, const CookedMapObject& object);
+    // runs steps of the loading scene until the frame's budget is spent
+    void RunLoadingSteps();
+    // returns false if the frame should end after the step, e.g. to wait for a worker
+    bool RunLoadingStep();
+    // starts workers cooking every model the scene uses, models the asset cache keeps are skipped
+    void PreloadModels();
+    void PreloadModel(PreloadedModel& model);
+    // returns false if no model was ready
+    bool CreatePreloadedModel();
+    void ReadAheadAnimations();
+    void FinishLoading();
+    // builds what depends on every model of the scene once it's loaded
+    void PrepareScene();
+    void DrawLoadingScreen();
+    // stops workers of the loading scene and forgets its progress
+    void StopLoading();
 };
 
 
@@ -2,20 +2,52 @@
 #define GLOOMENGINE_SHADOWMANAGER_H
 
 #include <memory>
+#include "glm/glm.hpp"
+
+#define MAX_CASCADES 4
+// texture unit of the cascades, above units used by mesh textures and the skybox
+#define SHADOW_MAP_UNIT 10
 
 class Shader;
 
+/**
+ * @annotation
+ * Renders shadows of the first directional light into cascades fit to the camera frustum.
+ * Static casters are kept in a cached copy of every cascade, redrawn only when the cascade
+ * snaps to a new position, dynamic casters are drawn every frame on top of that copy.
+ */
 class ShadowManager {
 private:
     inline static ShadowManager* shadowManager;
 
+    glm::mat4 lightSpaceMatrices[MAX_CASCADES] = {};
+    // view space depth at which every cascade ends
+    float cascadeSplits[MAX_CASCADES] = {};
+    // light space position of cascades in units of their snap step
+    glm::ivec3 cascadeOrigins[MAX_CASCADES] = {};
+    bool isStaticCacheValid[MAX_CASCADES] = {};
+    glm::vec3 cachedLightDirection = glm::vec3(0.0f);
+    // size of the textures, changes of shadowResolution and cascadesCount apply in CreateShadowMaps
+    unsigned int cascadeResolution = 0;
+    int allocatedCascadesCount = 0;
+
 public:
     std::shared_ptr<Shader> shadowShader;
-    unsigned int depthMapFBO;
-    unsigned int depthMap;
+    unsigned int depthMapFBO = 0;
+    // texture array with one layer per cascade, sampled by the basic shader
+    unsigned int depthMap = 0;
+    // static casters only, copied into depthMap at the beginning of every frame
+    unsigned int staticDepthMap = 0;
 
+    // every cascade gets half of this resolution
     unsigned int shadowResolution = 4096;
+    // between 1 and MAX_CASCADES
+    int cascadesCount = 3;
     float nearPlane = 1.0f, farPlane = 100.0f;
+    // 0 splits cascades uniformly, 1 logarithmically
+    float splitLambda = 0.75f;
+    // cascade moves in steps of this many texels, every step redraws its static casters
+    float snapTexels = 64.0f;
 
 public:
     ShadowManager(ShadowManager &other) = delete;
@@ -25,10 +57,16 @@ public:
     static ShadowManager* GetInstance();
 
     void PrepareShadow();
+    void CreateShadowMaps();
+    void InvalidateStaticCache();
+    [[nodiscard]] unsigned int GetCascadeResolution() const;
 
     void Free() const;
 private:
     ShadowManager();
+
+    void UpdateCascades();
+    void DrawStaticCasters(int cascade);
 };
 
 
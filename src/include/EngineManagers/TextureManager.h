@@ -0,0 +1,168 @@
+#ifndef GLOOMENGINE_TEXTUREMANAGER_H
+#define GLOOMENGINE_TEXTUREMANAGER_H
+
+#include "glad/glad.h"
+#include "LowLevelClasses/ResourceCache.h"
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// unused textures stay cached for later loads until all cached textures take more than this
+#define TEXTURE_MEMORY_BUDGET (512 * 1024 * 1024)
+// milliseconds of a frame spent uploading textures decoded on workers
+#define TEXTURE_UPLOAD_BUDGET 2.0f
+// parts of the persistently mapped pixel buffer, bigger images are uploaded straight from client memory
+#define TEXTURE_UPLOAD_SLOTS 4
+#define TEXTURE_UPLOAD_SLOT_SIZE (8 * 1024 * 1024)
+
+enum class TextureWrap {
+    Repeat,
+    // images with alpha are clamped so their transparent borders don't bleed over the opposite edge, used by UI
+    ClampWithAlpha
+};
+
+struct CachedTexture {
+    unsigned int id = 0;
+    size_t memory = 0;
+    unsigned int usersCount = 0;
+    // value of releasesCount when the last user released it, the lowest one is evicted first
+    unsigned int lastRelease = 0;
+    int width = 0, height = 0, nrChannels = 0;
+    // still holds the placeholder texel while the image is decoded
+    bool isPending = false;
+};
+
+struct TextureRequest {
+    std::string key;
+    std::string path;
+    unsigned int id = 0;
+    TextureWrap wrap = TextureWrap::Repeat;
+};
+
+struct DecodedTexture {
+    TextureRequest request;
+    // nullptr if decoding failed
+    unsigned char* data = nullptr;
+    int width = 0, height = 0, nrChannels = 0;
+};
+
+struct TextureUploadSlot {
+    // signaled once the GPU has read the slot
+    GLsync fence = nullptr;
+};
+
+/**
+ * @annotation
+ * Owns every texture loaded from a file, each file is decoded and uploaded once and shared by all its users.
+ * Textures are keyed by normalized path, so "res/models/../textures/a.png" and "res/textures/a.png" are the same.
+ * Textures nobody uses are kept for the next scene and evicted, least recently released first, over the budget.
+ * Asynchronous loads are decoded on worker threads and uploaded through a pixel buffer ring in Update.
+ * Images with a block compressed variant made by tools/TextureCompressor in res/compressed skip decoding entirely.
+ */
+class TextureManager {
+private:
+    inline static TextureManager* textureManager;
+
+    ResourceCache<CachedTexture> textures{TEXTURE_MEMORY_BUDGET, [this](CachedTexture& texture) {
+        // a pending texture is dropped when its decode finishes
+        if (texture.isPending) --pendingCount;
+        glDeleteTextures(1, &texture.id);
+    }};
+
+    // guards requests, decodedTextures and decodingCount, which are shared with the workers
+    std::mutex decodeMutex;
+    std::condition_variable requestsCondition;
+    std::condition_variable decodedCondition;
+    std::deque<TextureRequest> requests;
+    std::deque<DecodedTexture> decodedTextures;
+    unsigned int decodingCount = 0;
+    bool isStopping = false;
+    std::vector<std::thread> workers;
+
+    unsigned int uploadBuffer = 0;
+    unsigned char* uploadMemory = nullptr;
+    TextureUploadSlot uploadSlots[TEXTURE_UPLOAD_SLOTS];
+    unsigned int nextUploadSlot = 0;
+
+    // stats of all loads
+    unsigned int requestsCount = 0;
+    unsigned int decodedCount = 0;
+    unsigned int compressedCount = 0;
+    unsigned int pendingCount = 0;
+
+public:
+    TextureManager(TextureManager &other) = delete;
+    void operator=(const TextureManager&) = delete;
+    virtual ~TextureManager();
+
+    static TextureManager* GetInstance();
+
+    /**
+     * @param path - path relative to the working directory, e.g. "res/textures/UI/vignetteBackground.png"
+     * @returns texture id, 0 if the file couldn't be loaded
+     */
+    unsigned int LoadTexture(const std::string& path, TextureWrap wrap = TextureWrap::Repeat);
+    /**
+     * Returns right away with a texture holding one placeholder texel, the image replaces it once decoded and uploaded
+     * @param width, height, nrChannels - filled from the file's header
+     * @returns texture id, 0 if the file couldn't be read
+     */
+    unsigned int LoadTextureAsync(const std::string& path, TextureWrap wrap, int& width, int& height, int& nrChannels);
+    // adds a user to the texture if it's cached, 0 otherwise
+    unsigned int Acquire(const std::string& path, TextureWrap wrap = TextureWrap::Repeat);
+    // uploads an image the caller already decoded, e.g. to inspect its pixels, and caches it for one user
+    unsigned int AddTexture(const std::string& path, TextureWrap wrap, const unsigned char* data,
+                            int width, int height, int nrChannels);
+    /**
+     * @param basePath - path and base name of the faces, faces are basePath0.jpg to basePath5.jpg
+     * @returns texture id, 0 if any face couldn't be loaded
+     */
+    unsigned int LoadCubeMap(const std::string& basePath);
+    // every successful load has to be paired with a release
+    void Release(unsigned int id);
+    void SetMemoryBudget(size_t newMemoryBudget);
+
+    // uploads decoded textures until the frame's budget is spent
+    void Update();
+    // waits for every asynchronous load, e.g. before the loading screen is drawn or when a scene finishes loading
+    void FinishUploads();
+
+    [[nodiscard]] size_t GetMemory() const;
+    [[nodiscard]] size_t GetUnusedMemory() const;
+    [[nodiscard]] size_t GetTexturesCount() const;
+    [[nodiscard]] unsigned int GetRequestsCount() const;
+    [[nodiscard]] unsigned int GetDecodedCount() const;
+    [[nodiscard]] unsigned int GetCompressedCount() const;
+    [[nodiscard]] unsigned int GetPendingCount() const;
+
+    // decodes an image read through VirtualFileSystem, free the pixels with stbi_image_free
+    static unsigned char* LoadImage(const std::string& path, int& width, int& height, int& nrChannels,
+                                    int desiredChannels);
+    // reads only the image's header
+    static bool GetImageInfo(const std::string& path, int& width, int& height, int& nrChannels);
+    static std::string NormalizePath(const std::string& path);
+    // e.g. "res/textures/UI/a.png" -> "res/compressed/textures/UI/a.dds"
+    static std::string GetCompressedPath(const std::string& path);
+
+    void Free();
+
+private:
+    explicit TextureManager();
+
+    static std::string GetKey(const std::string& path, TextureWrap wrap);
+    unsigned int AcquireKey(const std::string& key);
+    // uploads every mip level of the compressed variant, 0 if there is no usable one
+    unsigned int LoadCompressed(const std::string& path, TextureWrap wrap);
+
+    void StartWorkers();
+    void DecodeRequests();
+    // returns false if the ring slot is still read by the GPU and the upload has to wait,
+    // with canWait it skips the ring instead, so it always finishes
+    bool Upload(DecodedTexture& decoded, bool canWait);
+};
+
+
+#endif //GLOOMENGINE_TEXTUREMANAGER_H
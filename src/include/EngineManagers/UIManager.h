@@ -6,6 +6,8 @@
 
 class Shader;
 class UIComponent;
+class SpriteBatch;
+class SpriteAtlas;
 
 class UIManager {
 private:
@@ -16,6 +18,8 @@ private:
 
 public:
     std::shared_ptr<Shader> shader;
+    std::shared_ptr<SpriteBatch> spriteBatch;
+    std::shared_ptr<SpriteAtlas> spriteAtlas;
 
 public:
     UIManager(UIManager &other) = delete;
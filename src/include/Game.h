@@ -2,6 +2,8 @@
 #define OPENGLGP_GAME_H
 
 #include <memory>
+#include <string>
+#include <vector>
 
 class GloomEngine;
 class GameObject;
@@ -19,6 +21,12 @@ public:
 
     /// Should be used to load main menu scene
     void InitializeGame() const;
+    /// Animations used by the game, the scene manager loads them one by one before InitializeGame
+    static const std::vector<std::string>& GetAnimations();
+    /// Models the game and its prefabs load, taken from the paths they keep, preloaded on workers with the map's models
+    static const std::vector<std::string>& GetModels();
+    /// Animation models of the game's characters, including every crowd model the crowd and spawners can pick
+    static const std::vector<std::string>& GetAnimationModels();
     bool GameLoop();
 };
 
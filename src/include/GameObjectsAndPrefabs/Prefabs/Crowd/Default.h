@@ -10,6 +10,17 @@
 namespace Crowd {
 
     class Default : public Prefab {
+    public:
+        // one is picked for every character, spawned characters pick from them too
+        inline static const std::vector<std::string> animationModels = {
+                "Crowd/BasicMan001/BasicMan001.dae",
+                "Crowd/BasicMan002/BasicMan002.dae",
+                "Crowd/BasicMan003/BasicMan003.dae",
+                "Crowd/BasicMan004/BasicMan004.dae",
+                "Crowd/BasicMan005/BasicMan005.dae",
+                "Crowd/BasicMan006/BasicMan006.dae"
+        };
+
     public:
         Default(const std::string &name, int id, const std::shared_ptr<GameObject> &parent, Tags tag);
         ~Default() override;
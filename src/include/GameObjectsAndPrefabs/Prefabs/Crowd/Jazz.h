@@ -10,6 +10,16 @@
 namespace Crowd {
 
     class Jazz : public Prefab {
+    public:
+        // one is picked for every character, spawned jazz characters pick from them too
+        inline static const std::vector<std::string> animationModels = {
+                "Crowd/JazzMan001/JazzMan001.dae",
+                "Crowd/JazzMan002/JazzMan002.dae",
+                "Crowd/JazzMan003/JazzMan003.dae",
+                "Crowd/JazzMan004/JazzMan004.dae",
+                "Crowd/JazzMan005/JazzMan005.dae"
+        };
+
     public:
         Jazz(const std::string &name, int id, const std::shared_ptr<GameObject> &parent, Tags tag);
         ~Jazz() override;
@@ -4,6 +4,9 @@
 #include "GameObjectsAndPrefabs/Prefab.h"
 
 class Die : public Prefab {
+public:
+    inline static const std::string model = "Cube/Cube.obj";
+
 public:
     Die(const std::string &name, int id, const std::shared_ptr<GameObject>& parent, Tags tag);
     ~Die() override;
@@ -5,6 +5,10 @@
 #include "Interfaces/SaveableStaticObject.h"
 
 class House : public Prefab,public SaveableStaticObject {
+public:
+    // loaded by Create, houses of the map replace it with their own one
+    inline static const std::string model = "Buildings/Normal/NormalGreen.obj";
+
 public:
     House(const std::string &name, uint32_t id, const std::shared_ptr<GameObject>& parent, Tags tag);
     ~House() override;
@@ -8,6 +8,9 @@
 #include "GameObjectsAndPrefabs/Prefab.h"
 
 class Indicator : public Prefab{
+public:
+    inline static const std::string model = "Indicator/Indicator.obj";
+
 public:
     Indicator(const std::string &name, int id, const std::shared_ptr<GameObject> &parent, Tags tag);
     ~Indicator() override;
@@ -5,6 +5,10 @@
 #include "Interfaces/SaveableStaticObject.h"
 
 class SavePoint : public Prefab,public SaveableStaticObject {
+public:
+    inline static const std::string columnModel = "Buildings/Environment/PostersColumn.obj";
+    inline static const std::string diskModel = "Buildings/Environment/floppyDisk.obj";
+
 public:
     SavePoint(const std::string &name, int id, const std::shared_ptr<GameObject>& parent, Tags tag);
     ~SavePoint() override;
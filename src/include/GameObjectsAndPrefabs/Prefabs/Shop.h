@@ -6,6 +6,9 @@
 #include <memory>
 
 class Shop : public Prefab,public SaveableStaticObject {
+public:
+    inline static const std::string model = "Buildings/Normal/MAINSHOP.obj";
+
 public:
     Shop(const std::string &name, int id, const std::shared_ptr<GameObject>& parent, Tags tag);
     ~Shop() override;
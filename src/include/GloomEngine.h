@@ -40,6 +40,8 @@ class CollisionManager;
 class HIDManager;
 class SceneManager;
 class DataPersistanceManager;
+class FrameGraph;
+class DynamicResolution;
 
 class Game;
 class GameObject;
@@ -52,6 +54,7 @@ private:
     friend class DataPersistanceManager;
     friend class GameObject;
     friend class Transform;
+    friend class ShadowManager;
 
     /// Do not touch this variable
     inline static GloomEngine* gloomEngine;
@@ -71,6 +74,10 @@ public:
     std::shared_ptr<Component> destroyComponentBuffer[2000];
 
     std::shared_ptr<Game> game;
+    std::shared_ptr<FrameGraph> frameGraph;
+    std::shared_ptr<DynamicResolution> dynamicResolution;
+    // shading path the frame graph was built for
+    bool isFrameGraphDeferred = false;
     /// set to 0 to pause, 1 to resume
     float timeScale = 1;
 
@@ -115,6 +122,8 @@ public:
     void FixedUpdate();
     /// Updates components with 2Hz rate
     void AIUpdate();
+    /// Destroys components and game objects buffered for destruction
+    void DestroyBufferedObjects();
     /// Free memory
     void Free() const;
 
@@ -133,6 +142,7 @@ public:
 private:
     GloomEngine();
     void InitializeWindow();
+    void BuildFrameGraph();
     static void glfwErrorCallback(int error, const char* description);
 };
 
@@ -10,6 +10,7 @@
 #include <unordered_map>
 
 class Bone;
+class AnimationClip;
 
 struct AssimpNodeData
 {
@@ -28,6 +29,8 @@ public:
     AssimpNodeData rootNode;
     int nodeCounter = 0;
     std::unordered_map<std::string, BoneInfo> boneInfoMap;
+    // cooked keys the bones decode from
+    std::shared_ptr<const AnimationClip> clip;
 
 public:
     Animation();
@@ -41,10 +44,17 @@ public:
     [[nodiscard]] float GetDuration() const;
     AssimpNodeData& GetRootNode();
     const std::unordered_map<std::string, BoneInfo>& GetBoneIDMap();
+    // the cooked clip, bones only point into it
+    [[nodiscard]] size_t GetMemory() const;
 
-    void ReadMissingBones(const aiAnimation* animation, const std::shared_ptr<AnimationModel>& model);
-    void ReadHierarchyData(AssimpNodeData& dest, const aiNode* src);
+    // bones drive the model's bones of the same name, bones the model doesn't have get new ids
+    void ReadMissingBones(const std::shared_ptr<const AnimationClip>& clip, const std::shared_ptr<AnimationModel>& model);
+    // @returns index of the node after the subtree
+    uint32_t ReadHierarchyData(AssimpNodeData& dest, const AnimationClip& clip, uint32_t index);
     void Recalculate(const std::shared_ptr<AnimationModel>& model);
+
+    // e.g. "Armature_002_Walko_Brzuch" -> "Brzuch", the same names are given to bones by AnimationModel
+    static std::string GetBoneName(std::string nodeName);
 };
 
 
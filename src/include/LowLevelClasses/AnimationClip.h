@@ -0,0 +1,145 @@
+#ifndef GLOOMENGINE_ANIMATIONCLIP_H
+#define GLOOMENGINE_ANIMATIONCLIP_H
+
+#include "LowLevelClasses/CookedSource.h"
+#include "LowLevelClasses/MappedFile.h"
+#include "assimp/scene.h"
+#include "glm/glm.hpp"
+#include "glm/gtc/quaternion.hpp"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// layout of cooked animations in res/cooked, written on the first import of a clip and mapped by every later load
+#define ANIMATION_CLIP_MAGIC 0x4D4E4147
+// bump whenever the key reduction, quantization or the layout below change, older files are cooked again
+#define ANIMATION_CLIP_VERSION 1
+// keys reproduced by interpolating their kept neighbours within these errors are dropped while cooking
+#define ANIMATION_POSITION_TOLERANCE 0.0001f
+// in radians
+#define ANIMATION_ROTATION_TOLERANCE 0.001f
+
+struct CookedClipHeader {
+    uint32_t magic;
+    uint32_t version;
+    CookedStamp stamp;
+    // in ticks
+    float duration;
+    int32_t ticksPerSecond;
+    uint32_t nodesCount;
+    uint32_t tracksCount;
+    // what the clip took when imported with Assimp, kept to report the cooked one against
+    uint32_t sourceKeysMemory;
+    float sourceImportTime;
+    // offsets from the start of the file
+    uint64_t nodesOffset;
+    uint64_t tracksOffset;
+    uint64_t stringsOffset;
+    uint64_t stringsSize;
+};
+
+// node of the hierarchy, nodes are stored depth first with children right after their parent
+struct CookedNode {
+    CookedString name;
+    uint32_t childrenCount;
+    uint32_t padding;
+    // column major like glm
+    float transformation[16];
+};
+
+/**
+ * Keys of one bone. Times are uint16 over the clip's duration, positions are uint16 per axis over the track's bounds
+ * and rotations are smallest three quaternions: three uint16 holding 15 bit components, the top bits of the first two
+ * hold the index of the dropped largest component.
+ */
+struct CookedTrack {
+    CookedString name;
+    uint32_t positionsCount;
+    uint32_t rotationsCount;
+    uint64_t positionTimesOffset;
+    uint64_t positionsOffset;
+    uint64_t rotationTimesOffset;
+    uint64_t rotationsOffset;
+    // position = minPosition + quantized * positionScale
+    float minPosition[3];
+    float positionScale[3];
+};
+
+/**
+ * @annotation
+ * Cooked animation clip, bones decode their keys straight from it.
+ * It's mapped from res/cooked or, if the cooked file couldn't be written, kept in memory.
+ */
+class AnimationClip {
+    friend class AnimationClipCooker;
+
+private:
+    MappedFile file;
+    std::vector<unsigned char> content;
+    const unsigned char* data = nullptr;
+    size_t size = 0;
+    const CookedClipHeader* header = nullptr;
+
+public:
+    // @returns nullptr if there is no cooked file or it was cooked from a different source
+    static std::shared_ptr<AnimationClip> Load(const std::string& path);
+    // @returns nullptr if the content isn't a valid clip
+    static std::shared_ptr<AnimationClip> Create(std::vector<unsigned char> content);
+
+    [[nodiscard]] const CookedClipHeader& GetHeader() const;
+    [[nodiscard]] const CookedNode& GetNode(uint32_t index) const;
+    [[nodiscard]] const CookedTrack& GetTrack(uint32_t index) const;
+    [[nodiscard]] std::string_view GetString(const CookedString& string) const;
+    [[nodiscard]] size_t GetSize() const;
+
+    [[nodiscard]] float GetPositionTime(const CookedTrack& track, uint32_t index) const;
+    [[nodiscard]] float GetRotationTime(const CookedTrack& track, uint32_t index) const;
+    [[nodiscard]] glm::vec3 GetPosition(const CookedTrack& track, uint32_t index) const;
+    [[nodiscard]] glm::quat GetRotation(const CookedTrack& track, uint32_t index) const;
+    // index of the key interpolated from at given time, -1 past the second to last key
+    [[nodiscard]] int FindPositionIndex(const CookedTrack& track, float time) const;
+    [[nodiscard]] int FindRotationIndex(const CookedTrack& track, float time) const;
+
+    // e.g. "res/models/MainHero/MainHeroRun.dae" -> "res/cooked/models/MainHero/MainHeroRun.anim"
+    static std::string GetCookedPath(const std::string& path);
+
+private:
+    bool SetContent(const unsigned char* newData, size_t newSize);
+    [[nodiscard]] int FindIndex(const uint16_t* times, uint32_t count, float time) const;
+};
+
+/**
+ * @annotation
+ * Turns an animation imported with Assimp into a cooked clip: drops keys interpolation restores, quantizes the rest
+ * and writes the clip into res/cooked.
+ */
+class AnimationClipCooker {
+private:
+    std::vector<CookedNode> nodes;
+    std::vector<CookedTrack> tracks;
+    std::string strings;
+    // key blobs, offsets are relative to its start until the clip is built
+    std::vector<unsigned char> keys;
+    uint32_t sourceKeysMemory = 0;
+
+public:
+    // names of nodes and tracks are shortened to the bone names models use
+    void AddHierarchy(const aiNode* node);
+    void AddTrack(const aiNodeAnim* channel, float clipDuration);
+
+    /**
+     * Writes the clip next to other cooked files and maps it, it's kept in memory if it couldn't be written
+     * @param importTime - milliseconds the Assimp import took
+     */
+    std::shared_ptr<AnimationClip> Cook(const std::string& path, float clipDuration, int ticksPerSecond, float importTime);
+
+private:
+    void AddNode(const aiNode* node);
+    CookedString AddString(const std::string& string);
+    uint64_t AddKeys(const void* source, size_t keysSize);
+};
+
+
+#endif //GLOOMENGINE_ANIMATIONCLIP_H
@@ -1,5 +1,5 @@
-#ifndef OPENGLGP_MODEL_H
-#define OPENGLGP_MODEL_H
+#ifndef GLOOMENGINE_ANIMATIONMODEL_H
+#define GLOOMENGINE_ANIMATIONMODEL_H
 
 #include "Model.h"
 #include "Mesh.h"
@@ -25,15 +25,22 @@ private:
 
 public:
     AnimationModel(const std::string &path, std::shared_ptr<Shader> &shader, int type = GL_TRIANGLES, bool gamma = false);
-    AnimationModel(const Mesh &mesh, std::shared_ptr<Shader> &shader, int type = GL_TRIANGLES);
+    AnimationModel(Mesh &&mesh, std::shared_ptr<Shader> &shader, int type = GL_TRIANGLES);
 
     void LoadModel(std::string const &path) override;
+    // imports the model without touching GL and writes its cooked file, so workers can prepare it ahead of its load
+    // @returns false if the model couldn't be imported
+    static bool Cook(const std::string &path);
 
     // Getters
     std::unordered_map<std::string, BoneInfo>& GetBoneInfoMap();
     uint16_t GetBoneCount();
 
 protected:
+    // a model only used to cook, see Cook
+    explicit AnimationModel(std::shared_ptr<Shader> &shader);
+    // imports the model with Assimp and cooks it, meshes are created too unless isCookingOnly is set
+    bool Import(const std::string &path);
     static void SetVertexBoneDataToDefault(Vertex& vertex);
     void ProcessNode(aiNode *node, const aiScene *scene) override;
     void ProcessMesh(aiMesh *mesh, const aiScene *scene) override;
@@ -42,4 +49,4 @@ protected:
 };
 
 
-#endif //OPENGLGP_MODEL_H
+#endif //GLOOMENGINE_ANIMATIONMODEL_H
@@ -0,0 +1,38 @@
+#ifndef GLOOMENGINE_ASSIMPFILESYSTEM_H
+#define GLOOMENGINE_ASSIMPFILESYSTEM_H
+
+#include "LowLevelClasses/VirtualFileSystem.h"
+#include "assimp/IOStream.hpp"
+#include "assimp/IOSystem.hpp"
+
+class AssimpFileStream : public Assimp::IOStream {
+private:
+    VirtualFile file;
+    size_t position = 0;
+
+public:
+    explicit AssimpFileStream(VirtualFile&& file);
+
+    size_t Read(void* buffer, size_t size, size_t count) override;
+    size_t Write(const void* buffer, size_t size, size_t count) override;
+    aiReturn Seek(size_t offset, aiOrigin origin) override;
+    [[nodiscard]] size_t Tell() const override;
+    [[nodiscard]] size_t FileSize() const override;
+    void Flush() override;
+};
+
+/**
+ * @annotation
+ * Lets Assimp read models and the files they reference, e.g. .mtl libraries, through VirtualFileSystem.
+ * @attention Importer takes ownership of it, pass a new one to Importer::SetIOHandler
+ */
+class AssimpFileSystem : public Assimp::IOSystem {
+public:
+    bool Exists(const char* path) const override;
+    [[nodiscard]] char getOsSeparator() const override;
+    Assimp::IOStream* Open(const char* path, const char* mode) override;
+    void Close(Assimp::IOStream* file) override;
+};
+
+
+#endif //GLOOMENGINE_ASSIMPFILESYSTEM_H
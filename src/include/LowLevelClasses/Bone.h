@@ -7,36 +7,24 @@
 
 #include "Other/GLMHelper.h"
 #include "LowLevelClasses/Animation.h"
+#include "LowLevelClasses/AnimationClip.h"
 
 #include <glm/gtx/quaternion.hpp>
 #include <vector>
 
-struct KeyPosition
-{
-    glm::vec3 position;
-    float timeStamp;
-};
-
-struct KeyRotation
-{
-    glm::quat orientation;
-    float timeStamp;
-};
-
 class Bone
 {
 private:
-    KeyPosition* positions;
-    KeyRotation* rotations;
-    unsigned int numPositions;
-    unsigned int numRotations;
+    // keys are decoded from the cooked clip when they are needed
+    std::shared_ptr<const AnimationClip> clip;
+    const CookedTrack* track;
 
     glm::mat4 localTransform;
     std::string name;
     int ID;
 
 public:
-    Bone(std::string  name, int ID, const aiNodeAnim* channel);
+    Bone(std::string  name, int ID, std::shared_ptr<const AnimationClip> clip, const CookedTrack* track);
 
     virtual ~Bone();
 
@@ -53,7 +41,9 @@ public:
 
 
 private:
-    float GetScaleFactor(float lastTimeStamp, float nextTimeStamp, float animationTime);
+    static float GetScaleFactor(float lastTimeStamp, float nextTimeStamp, float animationTime);
+    [[nodiscard]] glm::vec3 GetPosition(int index) const;
+    [[nodiscard]] glm::quat GetRotation(int index) const;
 
     glm::vec3 InterpolatePosition(float animationTime, float previousAnimationTime, float blendingTime, Animation& previousAnimation);
     glm::mat4 InterpolateRotation(float animationTime, float previousAnimationTime, float blendingTime, Animation& previousAnimation);
@@ -0,0 +1,55 @@
+#ifndef GLOOMENGINE_COOKEDSOURCE_H
+#define GLOOMENGINE_COOKEDSOURCE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// identifies the source a file in res/cooked was made from
+struct CookedStamp {
+    // summed over the source and its material file
+    uint64_t sourceSize;
+    // newest write time of them
+    int64_t sourceTime;
+    // FNV-1a over their content
+    uint64_t sourceHash;
+};
+
+struct CookedString {
+    // from the start of the file's strings block
+    uint32_t offset;
+    uint32_t length;
+};
+
+enum class CookedState {
+    // same size and write time
+    Current,
+    // saved again with the same content, e.g. by a checkout, only the stamp is outdated
+    Touched,
+    Changed
+};
+
+/**
+ * @annotation
+ * Shared by every cooked format: paths in res/cooked, stamps of sources and writes that never leave half a file behind.
+ */
+class CookedSource {
+public:
+    // e.g. ("res/models/Buildings/Environment/Lamp.obj", ".mesh") -> "res/cooked/models/Buildings/Environment/Lamp.mesh"
+    static std::string GetCookedPath(const std::string& path, const std::string& extension);
+    static bool GetStamp(const std::string& path, CookedStamp& stamp);
+    // the content is only hashed when size or write time differ, current gets the stamp of the source as it is now
+    static CookedState Compare(const std::string& path, const CookedStamp& cooked, CookedStamp& current);
+    // overwrites a stamp stored at given offset, the file can't be mapped meanwhile
+    static void WriteStamp(const std::string& cookedPath, uint64_t offset, const CookedStamp& stamp);
+    // writes into a temporary file first and renames it, models may be cooked by several threads at once
+    static bool Write(const std::string& cookedPath, const std::vector<unsigned char>& content);
+
+    // loaders check every range before reading it, so a truncated or foreign file is cooked again instead of read
+    // out of bounds, sums of offsets and sizes could overflow so they are never computed
+    static bool IsInside(uint64_t offset, uint64_t rangeSize, uint64_t size);
+    static bool IsInside(const CookedString& string, uint64_t stringsSize);
+};
+
+
+#endif //GLOOMENGINE_COOKEDSOURCE_H
@@ -0,0 +1,65 @@
+#ifndef GLOOMENGINE_DDS_H
+#define GLOOMENGINE_DDS_H
+
+#include <cstdint>
+
+// layout of .dds files written by tools/TextureCompressor and read by TextureManager, shared by both
+#define DDS_MAGIC 0x20534444
+#define DDS_FOURCC(a, b, c, d) ((uint32_t)(a) | ((uint32_t)(b) << 8) | ((uint32_t)(c) << 16) | ((uint32_t)(d) << 24))
+
+// opaque RGB
+#define DDS_BC1 DDS_FOURCC('D', 'X', 'T', '1')
+// RGBA
+#define DDS_BC3 DDS_FOURCC('D', 'X', 'T', '5')
+// single channel, sampled as red
+#define DDS_BC4 DDS_FOURCC('A', 'T', 'I', '1')
+// two channels, sampled as red and green
+#define DDS_BC5 DDS_FOURCC('A', 'T', 'I', '2')
+
+#define DDSD_CAPS 0x1
+#define DDSD_HEIGHT 0x2
+#define DDSD_WIDTH 0x4
+#define DDSD_PIXELFORMAT 0x1000
+#define DDSD_MIPMAPCOUNT 0x20000
+#define DDSD_LINEARSIZE 0x80000
+#define DDPF_FOURCC 0x4
+#define DDSCAPS_COMPLEX 0x8
+#define DDSCAPS_TEXTURE 0x1000
+#define DDSCAPS_MIPMAP 0x400000
+
+struct DDSPixelFormat {
+    uint32_t size;
+    uint32_t flags;
+    uint32_t fourCC;
+    uint32_t rgbBitCount;
+    uint32_t rBitMask, gBitMask, bBitMask, aBitMask;
+};
+
+// follows the magic number, mip levels follow it from the biggest one, each stored as rows of 4x4 blocks
+struct DDSHeader {
+    uint32_t size;
+    uint32_t flags;
+    uint32_t height;
+    uint32_t width;
+    // bytes of the top mip level with DDSD_LINEARSIZE
+    uint32_t pitchOrLinearSize;
+    uint32_t depth;
+    uint32_t mipMapCount;
+    uint32_t reserved1[11];
+    DDSPixelFormat pixelFormat;
+    uint32_t caps, caps2, caps3, caps4;
+    uint32_t reserved2;
+};
+
+static_assert(sizeof(DDSHeader) == 124, "DDS header has to match the file layout");
+
+// bytes of one 4x4 block
+inline uint32_t GetDDSBlockSize(uint32_t fourCC) {
+    return fourCC == DDS_BC1 || fourCC == DDS_BC4 ? 8 : 16;
+}
+
+inline uint32_t GetDDSLevelSize(uint32_t fourCC, uint32_t width, uint32_t height) {
+    return ((width + 3) / 4) * ((height + 3) / 4) * GetDDSBlockSize(fourCC);
+}
+
+#endif //GLOOMENGINE_DDS_H
@@ -0,0 +1,58 @@
+#ifndef GLOOMENGINE_DYNAMICRESOLUTION_H
+#define GLOOMENGINE_DYNAMICRESOLUTION_H
+
+// timer queries in flight, results are read a few frames later so the CPU never waits for the GPU
+#define RESOLUTION_TIMER_QUERIES 4
+// frames averaged before the scale may change
+#define RESOLUTION_SAMPLES 30
+
+/**
+ * @annotation
+ * Picks the scale of scene render targets from GPU time of recent frames.
+ * Scale goes down when frames take longer than upperThreshold of the budget and up when they take less
+ * than lowerThreshold, the gap between thresholds is wider than the cost of one step up,
+ * so a step up never pushes the frame time straight back over the upper threshold.
+ */
+class DynamicResolution {
+private:
+    unsigned int queries[RESOLUTION_TIMER_QUERIES] = {};
+    unsigned int firstPendingQuery = 0;
+    unsigned int pendingQueriesCount = 0;
+    // frames in flight when the scale changed, measured at the old scale
+    unsigned int queriesToSkip = 0;
+    bool isTiming = false;
+
+    float frameTimes[RESOLUTION_SAMPLES] = {};
+    unsigned int frameTimesCount = 0;
+    float lastAverageFrameTime = 0.0f;
+
+public:
+    bool enabled = true;
+    float scale = 1.0f;
+    float minScale = 0.5f;
+    float maxScale = 1.0f;
+    // budget of GPU time per frame in milliseconds
+    float frameBudget = 1000.0f / 60.0f;
+    float upperThreshold = 0.95f;
+    float lowerThreshold = 0.75f;
+    float stepDown = 0.1f;
+    float stepUp = 0.05f;
+
+public:
+    DynamicResolution();
+    virtual ~DynamicResolution();
+
+    void BeginFrame();
+    void EndFrame();
+    float Update();
+
+    [[nodiscard]] float GetAverageFrameTime() const;
+
+    void Free();
+
+private:
+    void ReadFinishedQueries();
+};
+
+
+#endif //GLOOMENGINE_DYNAMICRESOLUTION_H
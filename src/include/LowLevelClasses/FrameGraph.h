@@ -0,0 +1,119 @@
+#ifndef GLOOMENGINE_FRAMEGRAPH_H
+#define GLOOMENGINE_FRAMEGRAPH_H
+
+#include "glad/glad.h"
+#include <string>
+#include <vector>
+#include <functional>
+
+// size and format of a texture created by the graph, scale is relative to the screen size
+struct FrameGraphTextureDesc {
+    unsigned int internalFormat;
+    float scale = 1.0f;
+    unsigned int filter = GL_NEAREST;
+    // passes draw only the part of the texture given by the graph's render scale, the texture isn't reallocated
+    bool isScaled = false;
+};
+
+struct FrameGraphResource {
+    std::string name;
+    FrameGraphTextureDesc desc;
+    // imported resources are owned and bound outside of the graph, e.g. the default framebuffer or the shadow map,
+    // they only order passes and keep passes writing them from being culled
+    bool isImported = false;
+    unsigned int texture = 0;
+
+    // filled by Compile
+    int readersCount = 0;
+    int firstUse = -1;
+    int lastUse = -1;
+};
+
+class FrameGraphPass {
+private:
+    friend class FrameGraph;
+
+    std::string name;
+    std::function<void()> execute;
+    std::vector<int> reads;
+    std::vector<int> writes;
+
+    // filled by Compile
+    bool isCulled = false;
+    bool hasSideEffects = false;
+    bool writesBackbuffer = false;
+    unsigned int fbo = 0;
+    int width = 0;
+    int height = 0;
+    bool isScaled = false;
+
+public:
+    FrameGraphPass(std::string name, std::function<void()> execute);
+
+    FrameGraphPass& Read(int resource);
+    FrameGraphPass& Write(int resource);
+};
+
+/**
+ * @annotation
+ * Describes a frame as passes which read and write textures. Compile culls passes whose results are never used,
+ * orders the rest by their dependencies and allocates transient textures from a pool keyed by size and format,
+ * so textures with disjoint lifetimes share memory. Passes writing transient textures get a framebuffer
+ * with them attached, color attachments in order of Write calls.
+ */
+class FrameGraph {
+private:
+    std::vector<FrameGraphResource> resources;
+    std::vector<FrameGraphPass> passes;
+    std::vector<int> order;
+
+    struct PooledTexture {
+        unsigned int texture;
+        int width;
+        int height;
+        unsigned int internalFormat;
+        unsigned int filter;
+        int freeAfter;
+    };
+    std::vector<PooledTexture> texturePool;
+
+    int screenWidth = 0;
+    int screenHeight = 0;
+    float renderScale = 1.0f;
+    bool isCompiled = false;
+
+public:
+    int backbuffer;
+
+public:
+    FrameGraph();
+    virtual ~FrameGraph();
+
+    int CreateTexture(const std::string& name, const FrameGraphTextureDesc& desc);
+    int ImportTexture(const std::string& name, unsigned int texture);
+    FrameGraphPass& AddPass(const std::string& name, const std::function<void()>& execute);
+
+    void SetScreenSize(int width, int height);
+    void SetRenderScale(float scale);
+    void Compile();
+    void Execute();
+
+    [[nodiscard]] unsigned int GetTexture(int resource) const;
+    [[nodiscard]] float GetRenderScale() const;
+    [[nodiscard]] int GetScaledSize(int size) const;
+    [[nodiscard]] unsigned long long GetTransientMemory() const;
+    [[nodiscard]] int GetExecutedPassesCount() const;
+
+    void Free();
+
+private:
+    void Cull();
+    void Order();
+    void AllocateTextures();
+    void CreateFramebuffers();
+    static bool IsDepthFormat(unsigned int internalFormat);
+    static int GetBytesPerPixel(unsigned int internalFormat);
+};
+
+
+#endif //GLOOMENGINE_FRAMEGRAPH_H
@@ -0,0 +1,58 @@
+#ifndef GLOOMENGINE_GLYPHATLAS_H
+#define GLOOMENGINE_GLYPHATLAS_H
+
+#include "glm/glm.hpp"
+#include <string>
+#include <vector>
+
+// ASCII characters rasterized into every atlas
+#define GLYPHS_COUNT 128
+// empty texels around every glyph, so linear filtering doesn't bleed neighbours in
+#define GLYPH_PADDING 1
+#define GLYPH_ATLAS_WIDTH 512
+
+struct Glyph {
+    glm::ivec2 size;
+    // offset from baseline to left/top of glyph
+    glm::ivec2 bearing;
+    // horizontal offset to the next glyph in pixels
+    int advance;
+    glm::vec2 uvMin;
+    glm::vec2 uvMax;
+};
+
+/**
+ * @annotation
+ * All glyphs of one font in one size packed into a single GL_R8 texture, so any text using them draws
+ * without switching textures.
+ * @attention Rasterize only touches its own FreeType library and may run on a worker thread, Upload needs the GL context.
+ */
+class GlyphAtlas {
+public:
+    std::string path;
+    unsigned int fontSize;
+    unsigned int texture = 0;
+    int width = GLYPH_ATLAS_WIDTH;
+    int height = 0;
+    Glyph glyphs[GLYPHS_COUNT] = {};
+
+private:
+    // kept only between Rasterize and Upload
+    std::vector<unsigned char> pixels;
+
+public:
+    GlyphAtlas(const std::string& path, unsigned int fontSize);
+    virtual ~GlyphAtlas();
+
+    void Rasterize();
+    void Upload();
+
+    [[nodiscard]] const Glyph& GetGlyph(char character) const;
+    [[nodiscard]] int GetTextWidth(const std::string& text) const;
+    [[nodiscard]] size_t GetMemory() const;
+
+    void Free();
+};
+
+
+#endif //GLOOMENGINE_GLYPHATLAS_H
@@ -0,0 +1,121 @@
+#ifndef GLOOMENGINE_LIGHTCLUSTERS_H
+#define GLOOMENGINE_LIGHTCLUSTERS_H
+
+#include "glm/glm.hpp"
+#include <memory>
+#include <vector>
+#include <thread>
+
+class Shader;
+
+// view frustum is split into 16 x 9 screen tiles and 24 exponential depth slices
+#define CLUSTER_GRID_X 16
+#define CLUSTER_GRID_Y 9
+#define CLUSTER_GRID_Z 24
+#define CLUSTERS_NUMBER (CLUSTER_GRID_X * CLUSTER_GRID_Y * CLUSTER_GRID_Z)
+#define MAX_LIGHTS_PER_CLUSTER 128
+// attenuated light below this fraction of its intensity is treated as zero
+#define LIGHT_CUTOFF (1.0f / 256.0f)
+
+// shader storage buffer layouts (std430), ambient and diffuse are already multiplied by light color
+struct GPUDirectionalLight {
+    glm::vec4 direction;
+    glm::vec4 ambient;
+    glm::vec4 diffuse;
+};
+
+struct GPUPointLight {
+    // w is the light's range
+    glm::vec4 position;
+    // constant, linear, quadratic
+    glm::vec4 attenuation;
+    glm::vec4 ambient;
+    glm::vec4 diffuse;
+};
+
+struct GPUSpotLight {
+    // w is the light's range
+    glm::vec4 position;
+    // w is the cosine of the inner cut off
+    glm::vec4 direction;
+    // constant, linear, quadratic and the cosine of the outer cut off
+    glm::vec4 attenuation;
+    glm::vec4 ambient;
+    glm::vec4 diffuse;
+};
+
+// lights of a cluster are lightIndices[offset, offset + pointLightsCount) for point lights,
+// followed by spotLightsCount indices of spot lights
+struct LightCluster {
+    unsigned int offset;
+    unsigned int pointLightsCount;
+    unsigned int spotLightsCount;
+    unsigned int padding;
+};
+
+// view space box of one cluster
+struct ClusterBounds {
+    glm::vec3 min;
+    glm::vec3 max;
+};
+
+/**
+ * @annotation
+ * Assigns point and spot lights to froxels of the view frustum every frame, so fragments iterate only
+ * over lights which can reach them. Depth slices are split between worker threads.
+ * Buffers are bound to shader storage bindings 1 - 5.
+ */
+class LightClusters {
+private:
+    unsigned int directionalLightsSSBO = 0;
+    unsigned int pointLightsSSBO = 0;
+    unsigned int spotLightsSSBO = 0;
+    unsigned int clustersSSBO = 0;
+    unsigned int lightIndicesSSBO = 0;
+
+    std::vector<GPUDirectionalLight> directionalLights;
+    std::vector<GPUPointLight> pointLights;
+    std::vector<GPUSpotLight> spotLights;
+    // view space position and range of every point and spot light
+    std::vector<glm::vec4> pointLightSpheres;
+    std::vector<glm::vec4> spotLightSpheres;
+
+    ClusterBounds bounds[CLUSTERS_NUMBER];
+    LightCluster clusters[CLUSTERS_NUMBER];
+    // light indices of every cluster before they are packed into one list
+    unsigned int clusterLights[CLUSTERS_NUMBER][MAX_LIGHTS_PER_CLUSTER];
+    // lights reaching a cluster over MAX_LIGHTS_PER_CLUSTER, they don't light its fragments
+    unsigned int clusterDroppedLights[CLUSTERS_NUMBER];
+    unsigned int droppedLightsCount = 0;
+    unsigned int fullClustersCount = 0;
+    std::vector<unsigned int> lightIndices;
+
+    inline static unsigned int maxNumberOfThreads = std::thread::hardware_concurrency() / 2;
+    std::vector<std::thread> threads;
+
+    float zNear = 0.1f;
+    float zFar = 100.0f;
+
+public:
+    LightClusters();
+    virtual ~LightClusters();
+
+    void Update(const glm::mat4& view, float fov, float aspect, float near, float far);
+    void SetUniforms(const std::shared_ptr<Shader>& shader, const glm::vec2& screenSize) const;
+
+    [[nodiscard]] unsigned int GetLightIndicesCount() const;
+    [[nodiscard]] unsigned int GetDroppedLightsCount() const;
+    [[nodiscard]] unsigned int GetFullClustersCount() const;
+
+private:
+    void GatherLights(const glm::mat4& view);
+    void AssignSlices(int firstSlice, int lastSlice, float tanHalfFov, float aspect);
+    static float CalculateRange(float constant, float linear, float quadratic, const glm::vec3& ambient,
+                                const glm::vec3& diffuse);
+    static bool Intersects(const glm::vec4& sphere, const ClusterBounds& box);
+    template<typename T>
+    static void Upload(unsigned int ssbo, const std::vector<T>& data);
+};
+
+
+#endif //GLOOMENGINE_LIGHTCLUSTERS_H
@@ -0,0 +1,110 @@
+#ifndef GLOOMENGINE_MAPCACHE_H
+#define GLOOMENGINE_MAPCACHE_H
+
+#include "LowLevelClasses/CookedSource.h"
+#include "LowLevelClasses/MappedFile.h"
+#include "LowLevelClasses/StaticObjectData.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// layout of cooked maps in res/cooked, written when a map's json is read or saved and mapped by every later load
+#define MAP_CACHE_MAGIC 0x50414D47
+// bump whenever the layout below or the prefab types change, older files are cooked again
+#define MAP_CACHE_VERSION 1
+
+// prefabs the map's objects are created from, stored instead of their names
+enum class PrefabType : uint32_t {
+    // not a map prefab, skipped on load
+    None = 0,
+    House,
+    Shop,
+    SavePoint,
+    InvisibleBlock
+};
+
+struct CookedMapHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t objectsCount;
+    uint32_t padding;
+    CookedStamp stamp;
+    // offsets from the start of the file
+    uint64_t objectsOffset;
+    uint64_t stringsOffset;
+    uint64_t stringsSize;
+};
+
+// strings are stored once in the strings block, e.g. the model path every house of a street shares
+struct CookedMapObject {
+    CookedString uniqueName;
+    CookedString modelPath;
+    PrefabType prefab;
+    float position[3];
+    float rotation[3];
+    float scale[3];
+    float coliderSize[3];
+    float coliderOffset[3];
+};
+
+/**
+ * @annotation
+ * Cooked map mapped into memory, objects are read in place and only their strings are copied when objects are created.
+ * Open fails when there is no cooked file or it was cooked from a different json, the json is parsed then.
+ */
+class CookedMap {
+private:
+    MappedFile file;
+    // content cooked in memory when it couldn't be written
+    std::vector<unsigned char> content;
+    const unsigned char* data = nullptr;
+    size_t size = 0;
+    const CookedMapHeader* header = nullptr;
+
+public:
+    // @param path - path of the map's json, e.g. "res/ProjectConfig/map0.json"
+    bool Open(const std::string& path);
+    // uses content made by MapCooker::Cook
+    bool Load(std::vector<unsigned char> cookedContent);
+
+    [[nodiscard]] uint32_t GetObjectsCount() const;
+    [[nodiscard]] const CookedMapObject& GetObject(uint32_t index) const;
+    [[nodiscard]] std::string_view GetString(const CookedString& string) const;
+    // in bytes, for comparing against the parsed json
+    [[nodiscard]] size_t GetSize() const;
+
+    // e.g. "res/ProjectConfig/map0.json" -> "res/cooked/ProjectConfig/map0.map"
+    static std::string GetCookedPath(const std::string& path);
+
+private:
+    [[nodiscard]] bool IsValid() const;
+};
+
+/**
+ * @annotation
+ * Converts objects of a map read from its json or saved by the scene into a cooked map.
+ */
+class MapCooker {
+private:
+    std::vector<CookedMapObject> objects;
+    std::string strings;
+    // every string added so far, so repeated ones are stored once
+    std::unordered_map<std::string, CookedString> stringsIndex;
+
+public:
+    void AddObject(const StaticObjectData& object);
+
+    // @param path - path of the map's json, the cooked map is stamped with it
+    std::vector<unsigned char> Cook(const std::string& path);
+    bool Write(const std::string& path);
+
+    static PrefabType GetPrefabType(std::string_view name);
+
+private:
+    CookedString AddString(const std::string& string);
+};
+
+
+#endif //GLOOMENGINE_MAPCACHE_H
@@ -0,0 +1,40 @@
+#ifndef GLOOMENGINE_MAPPEDFILE_H
+#define GLOOMENGINE_MAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+
+/**
+ * @annotation
+ * Read only view of a whole file mapped into memory, pages are read from disk only once they are touched.
+ * @attention Data is valid until the file is closed or the object destroyed, it can be moved but not copied.
+ */
+class MappedFile {
+private:
+    const unsigned char* data = nullptr;
+    size_t size = 0;
+#ifdef _WIN32
+    void* file = nullptr;
+    void* mapping = nullptr;
+#endif
+
+public:
+    MappedFile() = default;
+    explicit MappedFile(const std::string& path);
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    virtual ~MappedFile();
+
+    // false if the file doesn't exist, is empty or couldn't be mapped
+    bool Open(const std::string& path);
+    void Close();
+
+    [[nodiscard]] bool IsOpen() const;
+    [[nodiscard]] const unsigned char* GetData() const;
+    [[nodiscard]] size_t GetSize() const;
+};
+
+
+#endif //GLOOMENGINE_MAPPEDFILE_H
@@ -8,14 +8,12 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <cstdint>
 
 #include "Shader.h"
 
 #define MAX_BONE_INFLUENCE 4
 
-class Image;
-class Button;
-
 struct Vertex {
     // position
     glm::vec3 position;
@@ -35,38 +33,90 @@ struct Vertex {
     float weights[MAX_BONE_INFLUENCE];
 };
 
+// GPU side vertex formats, chosen at import and packed from Vertex by Mesh::setupMesh
+enum class VertexLayout {
+    // position, normal and texture coordinates
+    Static,
+    // static with bone ids and weights
+    Skinned
+};
+
+struct StaticVertex {
+    glm::vec3 position;
+    // snorm 10:10:10:2
+    uint32_t normal;
+    // two half floats
+    uint32_t texCoords;
+};
+
+struct SkinnedVertex {
+    glm::vec3 position;
+    uint32_t normal;
+    uint32_t texCoords;
+    uint8_t boneIDs[MAX_BONE_INFLUENCE];
+    // unorm 8, sum up to 255
+    uint8_t weights[MAX_BONE_INFLUENCE];
+};
+
 struct Texture {
     unsigned int id;
     std::string type;
     std::string path;
 };
 
+/**
+ * @attention Vertices and indices are released after upload, only counts and bounds are kept on CPU side.
+ */
 class Mesh {
 public:
     // mesh Data
-    std::vector<Vertex> vertices;
-    std::vector<unsigned int> indices;
     std::vector<Texture> textures;
     unsigned int vao;
+    VertexLayout layout;
+    unsigned int vertexCount = 0;
+    unsigned int indexCount = 0;
+    // bounds of vertex positions in model space
+    glm::vec3 minPosition = glm::vec3(0.0f);
+    glm::vec3 maxPosition = glm::vec3(0.0f);
 
     // constructor
-    Mesh(std::vector<Vertex> vertices, std::vector<unsigned int> indices, std::vector<Texture> textures);
+    Mesh(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices, std::vector<Texture> textures,
+         VertexLayout layout = VertexLayout::Static);
+    // uploads vertices already packed into the layout, e.g. straight from a cooked file, without copying them
+    Mesh(const unsigned char* packedVertices, unsigned int vertexCount, const unsigned int* indices, unsigned int indexCount,
+         const glm::vec3& minPosition, const glm::vec3& maxPosition, std::vector<Texture> textures, VertexLayout layout);
+    // meshes own their GL objects, a moved from mesh is left without any
+    Mesh(const Mesh& other) = delete;
+    Mesh& operator=(const Mesh& other) = delete;
+    Mesh(Mesh&& other) noexcept;
+    Mesh& operator=(Mesh&& other) noexcept;
     virtual ~Mesh();
 
     // render the mesh
     // "textured" is a temporary workaround for cubemap problem
     void Draw(std::shared_ptr<Shader> &shader, int type);
+    // draws instances [firstInstance, firstInstance + instanceCount) of RendererManager's instance buffer
+    void DrawInstanced(std::shared_ptr<Shader> &shader, int type, int instanceCount, unsigned int firstInstance);
 
     unsigned int GetVBO();
+    [[nodiscard]] size_t GetVertexBufferSize() const;
+    // copies uploaded vertices and indices into other buffers on the GPU, e.g. the static geometry pool
+    void CopyBuffers(unsigned int vertexBuffer, size_t vertexOffset, unsigned int indexBuffer, size_t indexOffset) const;
 
-private:
-    friend class Image;
-    friend class Button;
+    static unsigned int GetVertexSize(VertexLayout vertexLayout);
+    static std::vector<unsigned char> PackVertices(const std::vector<Vertex>& source, VertexLayout vertexLayout);
+    static void SetupVertexAttributes(VertexLayout vertexLayout);
+
+protected:
     // render data
     unsigned int vbo, ebo;
 
+    // creates buffers without filling them
+    Mesh(std::vector<Texture> textures, VertexLayout layout);
+
     // initializes all the buffer objects/arrays
-    void setupMesh();
+    void setupMesh(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices, int usage);
+    void setupPackedMesh(const unsigned char* packedVertices, const unsigned int* indices, int usage);
 };
 
 
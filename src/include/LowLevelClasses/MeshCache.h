@@ -0,0 +1,122 @@
+#ifndef GLOOMENGINE_MESHCACHE_H
+#define GLOOMENGINE_MESHCACHE_H
+
+#include "LowLevelClasses/CookedSource.h"
+#include "LowLevelClasses/MappedFile.h"
+#include "LowLevelClasses/Mesh.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// layout of cooked models in res/cooked, written on the first import of a model and mapped by every later load
+#define MESH_CACHE_MAGIC 0x48534D47
+// bump whenever import flags, vertex packing or the layout below change, older files are cooked again
+#define MESH_CACHE_VERSION 2
+// vertex and index blobs start on this boundary
+#define MESH_CACHE_ALIGNMENT 16
+
+struct CookedMeshHeader {
+    uint32_t magic;
+    uint32_t version;
+    // 1 for animation models, their import differs from static ones
+    uint32_t isSkinned;
+    uint32_t meshesCount;
+    uint32_t texturesCount;
+    uint32_t bonesCount;
+    CookedStamp stamp;
+    // offsets from the start of the file
+    uint64_t meshesOffset;
+    uint64_t texturesOffset;
+    uint64_t bonesOffset;
+    uint64_t stringsOffset;
+    uint64_t stringsSize;
+};
+
+struct CookedMesh {
+    uint32_t layout;
+    uint32_t vertexCount;
+    uint32_t indexCount;
+    // range of the textures table used by the mesh
+    uint32_t firstTexture;
+    uint32_t texturesCount;
+    uint32_t padding;
+    // vertices are packed into the layout already
+    uint64_t verticesOffset;
+    uint64_t indicesOffset;
+    float minPosition[3];
+    float maxPosition[3];
+};
+
+struct CookedTexture {
+    // sampler name, e.g. "texture_diffuse"
+    CookedString type;
+    // file name next to the model
+    CookedString path;
+};
+
+struct CookedBone {
+    CookedString name;
+    int32_t id;
+    uint32_t padding;
+    // column major like glm
+    float offset[16];
+};
+
+/**
+ * @annotation
+ * Cooked model mapped into memory, meshes are uploaded straight from the mapping without parsing anything.
+ * Open fails when there is no cooked file or it was cooked from a different source, the model is imported then.
+ */
+class CookedModel {
+private:
+    MappedFile file;
+    const CookedMeshHeader* header = nullptr;
+
+public:
+    // @param path - path of the source model, e.g. "res/models/Buildings/Environment/Lamp.obj"
+    bool Open(const std::string& path, bool isSkinned);
+
+    [[nodiscard]] uint32_t GetMeshesCount() const;
+    [[nodiscard]] const CookedMesh& GetMesh(uint32_t index) const;
+    [[nodiscard]] const CookedTexture& GetTexture(uint32_t index) const;
+    [[nodiscard]] uint32_t GetBonesCount() const;
+    [[nodiscard]] const CookedBone& GetBone(uint32_t index) const;
+    [[nodiscard]] std::string_view GetString(const CookedString& string) const;
+    [[nodiscard]] const unsigned char* GetVertices(const CookedMesh& mesh) const;
+    [[nodiscard]] const unsigned int* GetIndices(const CookedMesh& mesh) const;
+
+    // e.g. "res/models/Buildings/Environment/Lamp.obj" -> "res/cooked/models/Buildings/Environment/Lamp.mesh"
+    static std::string GetCookedPath(const std::string& path, bool isSkinned);
+
+private:
+    [[nodiscard]] bool IsValid() const;
+};
+
+/**
+ * @annotation
+ * Collects meshes while a model is imported with Assimp and writes them as a cooked model once the import is done.
+ */
+class ModelCooker {
+private:
+    std::vector<CookedMesh> meshes;
+    std::vector<CookedTexture> textures;
+    std::vector<CookedBone> bones;
+    std::string strings;
+    // vertex and index blobs, offsets are relative to its start until the file is written
+    std::vector<unsigned char> data;
+
+public:
+    // @param textures - only types and paths are kept, models cooked on workers have no texture ids
+    void AddMesh(VertexLayout layout, const std::vector<Texture>& textures, const std::vector<Vertex>& vertices,
+                 const std::vector<unsigned int>& indices);
+    void AddBone(const std::string& name, int id, const glm::mat4& offset);
+
+    bool Write(const std::string& path, bool isSkinned);
+
+private:
+    CookedString AddString(const std::string& string);
+};
+
+
+#endif //GLOOMENGINE_MESHCACHE_H
@@ -7,8 +7,12 @@
 
 #include "Mesh.h"
 #include "assimp/scene.h"
+#include <string_view>
 #include <string>
 
+class CookedModel;
+class ModelCooker;
+
 class Model {
 protected:
     // model data
@@ -19,6 +23,10 @@ protected:
     // GL_TRIANGLES etc
     int type;
     bool gammaCorrection;
+    // set while an imported model is being cooked, meshes processed meanwhile are added to it
+    ModelCooker* cooker = nullptr;
+    // set while a worker cooks the model ahead of its load, no GL objects or textures are created then
+    bool isCookingOnly = false;
 public:
     Model(std::string const &path, std::shared_ptr<Shader> &shader, int type = GL_TRIANGLES, bool gamma = false);
     Model(const Mesh& mesh, std::shared_ptr<Shader> &shader, int type = GL_TRIANGLES);
@@ -26,7 +34,14 @@ public:
 
     virtual void Draw();
     virtual void Draw(std::shared_ptr<Shader> useShader);
+    void DrawInstanced(std::shared_ptr<Shader> useShader, int instanceCount, unsigned int firstInstance);
     inline const std::vector<Mesh>& GetMeshes() { return meshes; }
+    inline int GetType() const { return type; }
+    // ids used by render queue to group draws of the same model
+    inline unsigned int GetTextureSetKey() { return texturesLoaded.empty() ? 0 : texturesLoaded[0].id; }
+    inline unsigned int GetMeshKey() { return meshes.empty() ? 0 : meshes[0].vao; }
+    // vertex and index buffers of the meshes, textures are counted by TextureManager
+    [[nodiscard]] size_t GetMemory() const;
 
     virtual void LoadModel(std::string const &path) = 0;
 
@@ -35,6 +50,10 @@ protected:
     virtual void ProcessNode(aiNode *node, const aiScene *scene) = 0;
     virtual void ProcessMesh(aiMesh *mesh, const aiScene *scene) = 0;
     std::vector<Texture> LoadMaterialTextures(aiMaterial *mat, aiTextureType type, std::string typeName);
+    // loads the texture once per model, meshes sharing it get the same one
+    Texture LoadMaterialTexture(std::string_view path, std::string_view typeName);
+    // creates meshes straight from the mapped vertex and index data
+    void LoadCookedMeshes(const CookedModel& cooked);
 };
 
 
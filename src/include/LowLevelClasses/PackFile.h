@@ -0,0 +1,80 @@
+#ifndef GLOOMENGINE_PACKFILE_H
+#define GLOOMENGINE_PACKFILE_H
+
+#include "LowLevelClasses/MappedFile.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// layout of res.pack written by tools/PackFiles, the whole archive is mapped and entries are read in place
+#define PACK_FILE_MAGIC 0x4B415047
+#define PACK_FILE_VERSION 1
+// content of every entry starts on this boundary
+#define PACK_FILE_ALIGNMENT 16
+// FNV-1a
+#define PACK_HASH_SEED 0xcbf29ce484222325ULL
+
+enum class PackCompression : uint32_t {
+    None = 0,
+    LZ4 = 1
+};
+
+struct PackHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t entriesCount;
+    uint32_t padding;
+    // offsets from the start of the file
+    uint64_t entriesOffset;
+    uint64_t pathsOffset;
+    uint64_t pathsSize;
+};
+
+// entries are sorted by the hash of their path, so they are found with a binary search
+struct PackEntry {
+    // of the path relative to the working directory, e.g. "res/shaders/basic.vert"
+    uint64_t pathHash;
+    // in the paths block
+    uint32_t pathOffset;
+    uint32_t pathLength;
+    uint64_t offset;
+    // as stored, smaller than originalSize if the entry is compressed
+    uint64_t size;
+    uint64_t originalSize;
+    // of the original content, so packed sources of cooked files aren't hashed again
+    uint64_t contentHash;
+    // of the packed file, like std::filesystem::last_write_time counts it
+    int64_t writeTime;
+    PackCompression compression;
+    uint32_t padding;
+};
+
+/**
+ * @annotation
+ * Archive of files under res mapped into memory, entries are found by path without touching the file system.
+ */
+class PackFile {
+private:
+    MappedFile file;
+    const PackHeader* header = nullptr;
+
+public:
+    bool Open(const std::string& path);
+    [[nodiscard]] bool IsOpen() const;
+
+    // @param path - normalized path relative to the working directory, nullptr if it isn't packed
+    [[nodiscard]] const PackEntry* Find(std::string_view path) const;
+    [[nodiscard]] uint32_t GetEntriesCount() const;
+    [[nodiscard]] const PackEntry& GetEntry(uint32_t index) const;
+    [[nodiscard]] std::string_view GetPath(const PackEntry& entry) const;
+    // stored content, compressed entries have to be decompressed
+    [[nodiscard]] const unsigned char* GetContent(const PackEntry& entry) const;
+
+    static uint64_t Hash(const void* data, size_t size, uint64_t hash = PACK_HASH_SEED);
+
+private:
+    [[nodiscard]] bool IsValid() const;
+};
+
+
+#endif //GLOOMENGINE_PACKFILE_H
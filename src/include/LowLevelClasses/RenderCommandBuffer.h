@@ -0,0 +1,59 @@
+#ifndef GLOOMENGINE_RENDERCOMMANDBUFFER_H
+#define GLOOMENGINE_RENDERCOMMANDBUFFER_H
+
+#include "glm/glm.hpp"
+#include <vector>
+#include <cstdint>
+
+#include "Components/Renderers/Drawable.h"
+
+class Mesh;
+class Model;
+
+enum class RenderCommandType : uint8_t {
+    // one mesh with uniforms of its object
+    Mesh,
+    // one mesh of an instance batch, per instance data is already in the instance buffer
+    InstancedMesh,
+    // drawable which doesn't record its draws, e.g. the skybox, it is drawn by calling Drawable::Draw
+    Drawable
+};
+
+// everything needed to issue one draw, resolved while recording so replay only talks to GL
+struct RenderCommand {
+    RenderCommandType type;
+    bool drawShadows;
+    bool isStatic;
+    bool isAnimated;
+    // instanced mesh of a batch which is also drawn by the static geometry pool
+    bool isPooled;
+    // first mesh of an object sets its model matrix and bones offset, following meshes reuse them
+    bool setsObjectUniforms;
+    int primitive;
+    const Mesh* mesh;
+    Drawable* drawable;
+    glm::mat4 model;
+    Material material;
+    glm::vec2 textScale;
+    int bonesOffset;
+    unsigned int firstInstance;
+    unsigned int instanceCount;
+};
+
+/**
+ * @annotation
+ * Commands recorded by one thread, storage is kept between frames so recording doesn't allocate once warmed up
+ */
+class RenderCommandBuffer {
+public:
+    std::vector<RenderCommand> commands;
+
+public:
+    void Clear();
+    void Add(const RenderCommand& command);
+    // copies objectCommand once per mesh of the model
+    void AddModel(Model* model, const RenderCommand& objectCommand);
+};
+
+
+#endif //GLOOMENGINE_RENDERCOMMANDBUFFER_H
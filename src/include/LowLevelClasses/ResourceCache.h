@@ -0,0 +1,137 @@
+#ifndef GLOOMENGINE_RESOURCECACHE_H
+#define GLOOMENGINE_RESOURCECACHE_H
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+/**
+ * @annotation
+ * Refcounting and eviction shared by managers caching resources loaded from files. Entries count their users,
+ * ones nobody uses stay cached for later loads and are evicted, least recently released first, over the budget.
+ * @tparam T - entry with id, memory, usersCount and lastRelease members
+ */
+template<class T>
+class ResourceCache {
+private:
+    std::unordered_map<std::string, T> entries;
+    // key of every entry, so users only need to keep the id
+    std::unordered_map<unsigned int, std::string> keys;
+    // frees what an evicted entry owns, e.g. its GL texture
+    std::function<void(T&)> onEvict;
+    size_t memoryBudget;
+    size_t memory = 0;
+    size_t unusedMemory = 0;
+    unsigned int releasesCount = 0;
+    // acquired entries nobody used before
+    unsigned int revivedCount = 0;
+
+public:
+    explicit ResourceCache(size_t memoryBudget, std::function<void(T&)> onEvict = nullptr) :
+            onEvict(std::move(onEvict)), memoryBudget(memoryBudget) {}
+
+    // adds a user to the entry, nullptr if the key isn't cached
+    T* Acquire(const std::string& key) {
+        auto cached = entries.find(key);
+        if (cached == entries.end()) return nullptr;
+
+        T& entry = cached->second;
+        if (entry.usersCount == 0) {
+            unusedMemory -= entry.memory;
+            ++revivedCount;
+        }
+        ++entry.usersCount;
+        return &entry;
+    }
+
+    // nullptr if the key isn't cached, no user is added
+    T* Find(const std::string& key) {
+        auto cached = entries.find(key);
+        return cached == entries.end() ? nullptr : &cached->second;
+    }
+
+    // caches a new entry with one user, unused entries are evicted if it goes over the budget
+    T& Insert(const std::string& key, unsigned int id, size_t entryMemory) {
+        keys.insert({id, key});
+        memory += entryMemory;
+        T& entry = entries[key];
+        entry.id = id;
+        entry.memory = entryMemory;
+        entry.usersCount = 1;
+        // inserted first, so it has a user and evicting can't remove it, erasing others keeps the reference valid
+        Evict();
+        return entry;
+    }
+
+    void AddUser(unsigned int id) {
+        auto key = keys.find(id);
+        if (key == keys.end()) return;
+
+        T& entry = entries[key->second];
+        if (entry.usersCount == 0) unusedMemory -= entry.memory;
+        ++entry.usersCount;
+    }
+
+    void Release(unsigned int id) {
+        auto key = keys.find(id);
+        if (key == keys.end()) return;
+
+        T& entry = entries[key->second];
+        if (entry.usersCount == 0) return;
+        --entry.usersCount;
+        if (entry.usersCount == 0) {
+            entry.lastRelease = ++releasesCount;
+            unusedMemory += entry.memory;
+            Evict();
+        }
+    }
+
+    void SetMemoryBudget(size_t newMemoryBudget) {
+        memoryBudget = newMemoryBudget;
+        Evict();
+    }
+
+    // evicts every entry, users still holding ids release nothing afterwards
+    void Clear() {
+        if (onEvict) {
+            for (auto& entry : entries) {
+                onEvict(entry.second);
+            }
+        }
+        entries.clear();
+        keys.clear();
+        memory = 0;
+        unusedMemory = 0;
+    }
+
+    [[nodiscard]] size_t GetMemory() const { return memory; }
+    [[nodiscard]] size_t GetUnusedMemory() const { return unusedMemory; }
+    [[nodiscard]] size_t GetCount() const { return entries.size(); }
+    [[nodiscard]] unsigned int GetRevivedCount() const { return revivedCount; }
+
+private:
+    // entries in use are never evicted, even if they alone are over the budget
+    void Evict() {
+        while (memory > memoryBudget && unusedMemory > 0) {
+            auto oldest = entries.end();
+            for (auto entry = entries.begin(); entry != entries.end(); ++entry) {
+                if (entry->second.usersCount > 0) continue;
+                if (oldest == entries.end() || entry->second.lastRelease < oldest->second.lastRelease) {
+                    oldest = entry;
+                }
+            }
+            if (oldest == entries.end()) return;
+
+            if (onEvict) onEvict(oldest->second);
+            memory -= oldest->second.memory;
+            unusedMemory -= oldest->second.memory;
+            keys.erase(oldest->second.id);
+            entries.erase(oldest);
+        }
+    }
+};
+
+
+#endif //GLOOMENGINE_RESOURCECACHE_H
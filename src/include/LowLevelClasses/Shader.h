@@ -9,6 +9,7 @@
 #include "glm/matrix.hpp"
 #include "glm/gtc/matrix_transform.hpp"
 #include <string>
+#include <set>
 
 class Shader {
 private:
@@ -36,6 +37,7 @@ public:
 
 private:
     static void LoadShader(std::string& shaderPath, std::string& shaderCodeOut);
+    static bool LoadShader(const std::string& shaderPath, std::string& shaderCodeOut, std::set<std::string>& includingPaths);
 };
 
 
@@ -0,0 +1,69 @@
+#ifndef GLOOMENGINE_SPRITEATLAS_H
+#define GLOOMENGINE_SPRITEATLAS_H
+
+#include "glm/glm.hpp"
+#include <map>
+#include <string>
+#include <vector>
+
+#define SPRITE_ATLAS_SIZE 2048
+// bigger images, e.g. backgrounds, keep their own texture
+#define MAX_PACKED_SPRITE_SIZE 512
+// copies of border texels around every sprite, enough for mip levels up to SPRITE_ATLAS_LEVELS
+#define SPRITE_PADDING 8
+#define SPRITE_ATLAS_LEVELS 4
+
+// part of a texture drawn by one UI quad
+struct Sprite {
+    unsigned int texture = 0;
+    glm::vec2 uvMin = glm::vec2(0.0f);
+    glm::vec2 uvMax = glm::vec2(1.0f);
+    int width = 0;
+    int height = 0;
+    // has texels which pass the alpha test but still blend, so it has to be drawn back to front
+    bool isTranslucent = false;
+    bool isPacked = false;
+};
+
+struct SpriteAtlasPage {
+    unsigned int texture = 0;
+    glm::ivec2 cursor = glm::ivec2(0);
+    int rowHeight = 0;
+    bool isDirty = false;
+};
+
+/**
+ * @annotation
+ * Loads UI images, small ones are packed into shared RGBA8 pages so quads using them batch together.
+ * Packed sprites are cached by path and live as long as the atlas, the set of UI images is small and fixed.
+ */
+class SpriteAtlas {
+private:
+    std::vector<SpriteAtlasPage> pages;
+    std::map<std::string, Sprite> packedSprites;
+    // sprites of images too big to pack, their textures are shared through TextureManager
+    std::map<std::string, Sprite> textureSprites;
+
+public:
+    SpriteAtlas();
+    virtual ~SpriteAtlas();
+
+    // path relative to res/textures
+    Sprite Load(const std::string& path);
+    // releases the texture of a sprite which isn't packed
+    static void Release(Sprite& sprite);
+    // regenerates mipmaps of pages changed since the last call
+    void Update();
+
+    [[nodiscard]] size_t GetMemory() const;
+    [[nodiscard]] size_t GetPagesCount() const;
+
+    void Free();
+
+private:
+    bool Pack(const unsigned char* pixels, int width, int height, Sprite& sprite);
+    void AddPage();
+};
+
+
+#endif //GLOOMENGINE_SPRITEATLAS_H
@@ -0,0 +1,76 @@
+#ifndef GLOOMENGINE_SPRITEBATCH_H
+#define GLOOMENGINE_SPRITEBATCH_H
+
+#include "glm/glm.hpp"
+#include "glm/gtc/type_precision.hpp"
+#include <memory>
+#include <string>
+#include <vector>
+
+// quads drawn in one frame, the rest is dropped
+#define MAX_SPRITE_QUADS 16384
+// depth added per submitted component, so of two quads with the same z the one submitted first stays in front
+#define SPRITE_ORDER_BIAS 0.000001f
+
+class Shader;
+class GlyphAtlas;
+struct Sprite;
+
+struct SpriteVertex {
+    glm::vec3 position;
+    glm::vec2 texCoords;
+    // unorm 8, alpha is the component's alpha
+    glm::u8vec4 color;
+    float isText;
+};
+
+struct SpriteQuad {
+    unsigned int texture;
+    float depth;
+    bool isTranslucent;
+    // left bottom, left top, right bottom, right top
+    SpriteVertex vertices[4];
+};
+
+/**
+ * @annotation
+ * Collects quads of all UI components in a frame and draws them from one streaming vertex buffer.
+ * Opaque quads, e.g. glyphs and alpha tested images, are grouped by texture since the depth test orders them,
+ * translucent quads are drawn after them from back to front, neighbours with the same texture share a draw call.
+ */
+class SpriteBatch {
+private:
+    unsigned int vao = 0, vbo = 0, ebo = 0;
+    std::vector<SpriteQuad> opaqueQuads;
+    std::vector<SpriteQuad> translucentQuads;
+    unsigned int componentsCount = 0;
+    unsigned int drawCallsCount = 0;
+    unsigned int quadsCount = 0;
+
+public:
+    SpriteBatch();
+    virtual ~SpriteBatch();
+
+    // quads added after this call belong to the next component
+    void NextComponent();
+    // corners in pixels: left bottom, left top, right bottom, right top
+    void AddSprite(const Sprite& sprite, const glm::vec2 corners[4], const glm::vec4& color, float z);
+    /**
+    * x from 0 to 1920\n
+    * y from 0 to 1080
+    */
+    void AddText(const GlyphAtlas& atlas, const std::string& text, float x, float y, float z, const glm::vec3& color);
+    void Draw(const std::shared_ptr<Shader>& shader);
+
+    // stats of the last drawn batch
+    [[nodiscard]] unsigned int GetDrawCallsCount() const;
+    [[nodiscard]] unsigned int GetQuadsCount() const;
+
+    void Free();
+
+private:
+    SpriteQuad* AddQuad(unsigned int texture, float z, bool isTranslucent);
+};
+
+
+#endif //GLOOMENGINE_SPRITEBATCH_H
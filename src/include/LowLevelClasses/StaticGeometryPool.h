@@ -0,0 +1,89 @@
+#ifndef GLOOMENGINE_STATICGEOMETRYPOOL_H
+#define GLOOMENGINE_STATICGEOMETRYPOOL_H
+
+#include <memory>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+#include "Mesh.h"
+#include "Components/Renderers/Drawable.h"
+#include "EngineManagers/AssetManager.h"
+
+#define MAX_POOL_COMMANDS 4096
+
+class Model;
+class StaticModel;
+
+// layout required by glMultiDrawElementsIndirect
+struct DrawElementsIndirectCommand {
+    unsigned int count;
+    unsigned int instanceCount;
+    unsigned int firstIndex;
+    int baseVertex;
+    unsigned int baseInstance;
+};
+
+// place of one mesh inside the pool's buffers
+struct PoolRange {
+    unsigned int firstIndex;
+    unsigned int indexCount;
+    int baseVertex;
+    const std::vector<Texture>* textures;
+};
+
+// consecutive indirect commands sharing textures and material, submitted with one call
+struct PoolDraw {
+    const std::vector<Texture>* textures;
+    Material material;
+    bool drawShadows;
+    unsigned int firstCommand;
+    unsigned int commandsCount;
+};
+
+/**
+ * @annotation
+ * Keeps meshes of all static models in one shared vertex and index buffer,
+ * so visible objects can be drawn with a few multi draw indirect calls instead of a draw per mesh.
+ */
+class StaticGeometryPool {
+private:
+    unsigned int vao = 0;
+    unsigned int vbo = 0;
+    unsigned int ebo = 0;
+    unsigned int indirectBuffer = 0;
+
+    std::unordered_map<Model*, std::vector<PoolRange>> ranges;
+
+    struct PendingCommand {
+        uint64_t key;
+        const std::vector<Texture>* textures;
+        Material material;
+        bool drawShadows;
+        DrawElementsIndirectCommand command;
+    };
+
+    unsigned int pendingCount = 0;
+    PendingCommand pending[MAX_POOL_COMMANDS];
+    DrawElementsIndirectCommand commands[MAX_POOL_COMMANDS];
+    unsigned int drawsCount = 0;
+    PoolDraw draws[MAX_POOL_COMMANDS];
+
+public:
+    StaticGeometryPool();
+    virtual ~StaticGeometryPool();
+
+    void Build(const std::unordered_map<int, AssetHandle<StaticModel>>& models);
+    void Clear();
+    [[nodiscard]] bool Contains(Model* model) const;
+
+    void BeginFrame();
+    bool AddInstances(Model* model, const Material& material, bool drawShadows,
+                      unsigned int firstInstance, unsigned int instanceCount);
+    void EndFrame();
+
+    void Draw(const std::shared_ptr<Shader>& shader, bool isShadowPass);
+};
+
+
+#endif //GLOOMENGINE_STATICGEOMETRYPOOL_H
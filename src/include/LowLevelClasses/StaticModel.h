@@ -17,8 +17,15 @@ public:
     StaticModel(const Mesh &mesh, std::shared_ptr<Shader> &shader, int type = GL_TRIANGLES);
 
     void LoadModel(std::string const &path) override;
+    // imports the model without touching GL and writes its cooked file, so workers can prepare it ahead of its load
+    // @returns false if the model couldn't be imported
+    static bool Cook(const std::string &path);
 
 protected:
+    // a model only used to cook, see Cook
+    explicit StaticModel(std::shared_ptr<Shader> &shader);
+    // imports the model with Assimp and cooks it, meshes are created too unless isCookingOnly is set
+    bool Import(const std::string &path);
     void ProcessNode(aiNode *node, const aiScene *scene) override;
     void ProcessMesh(aiMesh *mesh, const aiScene *scene) override;
 };
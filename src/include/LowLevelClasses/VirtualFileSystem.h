@@ -0,0 +1,106 @@
+#ifndef GLOOMENGINE_VIRTUALFILESYSTEM_H
+#define GLOOMENGINE_VIRTUALFILESYSTEM_H
+
+#include "LowLevelClasses/MappedFile.h"
+#include "LowLevelClasses/PackFile.h"
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+// archive mounted at startup if it's next to the executable, tools/PackFiles writes it there
+#define VIRTUAL_FILE_SYSTEM_PACK "res.pack"
+
+/**
+ * @annotation
+ * Content of a file read through VirtualFileSystem. Loose files and uncompressed entries are mapped,
+ * compressed entries are decompressed into memory owned by the file.
+ * @attention Data is valid until the file is closed or the object destroyed, it can be moved but not copied.
+ */
+class VirtualFile {
+    friend class VirtualFileSystem;
+
+private:
+    MappedFile file;
+    std::vector<unsigned char> content;
+    const unsigned char* data = nullptr;
+    size_t size = 0;
+
+public:
+    VirtualFile() = default;
+    VirtualFile(VirtualFile&& other) noexcept;
+    VirtualFile& operator=(VirtualFile&& other) noexcept;
+
+    [[nodiscard]] bool IsOpen() const;
+    [[nodiscard]] const unsigned char* GetData() const;
+    [[nodiscard]] size_t GetSize() const;
+    [[nodiscard]] std::string_view GetText() const;
+    void Close();
+};
+
+struct VirtualFileInfo {
+    uint64_t size = 0;
+    int64_t writeTime = 0;
+    // stored for packed files, loose ones have to be hashed
+    uint64_t contentHash = 0;
+    bool isPacked = false;
+};
+
+/**
+ * @annotation
+ * Reads files of res from the archive made by tools/PackFiles or from loose files.
+ * In DEBUG builds loose files edited before mounting override packed ones, so edits are picked up without packing again,
+ * other builds read packed files without touching the file system.
+ * The archive is only read after mounting, so files can be opened from any thread.
+ */
+class VirtualFileSystem {
+private:
+    inline static VirtualFileSystem* virtualFileSystem;
+
+    PackFile pack;
+    // packed files whose loose copies were edited after packing, only found in DEBUG builds
+    std::unordered_set<const PackEntry*> editedEntries;
+
+    // stats of all reads, workers read files too
+    std::atomic<unsigned int> looseCount = 0;
+    std::atomic<unsigned int> packedCount = 0;
+    std::atomic<unsigned int> decompressedCount = 0;
+
+public:
+    VirtualFileSystem(VirtualFileSystem &other) = delete;
+    void operator=(const VirtualFileSystem&) = delete;
+    virtual ~VirtualFileSystem();
+
+    static VirtualFileSystem* GetInstance();
+
+    // has to be called before any file is read
+    bool Mount(const std::string& packPath);
+
+    // @param path - relative to the working directory or absolute, e.g. "res/shaders/basic.vert"
+    bool Open(const std::string& path, VirtualFile& file);
+    bool Exists(const std::string& path);
+    bool GetInfo(const std::string& path, VirtualFileInfo& info);
+
+    [[nodiscard]] bool IsMounted() const;
+    [[nodiscard]] uint32_t GetPackedFilesCount() const;
+    [[nodiscard]] unsigned int GetLooseCount() const;
+    [[nodiscard]] unsigned int GetPackedCount() const;
+    [[nodiscard]] unsigned int GetDecompressedCount() const;
+
+    // e.g. "res/models/../textures/a.png" -> "res/textures/a.png", the form paths are packed with
+    static std::string NormalizePath(const std::string& path);
+    // the working directory if it can't be found
+    static std::string GetExecutableDirectory();
+
+private:
+    explicit VirtualFileSystem();
+
+    // the loose file is newer or has another size than the packed one
+    static bool IsEdited(const std::string& path, const PackEntry& entry);
+    static bool IsEmpty(const std::string& path);
+};
+
+
+#endif //GLOOMENGINE_VIRTUALFILESYSTEM_H
@@ -5,6 +5,8 @@
 #include "Components/Audio/AudioLoader.h"
 #include "Components/Audio/AudioSource.h"
 #include <spdlog/spdlog.h>
+#include <algorithm>
+#include <cstring>
 
 AudioLoader::AudioLoader() = default;
 
@@ -27,17 +29,11 @@ void AudioLoader::InitializeAudioLoader(const ALuint &sourceId, const ALuint *bu
  * @param path - path to .wav file
  */
 void AudioLoader::OpenFile(const std::string &path) {
-    file.open(path, std::ios::binary);
-
-    if (file.bad()) {
+    if (!VirtualFileSystem::GetInstance()->Open(path, file)) {
         spdlog::error(path + " is not a correct .WAV file format!");
         return;
     }
-
-    if (!file.is_open()) {
-        spdlog::error(path + " is already opened, did you forget to close it?");
-        return;
-    }
+    position = 0;
 }
 
 /**
@@ -46,7 +42,7 @@ void AudioLoader::OpenFile(const std::string &path) {
  * @param type - Positional or Direct audio
  */
 void AudioLoader::LoadFileHeader(const AudioType& type) {
-    if (!file.is_open()) {
+    if (!file.IsOpen()) {
         spdlog::error("File is not opened, did you forget to call another function?");
         return;
     }
@@ -56,7 +52,7 @@ void AudioLoader::LoadFileHeader(const AudioType& type) {
     //
     // "RIFF" header
     //
-    if (!file.read(data, 4)) {
+    if (!Read(data, 4)) {
         spdlog::error("Invalid RIFF header!");
         return;
     }
@@ -66,12 +62,12 @@ void AudioLoader::LoadFileHeader(const AudioType& type) {
         return;
     }
 
-    if (!file.read(reinterpret_cast<char *>(&fileSize), 4)) {
+    if (!Read(reinterpret_cast<char *>(&fileSize), 4)) {
         spdlog::error("Invalid file size!");
         return;
     }
 
-    if (!file.read(data, 4)) {
+    if (!Read(data, 4)) {
         spdlog::error("Invalid WAVE header!");
         return;
     }
@@ -84,7 +80,7 @@ void AudioLoader::LoadFileHeader(const AudioType& type) {
     //
     // "fmt" header
     //
-    if (!file.read(data, 4)) {
+    if (!Read(data, 4)) {
         spdlog::error("Invalid read fmt header!");
         return;
     }
@@ -94,38 +90,38 @@ void AudioLoader::LoadFileHeader(const AudioType& type) {
         return;
     }
 
-    if (!file.read(reinterpret_cast<char *>(&formatLength), 4)) {
+    if (!Read(reinterpret_cast<char *>(&formatLength), 4)) {
         spdlog::error("Invalid fmt data chunk size!");
         return;
     }
 
-    if (!file.read(reinterpret_cast<char *>(&formatType), 2)) {
+    if (!Read(reinterpret_cast<char *>(&formatType), 2)) {
         spdlog::error("Invalid format type!");
         return;
     }
 
-    if (!file.read(reinterpret_cast<char *>(&numChannels), 2)) {
+    if (!Read(reinterpret_cast<char *>(&numChannels), 2)) {
         spdlog::error("Invalid number of channels!");
         return;
     }
 
-    if (!file.read(reinterpret_cast<char *>(&sampleRate), 4)) {
+    if (!Read(reinterpret_cast<char *>(&sampleRate), 4)) {
         spdlog::error("Invalid sample rate!");
         return;
     }
 
     // SampleRate * NumChannels * BitsPerSample / 8
-    if (!file.read(reinterpret_cast<char *>(&byteRate), 4)) {
+    if (!Read(reinterpret_cast<char *>(&byteRate), 4)) {
         spdlog::error("Invalid byte rate!");
         return;
     }
 
-    if (!file.read(reinterpret_cast<char *>(&blockAlign), 2)) {
+    if (!Read(reinterpret_cast<char *>(&blockAlign), 2)) {
         spdlog::error("Invalid block align!");
         return;
     }
 
-    if (!file.read(reinterpret_cast<char *>(&bitsPerSample), 2)) {
+    if (!Read(reinterpret_cast<char *>(&bitsPerSample), 2)) {
         spdlog::error("Invalid bits per sample!");
         return;
     }
@@ -133,7 +129,7 @@ void AudioLoader::LoadFileHeader(const AudioType& type) {
     //
     // "data" header
     //
-    if (!file.read(data, 4)) {
+    if (!Read(data, 4)) {
         spdlog::error("Invalid data header!");
         return;
     }
@@ -143,17 +139,19 @@ void AudioLoader::LoadFileHeader(const AudioType& type) {
         return;
     }
 
-    if (!file.read(reinterpret_cast<char *>(&subChunkSize), 4)) {
+    if (!Read(reinterpret_cast<char *>(&subChunkSize), 4)) {
         spdlog::error("Invalid SubChunk size!");
         return;
     }
 
-    if (file.eof()) {
+    if (position >= file.GetSize()) {
         spdlog::error("Reached end of file!");
         return;
     }
 
-    dataStartSectionPointer = file.tellg();
+    dataStartSectionPointer = position;
+    // truncated files are played as far as they go
+    subChunkSize = (ALsizei)std::min((size_t)subChunkSize, file.GetSize() - position);
 
     if (type == AudioType::Positional) {
         if (bitsPerSample == 8)
@@ -179,22 +177,21 @@ void AudioLoader::LoadFileHeader(const AudioType& type) {
  * Loads first chunks of data.
  */
 const bool AudioLoader::FillBuffersQueue() {
-    file.seekg(dataStartSectionPointer);
+    position = dataStartSectionPointer;
     samplesSizeToLoad = subChunkSize;
     bool isEndOfFile = false;
 
     for (int i = 0; i < NUM_BUFFERS; ++i) {
         if (samplesSizeToLoad < BUFFER_SIZE) {
-            file.read(reinterpret_cast<char *>(samples), samplesSizeToLoad);
-            file.seekg(dataStartSectionPointer);
-            alBufferData(buffers[i], format, samples, samplesSizeToLoad, sampleRate);
+            alBufferData(buffers[i], format, file.GetData() + position, samplesSizeToLoad, sampleRate);
+            position = dataStartSectionPointer;
             alSourceQueueBuffers(source, 1, &buffers[i]);
             samplesSizeToLoad = subChunkSize;
             isEndOfFile = true;
             break;
         } else {
-            file.read(reinterpret_cast<char *>(samples), BUFFER_SIZE);
-            alBufferData(buffers[i], format, samples, BUFFER_SIZE, sampleRate);
+            alBufferData(buffers[i], format, file.GetData() + position, BUFFER_SIZE, sampleRate);
+            position += BUFFER_SIZE;
             alSourceQueueBuffers(source, 1, &buffers[i]);
             samplesSizeToLoad -= BUFFER_SIZE;
         }
@@ -217,16 +214,15 @@ const bool AudioLoader::FillProcessedBuffers(const ALuint &processedBuffers) {
         alSourceUnqueueBuffers(source, 1, &bufferId);
 
         if (samplesSizeToLoad < BUFFER_SIZE) {
-            file.read(reinterpret_cast<char *>(samples), samplesSizeToLoad);
-            file.seekg(dataStartSectionPointer);
-            alBufferData(bufferId, format, samples, samplesSizeToLoad, sampleRate);
+            alBufferData(bufferId, format, file.GetData() + position, samplesSizeToLoad, sampleRate);
+            position = dataStartSectionPointer;
             alSourceQueueBuffers(source, 1, &bufferId);
             samplesSizeToLoad = subChunkSize;
             isEndOfFile = true;
             break;
         } else {
-            file.read(reinterpret_cast<char *>(samples), BUFFER_SIZE);
-            alBufferData(bufferId, format, samples, BUFFER_SIZE, sampleRate);
+            alBufferData(bufferId, format, file.GetData() + position, BUFFER_SIZE, sampleRate);
+            position += BUFFER_SIZE;
             alSourceQueueBuffers(source, 1, &bufferId);
             samplesSizeToLoad -= BUFFER_SIZE;
         }
@@ -240,6 +236,13 @@ const bool AudioLoader::FillProcessedBuffers(const ALuint &processedBuffers) {
  * Closes audio file.
  */
 void AudioLoader::CloseFile() {
-    if (file.is_open())
-        file.close();
+    file.Close();
+    position = 0;
+}
+
+bool AudioLoader::Read(void* destination, size_t size) {
+    if (position + size > file.GetSize()) return false;
+    std::memcpy(destination, file.GetData() + position, size);
+    position += size;
+    return true;
 }
@@ -5,11 +5,16 @@
 #include "EngineManagers/AnimationManager.h"
 #include "GameObjectsAndPrefabs/GameObject.h"
 #include "LowLevelClasses/Bone.h"
+#include "LowLevelClasses/AnimationClip.h"
+#include "LowLevelClasses/AssimpFileSystem.h"
+#include "LowLevelClasses/RenderCommandBuffer.h"
 #include "Other/FrustumCulling.h"
 
 #include "assimp/scene.h"
 #include "assimp/Importer.hpp"
 #include "assimp/postprocess.h"
+#include "spdlog/spdlog.h"
+#include <chrono>
 #include <filesystem>
 #include <utility>
 #include <unordered_set>
@@ -26,7 +31,7 @@ Animator::Animator(const std::shared_ptr<GameObject> &parent, int id) : Drawable
 }
 
 Animator::~Animator() {
-    model.reset();
+    model.Reset();
 }
 
 void Animator::LoadAnimationModel(const std::string& path) {
@@ -35,21 +40,19 @@ void Animator::LoadAnimationModel(const std::string& path) {
     const int hash = Utilities::Hash(newPath);
 
     if (!animationModels.contains(hash)) {
-        animationModels.insert({hash, std::make_shared<AnimationModel>( normalizedPath.string(),
-                                                               RendererManager::GetInstance()->shader)});
+        // kept from an earlier scene if it used the model too
+        animationModels.insert({hash, AssetManager::GetInstance()->Load<AnimationModel>(newPath, [&normalizedPath] {
+            return std::make_shared<AnimationModel>(normalizedPath.string(), RendererManager::GetInstance()->shader);
+        })});
     }
 
     model = animationModels.at(hash);
 
-    parent->bounds = FrustumCulling::GenerateAABB(model);
+    parent->bounds = FrustumCulling::GenerateAABB(model.GetShared());
 }
 
 void Animator::LoadAnimation(const std::string& path)
 {
-    if (animationModels.empty()) LoadModel(path);
-
-    auto model = animationModels.begin()->second;
-
     std::string newPath = "res/models/" + path;
     std::filesystem::path normalizedPath(newPath);
 
@@ -57,17 +60,48 @@ void Animator::LoadAnimation(const std::string& path)
 
     if (animations.contains(hash)) return;
 
-    Assimp::Importer importer;
-    const aiScene* scene = importer.ReadFile(newPath, aiProcess_LimitBoneWeights);
-    assert(scene && scene->mRootNode);
-    for (int i = 0; i < scene->mNumAnimations; i++){
-        aiAnimation* animation = scene->mAnimations[i];
+    // an animation doesn't depend on the model it was read with once loaded, an earlier scene's one is used as it is
+    AssetHandle<Animation> cached = AssetManager::GetInstance()->Acquire<Animation>(newPath);
+    if (cached) {
+        animations.insert({hash, std::move(cached)});
+        return;
+    }
 
-        animations.insert({hash, Animation(path, (float)animation->mDuration, (int)animation->mTicksPerSecond)});
+    if (animationModels.empty()) LoadModel(path);
 
-        animations.at(hash).ReadHierarchyData(animations.at(hash).rootNode, scene->mRootNode);
-        animations.at(hash).ReadMissingBones(animation, model);
+    auto model = animationModels.begin()->second.GetShared();
+
+    auto start = std::chrono::high_resolution_clock::now();
+    // keys are decoded straight from the cooked clip, Assimp only runs when there is none or the source changed
+    std::shared_ptr<AnimationClip> clip = AnimationClip::Load(newPath);
+    if (clip == nullptr) {
+        Assimp::Importer importer;
+        importer.SetIOHandler(new AssimpFileSystem());
+        const aiScene* scene = importer.ReadFile(newPath, aiProcess_LimitBoneWeights);
+        assert(scene && scene->mRootNode);
+        if (scene == nullptr || scene->mNumAnimations == 0) return;
+        float importTime = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+        aiAnimation* animation = scene->mAnimations[0];
+        AnimationClipCooker cooker;
+        cooker.AddHierarchy(scene->mRootNode);
+        for (unsigned int i = 0; i < animation->mNumChannels; i++) {
+            cooker.AddTrack(animation->mChannels[i], (float)animation->mDuration);
+        }
+        clip = cooker.Cook(newPath, (float)animation->mDuration, (int)animation->mTicksPerSecond, importTime);
+        if (clip == nullptr) return;
     }
+
+    const CookedClipHeader& header = clip->GetHeader();
+    auto animation = std::make_shared<Animation>(path, header.duration, header.ticksPerSecond);
+    animation->ReadHierarchyData(animation->rootNode, *clip, 0);
+    animation->ReadMissingBones(clip, model);
+    animations.insert({hash, AssetManager::GetInstance()->Add<Animation>(newPath, animation)});
+
+    float loadTime = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    spdlog::info("Animation " + path + " loaded in " + std::to_string(loadTime) + " ms, " +
+                 std::to_string(clip->GetSize() / 1000) + " Kb (Assimp import took " + std::to_string(header.sourceImportTime) +
+                 " ms, " + std::to_string(header.sourceKeysMemory / 1000) + " Kb of keys)");
 }
 
 void Animator::SetAnimation(const std::string &name) {
@@ -77,7 +111,7 @@ void Animator::SetAnimation(const std::string &name) {
     previousAnimationTime = currentTime;
 	speed = 1;
 
-    currentAnimation = animations.at(Utilities::Hash(name));
+    currentAnimation = *animations.at(Utilities::Hash(name));
 
     currentTime = -fmod(blendingTimeInSeconds * (float)currentAnimation.GetTicksPerSecond(), currentAnimation.GetDuration());
     blendingTimeInTicks = currentTime;
@@ -88,7 +122,7 @@ void Animator::SetAnimation(const std::string &name) {
         currentTime = 0;
     }
 
-    currentAnimation.Recalculate(model);
+    currentAnimation.Recalculate(model.GetShared());
 }
 
 void Animator::Update() {
@@ -106,41 +140,60 @@ void Animator::Update() {
 }
 
 void Animator::Draw() {
-    if(model == nullptr) return;
+    if(!model) return;
 
     auto shader = RendererManager::GetInstance()->shader;
 
-    shader->Activate();
-    for (int i = 0; i < BONE_NUMBER; ++i)
-        shader->SetMat4("finalBonesMatrices[" + std::to_string(i) + "]", finalBoneMatrices[i]);
+    RendererManager::GetInstance()->BindShader(shader);
+    shader->SetInt("bonesOffset", bonesOffset);
     shader->SetMat4("model", parent->transform->GetModelMatrix());
-    shader->SetVec2("texStrech", textScale);
-    shader->SetVec3("material.color", material.color);
-    shader->SetFloat("material.shininess", material.shininess);
-    shader->SetFloat("material.reflection", material.reflection);
-    shader->SetFloat("material.refraction", material.refraction);
-    shader->SetBool("isAnimated", true);
+    RendererManager::GetInstance()->ApplyMaterial(shader, material, textScale, true);
 
     model->Draw();
 }
 
 void Animator::Draw(std::shared_ptr<Shader> shader) {
-    if(model == nullptr) return;
+    if(!model) return;
 
-    shader->Activate();
-    for (int i = 0; i < BONE_NUMBER; ++i)
-        shader->SetMat4("finalBonesMatrices[" + std::to_string(i) + "]", finalBoneMatrices[i]);
+    RendererManager::GetInstance()->BindShader(shader);
+    shader->SetInt("bonesOffset", bonesOffset);
     shader->SetMat4("model", parent->transform->GetModelMatrix());
-    shader->SetVec2("texStrech", textScale);
-    shader->SetVec3("material.color", material.color);
-    shader->SetFloat("material.shininess", material.shininess);
-    shader->SetFloat("material.reflection", material.reflection);
-    shader->SetFloat("material.refraction", material.refraction);
-    shader->SetBool("isAnimated", true);
+    RendererManager::GetInstance()->ApplyMaterial(shader, material, textScale, true);
 
     model->Draw(shader);
 }
 
+void Animator::Record(RenderCommandBuffer& buffer) {
+    if(!model) return;
+
+    RenderCommand command{};
+    command.type = RenderCommandType::Mesh;
+    command.drawShadows = drawShadows;
+    command.isStatic = isStatic;
+    command.isAnimated = true;
+    command.model = parent->transform->GetModelMatrix();
+    command.material = material;
+    command.textScale = textScale;
+    command.bonesOffset = bonesOffset;
+    buffer.AddModel(model.Get(), command);
+}
+
+uint64_t Animator::GetSortKey(const glm::vec3& cameraPosition) {
+    if(!model) return Drawable::GetSortKey(cameraPosition);
+
+    // color and texture stretch are per instance values, they can't split instances of one model
+    Material sharedMaterial = {glm::vec3(1.0f), material.shininess, material.reflection, material.refraction};
+
+    return RendererManager::CreateSortKey(RenderPass::Opaque, RendererManager::GetInstance()->shader->GetShader(),
+                                          RendererManager::CreateMaterialKey(sharedMaterial, glm::vec2(1.0f), true),
+                                          model->GetTextureSetKey(), model->GetMeshKey(),
+                                          glm::distance(cameraPosition, parent->transform->GetGlobalPosition()));
+}
+
+Model* Animator::GetInstancingModel() {
+    return model.Get();
+}
+
 
 void Animator::UpdateAnimation(float deltaTime) {
     currentTime += (float)currentAnimation.GetTicksPerSecond() * deltaTime * speed;
@@ -223,12 +276,13 @@ void Animator::LoadModel(const std::string &path) {
     int hash = Utilities::Hash(newPath);
 
     if (!animationModels.contains(hash)) {
-        animationModels.insert({hash, std::make_shared<AnimationModel>( normalizedPath.string(),
-                                                                        RendererManager::GetInstance()->shader)});
+        animationModels.insert({hash, AssetManager::GetInstance()->Load<AnimationModel>(newPath, [&normalizedPath] {
+            return std::make_shared<AnimationModel>(normalizedPath.string(), RendererManager::GetInstance()->shader);
+        })});
     }
 }
 
 void Animator::OnDestroy() {
-    model.reset();
+    model.Reset();
     Component::OnDestroy();
 }
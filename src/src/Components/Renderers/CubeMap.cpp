@@ -4,7 +4,7 @@
 
 #include "Components/Renderers/CubeMap.h"
 #include "glad/glad.h"
-#include "stb_image.h"
+#include "EngineManagers/TextureManager.h"
 #include "Shapes/Cube.h"
 #include "GloomEngine.h"
 #include "EngineManagers/RendererManager.h"
@@ -21,7 +21,7 @@ CubeMap::CubeMap(const std::shared_ptr<GameObject> &parent, int id) : Drawable(p
 }
 
 CubeMap::~CubeMap() {
-    glDeleteTextures(1, &textureID);
+    TextureManager::GetInstance()->Release(textureID);
 }
 
 /**
@@ -37,36 +37,8 @@ CubeMap::~CubeMap() {
  */
 
 void CubeMap::LoadTextures(const std::string& basePath) {
-    stbi_set_flip_vertically_on_load(false);
-    glGenTextures(1, &textureID);
-    glBindTexture(GL_TEXTURE_CUBE_MAP, textureID);
-
-    int width, height, nrChannels;
-    for (unsigned int i = 0; i < 6; i++)
-    {
-        auto path = BASE_PATH + basePath + std::to_string(i) + ".jpg";
-
-        unsigned char *data = stbi_load(path.c_str(),
-                                        &width, &height,
-                                        &nrChannels, 0);
-        if (data)
-        {
-            glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i,
-                         0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data
-            );
-            stbi_image_free(data);
-        }
-        else
-        {
-            printf("Cubemap texture failed to load at path: %s\n", path.c_str());
-            stbi_image_free(data);
-        }
-    }
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+    if (textureID != 0) TextureManager::GetInstance()->Release(textureID);
+    textureID = TextureManager::GetInstance()->LoadCubeMap(BASE_PATH + basePath);
 
     auto shader = RendererManager::GetInstance()->cubeMapShader;
     shader->Activate();
@@ -75,7 +47,6 @@ void CubeMap::LoadTextures(const std::string& basePath) {
     shader = RendererManager::GetInstance()->shader;
     shader->Activate();
     shader->SetInt("skybox", 5);
-    stbi_set_flip_vertically_on_load(true);
 }
 
 void CubeMap::Update() {
@@ -90,15 +61,15 @@ void CubeMap::Draw() {
     // change depth function so depth test passes
     // when values are equal to depth buffer's content
     glDepthFunc(GL_LEQUAL);
-    shader->Activate();
+    RendererManager::GetInstance()->BindShader(shader);
 
-    glBindVertexArray(skyboxMesh->vao);
     glActiveTexture(GL_TEXTURE5);
     glBindTexture(GL_TEXTURE_CUBE_MAP, textureID);
 
-    glBindVertexArray(skyboxMesh->vao);
+    RendererManager::GetInstance()->BindVertexArray(skyboxMesh->vao);
     glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, nullptr);
-    glBindVertexArray(0);
+    ++RendererManager::GetInstance()->requestedStats.drawCalls;
+    ++RendererManager::GetInstance()->issuedStats.drawCalls;
 
     glDepthFunc(GL_LESS); // set depth function back to default
 }
@@ -106,6 +77,13 @@ void CubeMap::Draw() {
 // leave it empty or else it's gonna be drawn in shadow map
 void CubeMap::Draw(std::shared_ptr<Shader> shader) {}
 
+// skybox is drawn after every opaque object so most of its fragments fail the depth test
+uint64_t CubeMap::GetSortKey(const glm::vec3& cameraPosition) {
+    return RendererManager::CreateSortKey(RenderPass::Skybox,
+                                          RendererManager::GetInstance()->cubeMapShader->GetShader(),
+                                          0, textureID, skyboxMesh->vao, 0.0f);
+}
+
 void CubeMap::OnDestroy() {
     skyboxMesh.reset();
     Component::OnDestroy();
@@ -4,8 +4,10 @@
 
 #include "Components/Renderers/Drawable.h"
 #include "EngineManagers/RendererManager.h"
+#include "LowLevelClasses/Shader.h"
 #include "Other/FrustumCulling.h"
 #include "GameObjectsAndPrefabs/GameObject.h"
+#include "LowLevelClasses/RenderCommandBuffer.h"
 
 Drawable::Drawable(const std::shared_ptr<GameObject> &parent, int id) : Component(parent, id) {}
 
@@ -20,3 +22,36 @@ void Drawable::AddToDraw() {
     RendererManager::GetInstance()->AddToDrawBuffer(std::dynamic_pointer_cast<Drawable>(shared_from_this()));
 }
 
+
+/**
+ * @annotation
+ * Key used by RendererManager to order the draw buffer, override it to group drawables sharing GL state.
+ * @param cameraPosition - global position of the active camera
+ */
+uint64_t Drawable::GetSortKey(const glm::vec3& cameraPosition) {
+    return RendererManager::CreateSortKey(RenderPass::Opaque, RendererManager::GetInstance()->shader->GetShader(),
+                                          RendererManager::CreateMaterialKey(material, textScale, false), 0, 0,
+                                          glm::distance(cameraPosition, parent->transform->GetGlobalPosition()));
+}
+
+/**
+ * @annotation
+ * Records draws of this drawable for RendererManager to replay, by default Draw is called during replay.
+ * Override it to resolve uniforms while recording.
+ */
+void Drawable::Record(RenderCommandBuffer& buffer) {
+    RenderCommand command{};
+    command.type = RenderCommandType::Drawable;
+    command.drawShadows = drawShadows;
+    command.isStatic = isStatic;
+    command.drawable = this;
+    buffer.Add(command);
+}
+
+Model* Drawable::GetInstancingModel() {
+    return nullptr;
+}
+
+glm::mat4* Drawable::GetFinalBoneMatrices() {
+    return nullptr;
+}
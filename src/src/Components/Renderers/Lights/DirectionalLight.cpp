@@ -25,7 +25,6 @@ void DirectionalLight::OnCreate() {
     }
     if (!isAdded) RendererManager::GetInstance()->directionalLights.insert(
             {number,std::dynamic_pointer_cast<DirectionalLight>(shared_from_this())});
-    RendererManager::GetInstance()->UpdateLight(id);
     Component::OnCreate();
 }
 
@@ -75,6 +74,5 @@ void DirectionalLight::SetColor(const glm::vec3 &color) {
 }
 
 void DirectionalLight::OnUpdate() {
-    RendererManager::GetInstance()->UpdateLight(id);
     Component::OnUpdate();
 }
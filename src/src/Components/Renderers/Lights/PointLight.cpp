@@ -28,7 +28,6 @@ void PointLight::OnCreate() {
     }
     if (!isAdded) RendererManager::GetInstance()->pointLights.insert(
             {number, std::dynamic_pointer_cast<PointLight>(shared_from_this())});
-    RendererManager::GetInstance()->UpdateLight(id);
     Component::OnCreate();
 }
 
@@ -108,6 +107,5 @@ void PointLight::SetColor(const glm::vec3 &color) {
 }
 
 void PointLight::OnUpdate() {
-    RendererManager::GetInstance()->UpdateLight(id);
     Component::OnUpdate();
 }
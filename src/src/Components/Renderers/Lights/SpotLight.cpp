@@ -30,7 +30,6 @@ void SpotLight::OnCreate() {
     }
     if (!isAdded) RendererManager::GetInstance()->spotLights.insert(
             {number, std::dynamic_pointer_cast<SpotLight>(shared_from_this())});
-    RendererManager::GetInstance()->UpdateLight(id);
     Component::OnCreate();
 }
 
@@ -130,7 +129,6 @@ void SpotLight::SetColor(const glm::vec3 &color) {
 }
 
 void SpotLight::OnUpdate() {
-    RendererManager::GetInstance()->UpdateLight(id);
     Component::OnUpdate();
 }
 
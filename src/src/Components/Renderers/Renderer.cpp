@@ -4,6 +4,7 @@
 #include "EngineManagers/RendererManager.h"
 #include "GameObjectsAndPrefabs/GameObject.h"
 #include "LowLevelClasses/StaticModel.h"
+#include "LowLevelClasses/RenderCommandBuffer.h"
 #include "Other/FrustumCulling.h"
 
 #ifdef DEBUG
@@ -26,42 +27,63 @@ void Renderer::Update() {
 
 
 void Renderer::OnDestroy() {
-    model.reset();
+    model.Reset();
     Component::OnDestroy();
 }
 
 void Renderer::Draw() {
-    if(model == nullptr) return;
+    if(!model) return;
 
     auto shader = RendererManager::GetInstance()->shader;
 
-    shader->Activate();
+    RendererManager::GetInstance()->BindShader(shader);
     shader->SetMat4("model", parent->transform->GetModelMatrix());
-    shader->SetVec2("texStrech", textScale);
-    shader->SetVec3("material.color", material.color);
-    shader->SetFloat("material.shininess", material.shininess);
-    shader->SetFloat("material.reflection", material.reflection);
-    shader->SetFloat("material.refraction", material.refraction);
-    shader->SetBool("isAnimated", false);
+    RendererManager::GetInstance()->ApplyMaterial(shader, material, textScale, false);
 
     model->Draw();
 }
 
 void Renderer::Draw(std::shared_ptr<Shader> shader) {
-    if(model == nullptr) return;
+    if(!model) return;
 
-    shader->Activate();
+    RendererManager::GetInstance()->BindShader(shader);
     shader->SetMat4("model", parent->transform->GetModelMatrix());
-    shader->SetVec2("texStrech", textScale);
-    shader->SetVec3("material.color", material.color);
-    shader->SetFloat("material.shininess", material.shininess);
-    shader->SetFloat("material.reflection", material.reflection);
-    shader->SetFloat("material.refraction", material.refraction);
-    shader->SetBool("isAnimated", false);
+    RendererManager::GetInstance()->ApplyMaterial(shader, material, textScale, false);
 
     model->Draw(shader);
 }
 
+void Renderer::Record(RenderCommandBuffer& buffer) {
+    if(!model) return;
+
+    RenderCommand command{};
+    command.type = RenderCommandType::Mesh;
+    command.drawShadows = drawShadows;
+    command.isStatic = isStatic;
+    command.isAnimated = false;
+    command.model = parent->transform->GetModelMatrix();
+    command.material = material;
+    command.textScale = textScale;
+    command.bonesOffset = bonesOffset;
+    buffer.AddModel(model.Get(), command);
+}
+
+uint64_t Renderer::GetSortKey(const glm::vec3& cameraPosition) {
+    if(!model) return Drawable::GetSortKey(cameraPosition);
+
+    // color and texture stretch are per instance values, they can't split instances of one model
+    Material sharedMaterial = {glm::vec3(1.0f), material.shininess, material.reflection, material.refraction};
+
+    return RendererManager::CreateSortKey(RenderPass::Opaque, RendererManager::GetInstance()->shader->GetShader(),
+                                          RendererManager::CreateMaterialKey(sharedMaterial, glm::vec2(1.0f), false),
+                                          model->GetTextureSetKey(), model->GetMeshKey(),
+                                          glm::distance(cameraPosition, parent->transform->GetGlobalPosition()));
+}
+
+Model* Renderer::GetInstancingModel() {
+    return model.Get();
+}
+
 /**
  * @attention Needs to be called after renderer's constructor
  * @param newPath - relative path starting in res/models/
@@ -73,11 +95,14 @@ void Renderer::LoadModel(std::string path) {
     int hash = Utilities::Hash(newPath);
 
     if (!models.contains(hash)) {
-        models.insert({hash, std::make_shared<StaticModel>(normalizedPath.string(), RendererManager::GetInstance()->shader, GL_TRIANGLES)});
+        // kept from an earlier scene if it used the model too
+        models.insert({hash, AssetManager::GetInstance()->Load<StaticModel>(newPath, [&normalizedPath] {
+            return std::make_shared<StaticModel>(normalizedPath.string(), RendererManager::GetInstance()->shader, GL_TRIANGLES);
+        })});
     }
 
     model = models.at(hash);
 
-    parent->bounds = FrustumCulling::GenerateAABB(model);
+    parent->bounds = FrustumCulling::GenerateAABB(model.GetShared());
 }
 
@@ -4,7 +4,6 @@
 #include "Components/UI/Button.h"
 #include "Components/UI/Image.h"
 #include "Components/Scripts/Menus/PauseMenu.h"
-#include "EngineManagers/PostProcessingManager.h"
 #include "Components/Audio/AudioListener.h"
 #include "Components/Scripts/Player/PlayerManager.h"
 #include "EngineManagers/ShadowManager.h"
@@ -173,12 +172,10 @@ void OptionsMenu::ChangeValue(float x) {
                 optionManager->width = 1440;
                 optionManager->height = 810;
                 glfwSetWindowPos(GloomEngine::GetInstance()->window, mode->width / 2 - optionManager->width / 2, mode->height / 2 - optionManager->height / 2);
-                PostProcessingManager::GetInstance()->WindowResize();
             } else if (optionManager->width == 1440) {
                 optionManager->width = 960;
                 optionManager->height = 540;
                 glfwSetWindowPos(GloomEngine::GetInstance()->window, mode->width / 2 - optionManager->width / 2, mode->height / 2 - optionManager->height / 2);
-                PostProcessingManager::GetInstance()->WindowResize();
             } else return;
             windowResolutionIterator--;
         } else {
@@ -186,12 +183,10 @@ void OptionsMenu::ChangeValue(float x) {
                 optionManager->width = 1440;
                 optionManager->height = 810;
                 glfwSetWindowPos(GloomEngine::GetInstance()->window, mode->width / 2 - optionManager->width / 2, mode->height / 2 - optionManager->height / 2);
-                PostProcessingManager::GetInstance()->WindowResize();
             } else if (optionManager->width == 1440) {
                 optionManager->width = 1920;
                 optionManager->height = 1080;
                 glfwSetWindowPos(GloomEngine::GetInstance()->window, mode->width / 2 - optionManager->width / 2, mode->height / 2 - optionManager->height / 2);
-                PostProcessingManager::GetInstance()->WindowResize();
             } else return;
             windowResolutionIterator++;
         }
@@ -214,7 +209,6 @@ void OptionsMenu::ChangeValue(float x) {
         windowResolutionButtons[1]->isActive = true;
         if (windowResolutionIterator == 0) windowResolutionButtons[0]->isActive = false;
         if (windowResolutionIterator == 2) windowResolutionButtons[1]->isActive = false;
-        PostProcessingManager::GetInstance()->WindowResize();
         windowResolutionValue->ChangeText(windowResolutionValues[windowResolutionIterator]);
         activeButtonChangeSound->ForcePlaySound();
     }
@@ -235,7 +229,6 @@ void OptionsMenu::ChangeValue(float x) {
             windowResolutionIterator = 2;
             optionManager->width = 1920;
             optionManager->height = 1080;
-            PostProcessingManager::GetInstance()->WindowResize();
             glfwSetWindowMonitor(GloomEngine::GetInstance()->window, glfwGetPrimaryMonitor(), mode->width / 2 - optionManager->width / 2, mode->height / 2 - optionManager->height / 2, mode->width, mode->height, mode->refreshRate);
             windowFullScreenIterator++;
             optionManager->fullScreen = true;
@@ -275,24 +268,7 @@ void OptionsMenu::ChangeValue(float x) {
 }
 
 void OptionsMenu::ChangeShadowResolution() {
-    auto shadowManager = ShadowManager::GetInstance();
-    glGenFramebuffers(1, &shadowManager->depthMapFBO);
-    glGenTextures(1, &shadowManager->depthMap);
-    glBindTexture(GL_TEXTURE_2D, shadowManager->depthMap);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, shadowManager->shadowResolution, shadowManager->shadowResolution, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
-    float borderColor[] = { 1.0, 1.0, 1.0, 1.0 };
-    glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
-    glBindFramebuffer(GL_FRAMEBUFFER, shadowManager->depthMapFBO);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, shadowManager->depthMap, 0);
-    glDrawBuffer(GL_NONE);
-    glReadBuffer(GL_NONE);
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    RendererManager::GetInstance()->shader->Activate();
-    RendererManager::GetInstance()->shader->SetInt("shadowMap", shadowManager->depthMap);
+    ShadowManager::GetInstance()->CreateShadowMaps();
 }
 
 void OptionsMenu::CancelSettings() {
@@ -339,7 +315,6 @@ void OptionsMenu::CancelSettings() {
     if (windowFullScreenIterator == 0) windowFullScreenButtons[0]->isActive = false;
     if (windowFullScreenIterator == 1) windowFullScreenButtons[1]->isActive = false;
     windowFullScreenValue->ChangeText(windowFullScreenValues[windowFullScreenIterator]);
-    PostProcessingManager::GetInstance()->WindowResize();
 
 //     previousShadowResolution
     ShadowManager::GetInstance()->shadowResolution = (int)previousShadowResolution;
@@ -12,7 +12,7 @@ ShopTrigger::~ShopTrigger() = default;
 
 void ShopTrigger::Start() {
     door = GameObject::Instantiate("Door", parent->parent);
-    door->AddComponent<Renderer>()->LoadModel("Buildings/Normal/drzwi.obj");
+    door->AddComponent<Renderer>()->LoadModel(doorModel);
     door->transform->SetLocalPosition(glm::vec3(-3, 0, 3.5f));
     shopMenu = GloomEngine::GetInstance()->FindGameObjectWithName("ShopMenu")->GetComponent<ShopMenu>();
     Component::Start();
@@ -89,7 +89,7 @@ void Shopkeeper::Start() {
     shopkeeperModel->transform->SetLocalScale({0.5, 0.5, 0.5});
     auto animatorObject = GameObject::Instantiate("ShopkeeperAnimator", shopkeeperModel);
     auto animator = animatorObject->AddComponent<Animator>();
-    animator->LoadAnimationModel("Crowd/Shopkeeper/Shopkeeper.dae");
+    animator->LoadAnimationModel(animationModel);
     animator->SetAnimation("CrowdAnimations/Idle3.dae");
     auto shopkeeperDialogue = GameObject::Instantiate("ShopkeeperDialogue", shopkeeperModel);
     texts.push_back({{"Hi! Welcome to Rhythmtown."},
@@ -65,7 +65,7 @@ void PlayerManager::Awake() {
     auto animatorObject = GameObject::Instantiate("Animator", parent);
     animatorObject->transform->SetLocalRotation({0, 180, 0});
     animator = animatorObject->AddComponent<Animator>();
-    animator->LoadAnimationModel("MainHero/MainHeroIdle.dae");
+    animator->LoadAnimationModel(animationModel);
     animator->SetAnimation("MainHero/MainHeroIdle.dae");
 
     // Set up Collider
@@ -309,7 +309,7 @@ void PlayerManager::OnSessionToggle() {
         session->Stop();
         session.reset();
         AIManager::GetInstance()->NotifyPlayerStopsPlaying();
-        animator->LoadAnimationModel("MainHero/MainHeroIdle.dae");
+        animator->LoadAnimationModel(animationModel);
         animator->SetAnimation("MainHero/MainHeroIdle.dae");
         animator->blend = true;
         // Needed to save session toggles
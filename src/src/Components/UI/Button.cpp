@@ -1,199 +1,66 @@
 #include <iostream>
 #include "Components/UI/Button.h"
-#include "LowLevelClasses/Mesh.h"
 #include "EngineManagers/UIManager.h"
-#include "stb_image.h"
-#include "LowLevelClasses/Mesh.h"
+#include "EngineManagers/FontManager.h"
+#include "LowLevelClasses/GlyphAtlas.h"
+#include "LowLevelClasses/SpriteBatch.h"
 #include "GameObjectsAndPrefabs/GameObject.h"
 
 #ifdef DEBUG
 #include <tracy/Tracy.hpp>
 #endif
 
-#define BASE_PATH_FONT "res/fonts/"
-#define BASE_PATH_TEXTURE "res/textures/"
-
 Button::Button(const std::shared_ptr<GameObject> &parent, int id) : UIComponent(parent, id) {}
 
-std::shared_ptr<Mesh> Button::CreateMesh(int x, int y, int width, int height) {
-    std::vector<Vertex> vertices;
-    std::vector<unsigned int> indices = {0, 1, 3,
-                                         0, 2, 3};
-    std::vector<Texture> textures;
-
-    Vertex vertex1, vertex2, vertex3, vertex4;
-    // left bottom
-    vertex1.position = glm::vec3((float)x/960-1, (float)y/540-1, z);
-    vertex1.texCoords = glm::vec2(0.0f, 0.0f);
-    // left top
-    vertex2.position = glm::vec3((float)x/960-1, (float)y/540-1 + (float)height/540, z);
-    vertex2.texCoords = glm::vec2(0.0f, 1.0f);
-    // right bottom
-    vertex3.position = glm::vec3((float)x/960-1 + (float)width/960, (float)y/540-1, z);
-    vertex3.texCoords = glm::vec2(1.0f, 0.0f);
-    // right top
-    vertex4.position = glm::vec3((float)x/960-1 + (float)width/960, (float)y/540-1 + (float)height/540, z);
-    vertex4.texCoords = glm::vec2(1.0f, 1.0f);
-
-    vertices.push_back(vertex1);
-    vertices.push_back(vertex2);
-    vertices.push_back(vertex3);
-    vertices.push_back(vertex4);
-
-    return std::make_shared<Mesh>(vertices, indices, textures);
+void Button::UpdateCorners(int newX, int newY, int newWidth, int newHeight) {
+    leftBottom = {newX, newY};
+    leftTop = {newX, newY + newHeight};
+    rightBottom = {newX + newWidth, newY};
+    rightTop = {newX + newWidth, newY + newHeight};
 }
 
 void Button::LoadTexture(int x, int y, const std::string& path, const std::string& pathIsActive, float z) {
-    glGenTextures(1, &textureID);
-    glBindTexture(GL_TEXTURE_2D, textureID);
-    int width, height, nrChannels;
-    std::string file = BASE_PATH_TEXTURE + path;
-    unsigned char* data = stbi_load(file.c_str(), &width, &height, &nrChannels, 0);
-    if (data)
-    {
-        GLenum format;
-        if (nrChannels == 1)
-            format = GL_RED;
-        else if (nrChannels == 3)
-            format = GL_RGB;
-        else if (nrChannels == 4)
-            format = GL_RGBA;
-
-        glBindTexture(GL_TEXTURE_2D, textureID);
-        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, format == GL_RGBA ? GL_CLAMP_TO_EDGE : GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, format == GL_RGBA ? GL_CLAMP_TO_EDGE : GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
+    auto spriteAtlas = UIManager::GetInstance()->spriteAtlas;
+    sprite = spriteAtlas->Load(path);
+    if (sprite.texture != 0) {
         this->z = z;
-        this->textureMesh = CreateMesh(x, y, width, height);
-        this->width = width;
-        this->height = height;
+        this->width = sprite.width;
+        this->height = sprite.height;
         this->x = x;
         this->y = y;
+        UpdateCorners(x, y, width, height);
         parent->transform->SetLocalPosition(glm::vec3(x, y, z));
     }
-    else
-    {
-        std::cout << "Failed to load texture" << std::endl;
-    }
-    stbi_image_free(data);
-    glGenTextures(1, &textureIsActive);
-    glBindTexture(GL_TEXTURE_2D, textureIsActive);
-    file = BASE_PATH_TEXTURE + pathIsActive;
-    data = stbi_load(file.c_str(), &width, &height, &nrChannels, 0);
-    if (data)
-    {
-        GLenum format;
-        if (nrChannels == 1)
-            format = GL_RED;
-        else if (nrChannels == 3)
-            format = GL_RGB;
-        else if (nrChannels == 4)
-            format = GL_RGBA;
-
-        glBindTexture(GL_TEXTURE_2D, textureIsActive);
-        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, format == GL_RGBA ? GL_CLAMP_TO_EDGE : GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, format == GL_RGBA ? GL_CLAMP_TO_EDGE : GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    }
-    else
-    {
-        std::cout << "Failed to load texture" << std::endl;
-    }
-    stbi_image_free(data);
-
-    UIManager::GetInstance()->shader->Activate();
-    UIManager::GetInstance()->shader->SetInt("texture1", 0);
-    UIManager::GetInstance()->shader->SetInt("texture2", 1);
+    spriteIsActive = spriteAtlas->Load(pathIsActive);
 }
 
 void Button::LoadFont(std::string text, FT_UInt fontSize, glm::vec3 color, const std::string &path) {
-    FT_Library ft;
-    if (FT_Init_FreeType(&ft))
-        std::cout << "ERROR::FREETYPE: Could not init FreeType Library" << std::endl;
-    FT_Face face;
-    std::string file = BASE_PATH_FONT + path;
-    if (FT_New_Face(ft, file.c_str(), 0, &face))
-        std::cout << "ERROR::FREETYPE: Failed to load font" << std::endl;
-    FT_Set_Pixel_Sizes(face, 0, fontSize);
-    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-    for (GLubyte c = 0; c < 128; c++)
-    {
-        // Load character glyph
-        if (FT_Load_Char(face, c, FT_LOAD_RENDER))
-        {
-            std::cout << "ERROR::FREETYTPE: Failed to load Glyph" << std::endl;
-            continue;
-        }
-        // Generate texture
-        GLuint texture;
-        glGenTextures(1, &texture);
-        glBindTexture(GL_TEXTURE_2D, texture);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RED, face->glyph->bitmap.width, face->glyph->bitmap.rows, 0, GL_RED, GL_UNSIGNED_BYTE, face->glyph->bitmap.buffer);
-        // Set texture options
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        // Now store character for later use
-        Character character = {
-                texture,
-                glm::ivec2(face->glyph->bitmap.width, face->glyph->bitmap.rows),
-                glm::ivec2(face->glyph->bitmap_left, face->glyph->bitmap_top),
-                static_cast<GLuint>(face->glyph->advance.x)
-        };
-        Characters.insert(std::pair<GLchar, Character>(c, character));
-    }
-    glBindTexture(GL_TEXTURE_2D, 0);
-    FT_Done_Face(face);
-    FT_Done_FreeType(ft);
-
-    this->textMesh = CreateMesh((int)(this->textureMesh->vertices[0].position.x*960.0f)+960, (int)(this->textureMesh->vertices[0].position.y*960.0f)+960, 0, 0);
+    atlas = FontManager::GetInstance()->GetFont(path, fontSize);
     this->text = std::move(text);
     this->textColor = color;
     this->fontSize = fontSize;
-    this->textX = (int)(this->textureMesh->vertices[0].position.x*960.0f)+960;
-    this->textY = (int)(this->textureMesh->vertices[0].position.y*540.0f)+540 + height / 2 - fontSize / 3;
-
-    int lengthX = 0;
-    for (std::string::const_iterator c = this->text.begin(); c != this->text.end(); c++) {
-        lengthX += (Characters[*c].Advance >> 6);
-    }
-    textX += (width - lengthX) / 2;
+    this->textX = (int)leftBottom.x;
+    this->textY = (int)leftBottom.y + height / 2 - fontSize / 3;
+    textX += (width - atlas->GetTextWidth(this->text)) / 2;
 }
 
 void Button::ChangeText(std::string newText) {
     this->text = std::move(newText);
-    this->textX = (int)(this->textureMesh->vertices[0].position.x * 960.0f) + 960;
-    this->textY = (int)(this->textureMesh->vertices[0].position.y * 540.0f) + 540 + height / 2 - fontSize / 3;
+    this->textX = (int)leftBottom.x;
+    this->textY = (int)leftBottom.y + height / 2 - fontSize / 3;
 
-    int lengthX = 0;
-    for (std::string::const_iterator c = this->text.begin(); c != this->text.end(); c++) {
-        lengthX += (Characters[*c].Advance >> 6);
-    }
-    textX += (width - lengthX) / 2;
+    if (atlas != nullptr) textX += (width - atlas->GetTextWidth(this->text)) / 2;
 }
 
 void Button::ChangePosition(int newX, int newY) {
-    textureMesh = CreateMesh(newX, newY, width, height);
+    UpdateCorners(newX, newY, width, height);
     ChangeText(text);
 }
 
 void Button::ChangeZ(float newZ) {
     z = newZ;
 
-    textMesh->vertices[0].position.z = z-0.01f;
-    textMesh->vertices[1].position.z = z-0.01f;
-    textMesh->vertices[2].position.z = z-0.01f;
-    textMesh->vertices[3].position.z = z-0.01f;
-
-    textureMesh = CreateMesh(x, y, width,height);
+    UpdateCorners(x, y, width, height);
 }
 
 void Button::SetPosition(float x2, float y2) {
@@ -203,11 +70,6 @@ void Button::SetPosition(float x2, float y2) {
     rightTop = {x + width*(1-pivot.x)*scale.x, y + height*(1-pivot.y)*scale.y};
     leftTop = {leftBottom.x, rightTop.y};
     rightBottom = {rightTop.x, leftBottom.y};
-    textureMesh->vertices[0].position = glm::vec3(leftBottom.x/960-1, leftBottom.y/540-1, z);
-    textureMesh->vertices[1].position = glm::vec3(leftTop.x/960-1, leftTop.y/540-1, z);
-    textureMesh->vertices[2].position = glm::vec3(rightBottom.x/960-1, rightBottom.y/540-1, z);
-    textureMesh->vertices[3].position = glm::vec3(rightTop.x/960-1, rightTop.y/540-1, z);
-    textureMesh->setupMesh();
     UIComponent::SetPosition(x2, y2);
 }
 
@@ -219,11 +81,6 @@ void Button::SetScale(float newScale) {
     rightTop = {leftBottom.x + width2, leftBottom.y + height2};
     leftTop = {leftBottom.x, rightTop.y};
     rightBottom = {rightTop.x, leftBottom.y};
-    textureMesh->vertices[0].position = glm::vec3(leftBottom.x/960-1, leftBottom.y/540-1, z);
-    textureMesh->vertices[1].position = glm::vec3(leftTop.x/960-1, leftTop.y/540-1, z);
-    textureMesh->vertices[2].position = glm::vec3(rightBottom.x/960-1, rightBottom.y/540-1, z);
-    textureMesh->vertices[3].position = glm::vec3(rightTop.x/960-1, rightTop.y/540-1, z);
-    textureMesh->setupMesh();
     UIComponent::SetScale(newScale);
 }
 
@@ -245,69 +102,13 @@ void Button::Update() {
     UIComponent::Update();
 }
 
-void Button::Draw() {
-    // Render text
-    if (!this->text.empty()) {
-        UIManager::GetInstance()->shader->Activate();
-        UIManager::GetInstance()->shader->SetBool("isText", true);
-        UIManager::GetInstance()->shader->SetVec3("textColor", textColor);
-        glActiveTexture(GL_TEXTURE0);
-        glBindVertexArray(textMesh->vao);
-
-        // Iterate through all characters
-        GLfloat x2 = (float)textX;
-        GLfloat y2 = (float)textY;
-
-        std::string::const_iterator c;
-        for (c = text.begin(); c != text.end(); c++) {
-            Character ch = Characters[*c];
-
-            GLfloat xpos = x2 + ch.Bearing.x;
-            GLfloat ypos = y2 - (ch.Size.y - ch.Bearing.y);
-
-            GLfloat w = ch.Size.x;
-            GLfloat h = ch.Size.y;
-            // Update VBO for each character
-            this->textMesh->vertices[0].position.x = xpos / 960 - 1;
-            this->textMesh->vertices[0].position.y = (ypos + h) / 540 - 1;
-            this->textMesh->vertices[1].position.x = xpos / 960 - 1;
-            this->textMesh->vertices[1].position.y = ypos / 540 - 1;
-            this->textMesh->vertices[2].position.x = (xpos + w) / 960 - 1;
-            this->textMesh->vertices[2].position.y = (ypos + h) / 540 - 1;
-            this->textMesh->vertices[3].position.x = (xpos + w) / 960 - 1;
-            this->textMesh->vertices[3].position.y = ypos / 540 - 1;
-
-            // Render glyph texture over quad
-            glBindTexture(GL_TEXTURE_2D, ch.TextureID);
-            // Update content of VBO memory
-            glBindBuffer(GL_ARRAY_BUFFER, this->textMesh->GetVBO());
-            glBufferSubData(GL_ARRAY_BUFFER, 0, this->textMesh->vertices.size() * sizeof(Vertex),
-                            &this->textMesh->vertices[0]); // Be sure to use glBufferSubData and not glBufferData
-            glBindBuffer(GL_ARRAY_BUFFER, 0);
-            // Render quad
-            glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-            // Now advance cursors for next glyph (note that advance is number of 1/64 pixels)
-            x2 += (ch.Advance >> 6); // Bitshift by 6 to get value in pixels (2^6 = 64 (divide amount of 1/64th pixels by 64 to get amount of pixels))
-        }
-        glBindVertexArray(0);
-        glBindTexture(GL_TEXTURE_2D, 0);
+// text is slightly in front of the texture
+void Button::AddQuads(SpriteBatch& batch) {
+    if (atlas != nullptr && !text.empty()) {
+        batch.AddText(*atlas, text, (float)textX, (float)textY, z - 0.01f, textColor);
     }
-
-    // Render texture
-    UIManager::GetInstance()->shader->Activate();
-    UIManager::GetInstance()->shader->SetBool("isText", false);
-    glActiveTexture(GL_TEXTURE0);
-	UIManager::GetInstance()->shader->SetInt("texture1", 0);
-    UIManager::GetInstance()->shader->SetVec3("color", color);
-    if(isActive) {
-        glBindTexture(GL_TEXTURE_2D, textureIsActive);
-    } else {
-        glBindTexture(GL_TEXTURE_2D, textureID);
-    }
-    glBindVertexArray(textureMesh->vao);
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0);
-    glActiveTexture(GL_TEXTURE0);
+    glm::vec2 corners[4] = {leftBottom, leftTop, rightBottom, rightTop};
+    batch.AddSprite(isActive ? spriteIsActive : sprite, corners, glm::vec4(color, 1.0f), z);
 }
 
 int Button::GetWidth() {
@@ -319,12 +120,9 @@ int Button::GetHeight() {
 }
 
 void Button::OnDestroy() {
-    glDeleteTextures(1, &textureID);
-    for (auto&& character : Characters) {
-        glDeleteTextures(1, &character.second.TextureID);
-    }
-    textureMesh.reset();
-    textMesh.reset();
+    SpriteAtlas::Release(sprite);
+    SpriteAtlas::Release(spriteIsActive);
+    atlas.reset();
     left.reset();
     right.reset();
     up.reset();
@@ -4,6 +4,8 @@
 
 #include "Components/UI/UIComponent.h"
 #include "EngineManagers/UIManager.h"
+#include "LowLevelClasses/SpriteBatch.h"
+#include "LowLevelClasses/SpriteAtlas.h"
 
 UIComponent::UIComponent(const std::shared_ptr<GameObject> &parent, int id) : Component(parent, id) {}
 
@@ -15,6 +17,13 @@ void UIComponent::Update() {
     Component::Update();
 }
 
+void UIComponent::Draw() {
+    auto uiManager = UIManager::GetInstance();
+    uiManager->spriteAtlas->Update();
+    AddQuads(*uiManager->spriteBatch);
+    uiManager->spriteBatch->Draw(uiManager->shader);
+}
+
 void UIComponent::AddToDraw() {
     UIManager::GetInstance()->AddToDrawBuffer(std::dynamic_pointer_cast<UIComponent>(shared_from_this()));
 }
\ No newline at end of file
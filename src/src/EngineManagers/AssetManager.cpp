@@ -0,0 +1,76 @@
+#include "EngineManagers/AssetManager.h"
+
+#include <filesystem>
+
+AssetManager::AssetManager() = default;
+
+AssetManager::~AssetManager() {
+    delete assetManager;
+}
+
+AssetManager* AssetManager::GetInstance() {
+    if (assetManager == nullptr) {
+        assetManager = new AssetManager();
+    }
+    return assetManager;
+}
+
+void AssetManager::AddUser(unsigned int id) {
+    assets.AddUser(id);
+}
+
+void AssetManager::Release(unsigned int id) {
+    assets.Release(id);
+}
+
+void AssetManager::SetMemoryBudget(size_t newMemoryBudget) {
+    assets.SetMemoryBudget(newMemoryBudget);
+}
+
+size_t AssetManager::GetMemory() const {
+    return assets.GetMemory();
+}
+
+size_t AssetManager::GetUnusedMemory() const {
+    return assets.GetUnusedMemory();
+}
+
+size_t AssetManager::GetAssetsCount() const {
+    return assets.GetCount();
+}
+
+unsigned int AssetManager::GetRequestsCount() const {
+    return requestsCount;
+}
+
+unsigned int AssetManager::GetLoadedCount() const {
+    return loadedCount;
+}
+
+unsigned int AssetManager::GetRevivedCount() const {
+    return assets.GetRevivedCount();
+}
+
+// handles still alive release nothing afterwards, their ids aren't known anymore
+void AssetManager::Free() {
+    assets.Clear();
+}
+
+std::string AssetManager::NormalizePath(const std::string& path) {
+    return std::filesystem::path(path).lexically_normal().generic_string();
+}
+
+unsigned int AssetManager::AcquireKey(const std::string& key, std::shared_ptr<void>& asset) {
+    ++requestsCount;
+    CachedAsset* cachedAsset = assets.Acquire(key);
+    if (cachedAsset == nullptr) return 0;
+    asset = cachedAsset->asset;
+    return cachedAsset->id;
+}
+
+unsigned int AssetManager::Insert(const std::string& key, std::shared_ptr<void> asset, size_t assetMemory) {
+    ++loadedCount;
+    unsigned int id = ++lastId;
+    assets.Insert(key, id, assetMemory).asset = std::move(asset);
+    return id;
+}
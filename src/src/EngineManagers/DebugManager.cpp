@@ -6,10 +6,26 @@
 #include "imgui.h"
 #include "misc/cpp/imgui_stdlib.h"
 #include "EngineManagers/SceneManager.h"
+#include "EngineManagers/RendererManager.h"
+#include "EngineManagers/ShadowManager.h"
+#include "LowLevelClasses/FrameGraph.h"
+#include "LowLevelClasses/LightClusters.h"
+#include "LowLevelClasses/DynamicResolution.h"
+#include "LowLevelClasses/SpriteBatch.h"
+#include "LowLevelClasses/SpriteAtlas.h"
+#include "EngineManagers/UIManager.h"
+#include "EngineManagers/FontManager.h"
+#include "EngineManagers/TextureManager.h"
+#include "EngineManagers/AssetManager.h"
+#include "LowLevelClasses/VirtualFileSystem.h"
 #include "GameObjectsAndPrefabs/GameObject.h"
 #include "windows.h"
 #include "psapi.h"
 #include "Components/Renderers/Renderer.h"
+#include "Components/Renderers/Animator.h"
+#include "LowLevelClasses/StaticModel.h"
+#include "LowLevelClasses/AnimationModel.h"
+#include "LowLevelClasses/AnimationClip.h"
 #include "Components/PhysicsAndColliders/BoxCollider.h"
 #include <filesystem>
 
@@ -140,6 +156,12 @@ void DebugManager::Render() {
         coliderOffsetHolder = InjectFloat3IntoVec3(inputVector5);
 
 
+        // the transform is written every frame, cached shadows are only drawn again when it changes
+        if (IsStaticCaster(selected) && (selected->transform->GetLocalPosition() != positionHolder ||
+                                         selected->transform->GetLocalRotation() != rotationHolder ||
+                                         selected->transform->GetLocalScale() != scaleHolder)) {
+            ShadowManager::GetInstance()->InvalidateStaticCache();
+        }
         selected->transform->SetLocalPosition(positionHolder);
         selected->transform->SetLocalRotation(rotationHolder);
         selected->transform->SetLocalScale(scaleHolder);
@@ -208,6 +230,7 @@ void DebugManager::Render() {
                         path += selectedFolderName + "/";
                         path += modelPaths[selectedModelId].path().filename().string();
                         selected->GetComponent<Renderer>()->LoadModel(path);
+                        if (IsStaticCaster(selected)) ShadowManager::GetInstance()->InvalidateStaticCache();
                     }
                 }
 
@@ -218,6 +241,7 @@ void DebugManager::Render() {
         ImGui::Checkbox("Safety checkbox (check if you want to remove the object)", &safetySwitch);
         if(safetySwitch) {
             if (ImGui::Button("REMOVE")){
+                if (IsStaticCaster(selected)) ShadowManager::GetInstance()->InvalidateStaticCache();
                 GameObject::Destroy(selected);
                 safetySwitch = false;
                 displaySelected = false;
@@ -300,6 +324,76 @@ void DebugManager::DisplaySystemInfo() {
 
         SIZE_T physMemUsedByMe = pmc.WorkingSetSize;
         ImGui::Text("Physical Memory Usage: %s Mb", std::to_string(physMemUsedByMe / 100000).c_str());
+
+        // issued to GL / requested by drawables
+        auto requested = RendererManager::GetInstance()->requestedStats;
+        auto issued = RendererManager::GetInstance()->issuedStats;
+        ImGui::Text("Draw calls: %u / %u", issued.drawCalls, requested.drawCalls);
+        ImGui::Text("Shader changes: %u / %u", issued.shaderChanges, requested.shaderChanges);
+        ImGui::Text("Material changes: %u / %u", issued.materialChanges, requested.materialChanges);
+        ImGui::Text("Texture binds: %u / %u", issued.textureBinds, requested.textureBinds);
+        ImGui::Text("VAO binds: %u / %u", issued.vertexArrayBinds, requested.vertexArrayBinds);
+
+        // lights over MAX_LIGHTS_PER_CLUSTER pop in and out as the camera moves
+        auto lightClusters = RendererManager::GetInstance()->lightClusters;
+        ImGui::Text("Cluster lights: %u indices, %u dropped in %u full clusters", lightClusters->GetLightIndicesCount(),
+                    lightClusters->GetDroppedLightsCount(), lightClusters->GetFullClustersCount());
+
+        // vertex buffers in packed layouts compared to uploading whole Vertex structs
+        size_t packedVertexMemory = 0, fullVertexMemory = 0;
+        for (const auto& model : Renderer::models) {
+            for (const auto& mesh : model.second->GetMeshes()) {
+                packedVertexMemory += mesh.GetVertexBufferSize();
+                fullVertexMemory += mesh.vertexCount * sizeof(Vertex);
+            }
+        }
+        for (const auto& model : Animator::animationModels) {
+            for (const auto& mesh : model.second->GetMeshes()) {
+                packedVertexMemory += mesh.GetVertexBufferSize();
+                fullVertexMemory += mesh.vertexCount * sizeof(Vertex);
+            }
+        }
+        ImGui::Text("Vertex VRAM: %.2f Mb (%.2f Mb unpacked)", (float)packedVertexMemory / 1000000.0f,
+                    (float)fullVertexMemory / 1000000.0f);
+        ImGui::Text("Render targets VRAM: %.2f Mb",
+                    (float)GloomEngine::GetInstance()->frameGraph->GetTransientMemory() / 1000000.0f);
+        auto uiManager = UIManager::GetInstance();
+        ImGui::Text("UI: %u quads in %u draw calls (%zu atlas pages, %.2f Mb)", uiManager->spriteBatch->GetQuadsCount(),
+                    uiManager->spriteBatch->GetDrawCallsCount(), uiManager->spriteAtlas->GetPagesCount(),
+                    (float)uiManager->spriteAtlas->GetMemory() / 1000000.0f);
+        ImGui::Text("Fonts: %zu (%.2f Mb)", FontManager::GetInstance()->GetFontsCount(),
+                    (float)FontManager::GetInstance()->GetMemory() / 1000000.0f);
+        size_t cookedAnimationMemory = 0, sourceAnimationMemory = 0;
+        for (const auto& animation : Animator::animations) {
+            if (animation.second->clip == nullptr) continue;
+            cookedAnimationMemory += animation.second->clip->GetSize();
+            sourceAnimationMemory += animation.second->clip->GetHeader().sourceKeysMemory;
+        }
+        ImGui::Text("Animations: %zu (%.2f Mb, %.2f Mb as imported keys)", Animator::animations.size(),
+                    (float)cookedAnimationMemory / 1000000.0f, (float)sourceAnimationMemory / 1000000.0f);
+        auto assetManager = AssetManager::GetInstance();
+        ImGui::Text("Assets: %zu (%.2f Mb, %.2f Mb unused), %u loaded and %u kept from earlier scenes of %u requests",
+                    assetManager->GetAssetsCount(), (float)assetManager->GetMemory() / 1000000.0f,
+                    (float)assetManager->GetUnusedMemory() / 1000000.0f, assetManager->GetLoadedCount(),
+                    assetManager->GetRevivedCount(), assetManager->GetRequestsCount());
+        auto textureManager = TextureManager::GetInstance();
+        ImGui::Text("Textures: %zu (%.2f Mb, %.2f Mb unused), %u decoded and %u compressed of %u requests, %u pending",
+                    textureManager->GetTexturesCount(), (float)textureManager->GetMemory() / 1000000.0f,
+                    (float)textureManager->GetUnusedMemory() / 1000000.0f, textureManager->GetDecodedCount(),
+                    textureManager->GetCompressedCount(), textureManager->GetRequestsCount(),
+                    textureManager->GetPendingCount());
+        auto fileSystem = VirtualFileSystem::GetInstance();
+        ImGui::Text("Files: %u packed (%s), %u read loose, %u from the archive, %u decompressed",
+                    fileSystem->GetPackedFilesCount(), fileSystem->IsMounted() ? "mounted" : "not mounted",
+                    fileSystem->GetLooseCount(), fileSystem->GetPackedCount(), fileSystem->GetDecompressedCount());
+
+        // compare costs of both paths in the frame graph's zones
+        ImGui::Checkbox("Deferred shading", &RendererManager::GetInstance()->deferredShading);
+
+        auto dynamicResolution = GloomEngine::GetInstance()->dynamicResolution;
+        ImGui::Checkbox("Dynamic resolution", &dynamicResolution->enabled);
+        ImGui::Text("Render scale: %.0f%% (GPU %.2f ms / %.2f ms budget)", dynamicResolution->scale * 100.0f,
+                    dynamicResolution->GetAverageFrameTime(), dynamicResolution->frameBudget);
         ImGui::End();
     }
 }
@@ -381,6 +475,7 @@ void DebugManager::SaveMenu()
         if(player){
             newObject->transform->SetLocalPosition(player->transform->GetLocalPosition());
         }
+        if (IsStaticCaster(newObject)) ShadowManager::GetInstance()->InvalidateStaticCache();
         selected = newObject;
         transformExtracted = false;
         displaySelected = true;
@@ -397,6 +492,12 @@ void DebugManager::SaveMenu()
     ImGui::End();
 }
 
+// objects drawn into the cached static part of shadow maps
+bool DebugManager::IsStaticCaster(const std::shared_ptr<GameObject>& gameObject) {
+    auto renderer = gameObject->GetComponent<Renderer>();
+    return renderer != nullptr && renderer->isStatic && renderer->drawShadows;
+}
+
 void DebugManager::Free() const {
 
     ImGui_ImplOpenGL3_Shutdown();
@@ -0,0 +1,250 @@
+#include "EngineManagers/FontManager.h"
+#include "LowLevelClasses/GlyphAtlas.h"
+#include "LowLevelClasses/VirtualFileSystem.h"
+#include "nlohmann/json.hpp"
+#include "spdlog/spdlog.h"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+
+#ifdef DEBUG
+#include <tracy/Tracy.hpp>
+#endif
+
+FontManager::FontManager() = default;
+
+FontManager::~FontManager() {
+    delete fontManager;
+}
+
+FontManager* FontManager::GetInstance() {
+    if (fontManager == nullptr) {
+        fontManager = new FontManager();
+    }
+    return fontManager;
+}
+
+/**
+ * @annotation
+ * Reads fonts used by every scene, e.g. {"MainMenu": [{"path": "Kanit-Light.ttf", "size": 32}]}
+ */
+void FontManager::LoadManifest() {
+    std::filesystem::path path = std::filesystem::current_path();
+    path /= "res";
+    path /= "ProjectConfig";
+    path /= "fonts.json";
+
+    try {
+        VirtualFile input;
+        if (!VirtualFileSystem::GetInstance()->Open(path.string(), input)) throw std::runtime_error("missing file");
+
+        nlohmann::json json = nlohmann::json::parse(input.GetText());
+        for (const auto& scene : json.items()) {
+            for (const auto& font : scene.value()) {
+                sceneFonts[scene.key()].insert({font.at("path").get<std::string>(), font.at("size").get<unsigned int>()});
+            }
+        }
+    }
+    catch (std::exception e) {
+        spdlog::info("Failed to read a file content at path: " + path.string());
+    }
+}
+
+/**
+ * @annotation
+ * Starts rasterizing fonts of the scene which aren't loaded yet on worker threads,
+ * they are uploaded when first requested or when the scene finishes loading
+ * @param scene - name of the scene in fonts.json
+ */
+void FontManager::Prewarm(const std::string& scene) {
+#ifdef DEBUG
+    ZoneScopedNC("Prewarm fonts", 0xDC143C);
+#endif
+    WaitForPrewarm();
+#ifdef DEBUG
+    SaveManifest();
+    activeScene = scene;
+#endif
+    loadingScene = scene;
+    requestsCount = 0;
+    rasterizedCount = 0;
+    mainThreadTime = 0.0f;
+    workersTime = 0.0f;
+
+    for (const auto& key : sceneFonts[scene]) {
+        if (fonts.contains(key)) continue;
+        auto atlas = std::make_shared<GlyphAtlas>(key.first, key.second);
+        fonts.insert({key, atlas});
+        prewarmedFonts.push_back(atlas);
+    }
+    if (prewarmedFonts.empty()) return;
+    prewarmTimes.assign(prewarmedFonts.size(), 0.0f);
+
+    // the main thread keeps loading the scene, so every chunk goes to a worker
+    int maxNumberOfThreads = (int)std::max(std::thread::hardware_concurrency() / 2, 1u);
+    int numberOfThreads = std::min(maxNumberOfThreads, (int)prewarmedFonts.size());
+    int fontsPerThread = ((int)prewarmedFonts.size() + numberOfThreads - 1) / numberOfThreads;
+
+    for (int i = 0; i < numberOfThreads; ++i) {
+        int start = i * fontsPerThread;
+        int end = std::min(start + fontsPerThread, (int)prewarmedFonts.size());
+        prewarmThreads.emplace_back([this, start, end] {
+            for (int j = start; j < end; ++j) {
+                auto rasterizeStart = std::chrono::steady_clock::now();
+                prewarmedFonts[j]->Rasterize();
+                prewarmTimes[j] = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - rasterizeStart).count();
+            }
+        });
+    }
+}
+
+/**
+ * @annotation
+ * Returns the shared atlas of the font, rasterizing it on the spot if it wasn't loaded or prewarmed
+ * @param path - path of the font relative to res/fonts
+ */
+std::shared_ptr<GlyphAtlas> FontManager::GetFont(const std::string& path, unsigned int fontSize) {
+    auto start = std::chrono::steady_clock::now();
+    ++requestsCount;
+
+    FontKey key = {path, fontSize};
+#ifdef DEBUG
+    // development runs keep fonts.json in sync with texts, shipped data isn't modified
+    if (!activeScene.empty() && sceneFonts[activeScene].insert(key).second) {
+        spdlog::info("Font " + path + " " + std::to_string(fontSize) + " of " + activeScene + " added to fonts.json");
+        isManifestChanged = true;
+    }
+#endif
+    auto font = fonts.find(key);
+    std::shared_ptr<GlyphAtlas> atlas;
+    if (font != fonts.end()) {
+        atlas = font->second;
+        // still rasterized by a prewarm thread
+        if (atlas->texture == 0) WaitForPrewarm();
+    }
+    else {
+        atlas = std::make_shared<GlyphAtlas>(path, fontSize);
+        atlas->Rasterize();
+        ++rasterizedCount;
+        atlas->Upload();
+        fonts.insert({key, atlas});
+    }
+
+    mainThreadTime += std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return atlas;
+}
+
+/**
+ * @annotation
+ * Uploads fonts prewarmed for the scene, logs how much font loading cost and releases fonts only the previous scene used
+ */
+void FontManager::FinishSceneLoad() {
+    WaitForPrewarm();
+
+    spdlog::info(loadingScene + " fonts: " + std::to_string(requestsCount) + " requests, " +
+                 std::to_string(rasterizedCount) + " rasterized, " + std::to_string(mainThreadTime) +
+                 " ms on main thread, " + std::to_string(workersTime) + " ms on prewarm threads");
+
+    ReleaseUnused();
+    loadingScene.clear();
+#ifdef DEBUG
+    SaveManifest();
+#endif
+}
+
+size_t FontManager::GetMemory() const {
+    size_t memory = 0;
+    for (const auto& font : fonts) {
+        memory += font.second->GetMemory();
+    }
+    return memory;
+}
+
+size_t FontManager::GetFontsCount() const {
+    return fonts.size();
+}
+
+void FontManager::Free() {
+    WaitForPrewarm();
+#ifdef DEBUG
+    SaveManifest();
+#endif
+    for (const auto& font : fonts) {
+        font.second->Free();
+    }
+    fonts.clear();
+}
+
+void FontManager::WaitForPrewarm() {
+    if (prewarmThreads.empty()) return;
+#ifdef DEBUG
+    ZoneScopedNC("Wait for fonts", 0xDC143C);
+#endif
+    for (auto& thread : prewarmThreads) {
+        thread.join();
+    }
+    prewarmThreads.clear();
+
+    for (int i = 0; i < prewarmedFonts.size(); ++i) {
+        prewarmedFonts[i]->Upload();
+        workersTime += prewarmTimes[i];
+    }
+    rasterizedCount += prewarmedFonts.size();
+    prewarmedFonts.clear();
+}
+
+#ifdef DEBUG
+// texts created after the load, e.g. popups, add their fonts too, so the manifest is saved again before the next scene
+void FontManager::SaveManifest() {
+    if (!isManifestChanged) return;
+
+    std::filesystem::path path = std::filesystem::current_path();
+    path /= "res";
+    path /= "ProjectConfig";
+    path /= "fonts.json";
+
+    try {
+        nlohmann::json json;
+        for (const auto& scene : sceneFonts) {
+            nlohmann::json fontsJson = nlohmann::json::array();
+            for (const auto& key : scene.second) {
+                fontsJson.push_back({{"path", key.first}, {"size", key.second}});
+            }
+            json[scene.first] = fontsJson;
+        }
+
+        std::ofstream saveFile(path);
+        if (!saveFile) {
+            spdlog::error("Failed to open a file at path: " + path.string());
+            return;
+        }
+        saveFile << json.dump(0, '\t') << std::endl;
+        if (!saveFile) {
+            spdlog::error("Failed to write a file at path: " + path.string());
+            return;
+        }
+        // kept set after a failure, so the next save tries again
+        isManifestChanged = false;
+    }
+    catch (const std::exception& e) {
+        spdlog::error("Failed to save a file at path: " + path.string() + ", " + e.what());
+    }
+}
+#endif
+
+// atlases referenced only by the cache aren't used by any text, fonts listed for the loaded scene are kept
+// for texts created later, e.g. popups
+void FontManager::ReleaseUnused() {
+    const auto& keptFonts = sceneFonts[loadingScene];
+    for (auto font = fonts.begin(); font != fonts.end();) {
+        if (font->second.use_count() == 1 && !keptFonts.contains(font->first)) {
+            font->second->Free();
+            font = fonts.erase(font);
+        }
+        else {
+            ++font;
+        }
+    }
+}
@@ -1,4 +1,5 @@
 #include "EngineManagers/OptionsManager.h"
+#include "LowLevelClasses/VirtualFileSystem.h"
 #include <filesystem>
 #include <iostream>
 #include <fstream>
@@ -35,10 +36,10 @@ void OptionsManager::Load() {
     path /= "config.json";
 
     try {
-        std::ifstream input(path);
+        VirtualFile input;
+        if (!VirtualFileSystem::GetInstance()->Open(path.string(), input)) throw std::runtime_error("missing file");
 
-        nlohmann::json json;
-        input >> json;
+        nlohmann::json json = nlohmann::json::parse(input.GetText());
         json.at("musicVolume").get_to(musicVolume);
         json.at("width").get_to(width);
         json.at("height").get_to(height);
@@ -5,61 +5,10 @@
 #include "EngineManagers/PostProcessingManager.h"
 #include "GloomEngine.h"
 #include "LowLevelClasses/Shader.h"
-#include "EngineManagers/OptionsManager.h"
 
 PostProcessingManager::PostProcessingManager() {
     postProcessingShader = std::make_shared<Shader>("postProcess.vert", "postProcess.frag");
 
-    int width = OptionsManager::GetInstance()->width;
-    int height = OptionsManager::GetInstance()->height;
-
-    glGenFramebuffers(1, &framebuffer);
-    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
-    // create a color attachment texture
-    glGenTextures(1, &textureScreen);
-    glBindTexture(GL_TEXTURE_2D, textureScreen);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, NULL);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, textureScreen, 0);
-    // position color buffer
-    glGenTextures(1, &texturePosition);
-    glBindTexture(GL_TEXTURE_2D, texturePosition);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, texturePosition, 0);
-    // normal color buffer
-    glGenTextures(1, &textureNormal);
-    glBindTexture(GL_TEXTURE_2D, textureNormal);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT2, GL_TEXTURE_2D, textureNormal, 0);
-    // color + specular color buffer
-    glGenTextures(1, &textureColor);
-    glBindTexture(GL_TEXTURE_2D, textureColor);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT3, GL_TEXTURE_2D, textureColor, 0);
-    // tell OpenGL which color attachments we'll use (of this framebuffer) for rendering
-    attachments[0] = GL_COLOR_ATTACHMENT0;
-    attachments[1] = GL_COLOR_ATTACHMENT1;
-    attachments[2] = GL_COLOR_ATTACHMENT2;
-    attachments[3] = GL_COLOR_ATTACHMENT3;
-    glDrawBuffers(4, attachments);
-
-    // create a renderbuffer object for depth and stencil attachment (we won't be sampling these)
-    glGenRenderbuffers(1, &rbo);
-    glBindRenderbuffer(GL_RENDERBUFFER, rbo);
-    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT, width, height);
-    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, rbo);// now actually attach it
-    // now that we actually created the framebuffer and added all attachments we want to check if it is actually complete now
-    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
-        spdlog::error("ERROR::FRAMEBUFFER:: Framebuffer is not complete!");
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-
     glGenVertexArrays(1, &quadVAO);
     glGenBuffers(1, &quadVBO);
     glBindVertexArray(quadVAO);
@@ -88,7 +37,13 @@ PostProcessingManager *PostProcessingManager::GetInstance() {
     return postProcessingManager;
 }
 
-void PostProcessingManager::Draw() {
+/**
+ * @annotation
+ * Draws the scene textures written by the frame graph's scene pass to the bound framebuffer
+ * @param renderScale - part of the textures covered by the scene, it is stretched over the whole framebuffer
+ */
+void PostProcessingManager::Draw(unsigned int textureScreen, unsigned int texturePosition, unsigned int textureNormal,
+                                 unsigned int textureColor, const glm::vec2& renderScale) {
     glDisable(GL_DEPTH_TEST); // disable depth test so screen-space quad isn't discarded due to depth test.
     // clear all relevant buffers
     glm::vec4 screenColor = GloomEngine::GetInstance()->screenColor;
@@ -96,6 +51,7 @@ void PostProcessingManager::Draw() {
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
     postProcessingShader->Activate();
+    postProcessingShader->SetVec2("renderScale", renderScale);
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, textureScreen);
     glActiveTexture(GL_TEXTURE1);
@@ -105,7 +61,14 @@ void PostProcessingManager::Draw() {
     glActiveTexture(GL_TEXTURE3);
     glBindTexture(GL_TEXTURE_2D, textureColor);
 
+    DrawQuad();
+}
 
+/**
+ * @annotation
+ * Draws a quad covering the whole viewport with the active shader
+ */
+void PostProcessingManager::DrawQuad() const {
     glBindVertexArray(quadVAO);
     glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
     glBindVertexArray(0);
@@ -115,75 +78,4 @@ void PostProcessingManager::Free() const {
     postProcessingShader->Delete();
     glDeleteVertexArrays(1, &quadVAO);
     glDeleteBuffers(1, &quadVBO);
-    glDeleteRenderbuffers(1, &rbo);
-    glDeleteFramebuffers(1, &framebuffer);
 }
-
-void PostProcessingManager::WindowResize() {
-    int width = OptionsManager::GetInstance()->width;
-    int height = OptionsManager::GetInstance()->height;
-
-    glGenFramebuffers(1, &framebuffer);
-    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
-    // create a color attachment texture
-    glGenTextures(1, &textureScreen);
-    glBindTexture(GL_TEXTURE_2D, textureScreen);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, NULL);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, textureScreen, 0);
-    // position color buffer
-    glGenTextures(1, &texturePosition);
-    glBindTexture(GL_TEXTURE_2D, texturePosition);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, texturePosition, 0);
-    // normal color buffer
-    glGenTextures(1, &textureNormal);
-    glBindTexture(GL_TEXTURE_2D, textureNormal);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT2, GL_TEXTURE_2D, textureNormal, 0);
-    // color + specular color buffer
-    glGenTextures(1, &textureColor);
-    glBindTexture(GL_TEXTURE_2D, textureColor);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT3, GL_TEXTURE_2D, textureColor, 0);
-    // tell OpenGL which color attachments we'll use (of this framebuffer) for rendering
-    attachments[0] = GL_COLOR_ATTACHMENT0;
-    attachments[1] = GL_COLOR_ATTACHMENT1;
-    attachments[2] = GL_COLOR_ATTACHMENT2;
-    attachments[3] = GL_COLOR_ATTACHMENT3;
-    glDrawBuffers(4, attachments);
-
-    // create a renderbuffer object for depth and stencil attachment (we won't be sampling these)
-    glGenRenderbuffers(1, &rbo);
-    glBindRenderbuffer(GL_RENDERBUFFER, rbo);
-    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT, width, height);
-    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, rbo);// now actually attach it
-    // now that we actually created the framebuffer and added all attachments we want to check if it is actually complete now
-    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
-        spdlog::error("ERROR::FRAMEBUFFER:: Framebuffer is not complete!");
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-
-    glGenVertexArrays(1, &quadVAO);
-    glGenBuffers(1, &quadVBO);
-    glBindVertexArray(quadVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), &quadVertices, GL_STATIC_DRAW);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-
-    postProcessingShader->Activate();
-    postProcessingShader->SetInt("screenTexture", 0);
-    postProcessingShader->SetInt("texturePosition", 1);
-    postProcessingShader->SetInt("textureNormal", 2);
-    postProcessingShader->SetInt("textureColor", 3);
-}
-
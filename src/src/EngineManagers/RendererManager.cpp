@@ -7,8 +7,16 @@
 #include "Components/Renderers/Lights/PointLight.h"
 #include "Components/Renderers/Lights/DirectionalLight.h"
 #include "Components/Renderers/Lights/SpotLight.h"
+#include "LowLevelClasses/Mesh.h"
+#include "LowLevelClasses/Model.h"
+#include "LowLevelClasses/StaticGeometryPool.h"
+#include "LowLevelClasses/LightClusters.h"
 #include "stb_image.h"
 #include "EngineManagers/OptionsManager.h"
+#include "EngineManagers/ShadowManager.h"
+#include "EngineManagers/PostProcessingManager.h"
+
+#include <algorithm>
 
 #ifdef DEBUG
 #include <tracy/Tracy.hpp>
@@ -17,9 +25,35 @@
 RendererManager::RendererManager() {
     shader = std::make_shared<Shader>("basic.vert", "basic.frag");
     cubeMapShader = std::make_shared<Shader>("cubeMap.vert", "cubeMap.frag");
+    lightingShader = std::make_shared<Shader>("postProcess.vert", "deferredLighting.frag");
+    lightingShader->Activate();
+    lightingShader->SetInt("gAlbedo", 0);
+    lightingShader->SetInt("gPosition", 1);
+    lightingShader->SetInt("gNormal", 2);
+    lightingShader->SetInt("gMaterial", 3);
+    lightingShader->SetInt("skybox", 5);
+    lightingShader->SetInt("shadowMap", SHADOW_MAP_UNIT);
     projection = glm::perspective(glm::radians(fov),
                                   (float)OptionsManager::GetInstance()->width/(float)OptionsManager::GetInstance()->height,
                                   0.1f, 100.0f);
+
+    renderSize = {OptionsManager::GetInstance()->width, OptionsManager::GetInstance()->height};
+
+    glGenBuffers(1, &instanceVBO);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(instanceData), nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    glGenBuffers(1, &bonePaletteSSBO);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, bonePaletteSSBO);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(bonePalette), nullptr, GL_DYNAMIC_DRAW);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, bonePaletteSSBO);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    commandBuffers.resize(maxNumberOfThreads + 1);
+
+    staticGeometryPool = std::make_shared<StaticGeometryPool>();
+    lightClusters = std::make_shared<LightClusters>();
 }
 
 RendererManager::~RendererManager() {
@@ -36,30 +70,482 @@ RendererManager* RendererManager::GetInstance() {
 void RendererManager::Free() const {
     shader->Delete();
     cubeMapShader->Delete();
+    lightingShader->Delete();
+    glDeleteBuffers(1, &instanceVBO);
+    glDeleteBuffers(1, &bonePaletteSSBO);
+    staticGeometryPool->Clear();
 }
 
 void RendererManager::Draw() {
+    shader->Activate();
+    shader->SetBool("isDeferred", deferredShading);
     DrawObjects();
     ClearBuffer();
 }
 
 void RendererManager::DrawObjects() {
-    for (int i = 0; i < bufferIterator; ++i) {
-        drawBuffer[i]->Draw();
-    }
+    DrawQueue(shader, false);
 }
 
+/**
+ * @annotation
+ * Draws objects which cast shadows with given shader
+ * @param drawShader - shader used for every object
+ */
 void RendererManager::DrawObjects(const std::shared_ptr<Shader>& drawShader) {
-    for (int i = 0; i < bufferIterator; ++i) {
-        drawBuffer[i]->Draw(drawShader);
+    DrawQueue(drawShader, true);
+}
+
+/**
+ * @annotation
+ * Draws objects which cast shadows and aren't static with given shader, static ones are cached by ShadowManager
+ * @param drawShader - shader used for every object
+ */
+void RendererManager::DrawDynamicObjects(const std::shared_ptr<Shader>& drawShader) {
+    DrawQueue(drawShader, true, true);
+}
+
+/**
+ * @annotation
+ * Shades every pixel of the G-buffer written by Draw with deferredShading on
+ * @attention Needs to be called with the frame graph's lighting framebuffer bound
+ */
+void RendererManager::DrawLighting(unsigned int albedo, unsigned int position, unsigned int normal,
+                                   unsigned int material) {
+    const unsigned int gBuffer[4] = {albedo, position, normal, material};
+
+    glDisable(GL_DEPTH_TEST);
+    lightingShader->Activate();
+    for (int i = 0; i < 4; ++i) {
+        glActiveTexture(GL_TEXTURE0 + i);
+        glBindTexture(GL_TEXTURE_2D, gBuffer[i]);
+    }
+
+    PostProcessingManager::GetInstance()->DrawQuad();
+
+    // units 1 - 3 are also used by mesh textures, the state cache doesn't know about these
+    for (int i = 3; i >= 0; --i) {
+        glActiveTexture(GL_TEXTURE0 + i);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+    glEnable(GL_DEPTH_TEST);
+}
+
+void RendererManager::DrawQueue(const std::shared_ptr<Shader>& drawShader, bool isShadowPass, bool skipStatic) {
+    ResetRenderState();
+    // pooled batches of dynamic objects are drawn one batch at a time, when static ones are skipped
+    if (!skipStatic) staticGeometryPool->Draw(drawShader, isShadowPass);
+    for (const auto& buffer : commandBuffers) {
+        for (const auto& command : buffer.commands) {
+            if (skipStatic && command.isStatic) continue;
+            if (command.isPooled && !skipStatic) continue;
+            if (isShadowPass && !command.drawShadows) continue;
+            ExecuteCommand(drawShader, command);
+        }
     }
+    ResetRenderState();
+}
+
+/**
+ * @annotation
+ * Sends one recorded command to GL, the only part of drawing the queue which runs on the main thread
+ */
+void RendererManager::ExecuteCommand(const std::shared_ptr<Shader>& drawShader, const RenderCommand& command) {
+    if (command.type == RenderCommandType::Drawable) {
+        if (drawShader == shader) command.drawable->Draw();
+        else command.drawable->Draw(drawShader);
+        return;
+    }
+
+    BindShader(drawShader);
+    bool isInstanced = command.type == RenderCommandType::InstancedMesh;
+    if (!isInstanced && command.setsObjectUniforms) {
+        drawShader->SetMat4("model", command.model);
+        if (command.isAnimated) drawShader->SetInt("bonesOffset", command.bonesOffset);
+    }
+    ApplyMaterial(drawShader, command.material, command.textScale, command.isAnimated, isInstanced);
+    BindTextures(drawShader, command.mesh->textures);
+    BindVertexArray(command.mesh->vao);
+
+    if (isInstanced) {
+        glDrawElementsInstancedBaseInstance(command.primitive, (int)command.mesh->indexCount, GL_UNSIGNED_INT, 0,
+                                            (int)command.instanceCount, command.firstInstance);
+        requestedStats.drawCalls += command.instanceCount;
+    }
+    else {
+        glDrawElements(command.primitive, (int)command.mesh->indexCount, GL_UNSIGNED_INT, 0);
+        ++requestedStats.drawCalls;
+    }
+    ++issuedStats.drawCalls;
 }
 
 void RendererManager::AddToDrawBuffer(const std::shared_ptr<Drawable>& DrawableComponent) {
     drawBuffer[bufferIterator] = DrawableComponent;
+    drawQueue[bufferIterator] = {0, bufferIterator, NOT_BATCHED};
     ++bufferIterator;
 }
 
+/**
+ * @annotation
+ * Builds draw queue from draw buffer and sorts it by keys using LSD radix sort (8 passes of 8 bits),
+ * passes where every key has the same byte are skipped. Needs to be called after all drawables
+ * were added to the buffer and before shadow and object passes.
+ */
+void RendererManager::SortDrawBuffer() {
+#ifdef DEBUG
+    ZoneScopedNC("Sort draw buffer", 0xADD8E6);
+#endif
+    requestedStats = {};
+    issuedStats = {};
+    batchesCount = 0;
+    instancesCount = 0;
+    bonesCount = 0;
+    for (auto& buffer : commandBuffers) {
+        buffer.Clear();
+    }
+
+    if (bufferIterator == 0) return;
+
+    glm::vec3 cameraPosition = glm::vec3(0.0f);
+    if (Camera::activeCamera != nullptr)
+        cameraPosition = Camera::activeCamera->transform->GetGlobalPosition();
+
+    for (unsigned int i = 0; i < bufferIterator; ++i) {
+        drawQueue[i] = {drawBuffer[i]->GetSortKey(cameraPosition), i, NOT_BATCHED};
+    }
+
+    DrawCommand* source = drawQueue;
+    DrawCommand* destination = sortScratch;
+    unsigned int count[256];
+
+    for (int shift = 0; shift < 64; shift += 8) {
+        std::fill(count, count + 256, 0);
+        for (unsigned int i = 0; i < bufferIterator; ++i) {
+            ++count[(source[i].key >> shift) & 0xFF];
+        }
+        if (count[(source[0].key >> shift) & 0xFF] == bufferIterator) continue;
+
+        unsigned int offset = 0;
+        for (unsigned int & bucket : count) {
+            unsigned int bucketSize = bucket;
+            bucket = offset;
+            offset += bucketSize;
+        }
+        for (unsigned int i = 0; i < bufferIterator; ++i) {
+            destination[count[(source[i].key >> shift) & 0xFF]++] = source[i];
+        }
+        std::swap(source, destination);
+    }
+
+    if (source != drawQueue) std::copy(source, source + bufferIterator, drawQueue);
+
+    FillBonePalette();
+    CreateInstanceBatches();
+    RecordCommands();
+}
+
+/**
+ * @annotation
+ * Copies final bone matrices of every animated drawable into one shader storage buffer,
+ * drawables read them back starting from their bonesOffset.
+ */
+void RendererManager::FillBonePalette() {
+#ifdef DEBUG
+    ZoneScopedNC("Fill bone palette", 0xADD8E6);
+#endif
+    for (unsigned int i = 0; i < bufferIterator; ++i) {
+        const std::shared_ptr<Drawable>& drawable = drawBuffer[drawQueue[i].index];
+        const glm::mat4* boneMatrices = drawable->GetFinalBoneMatrices();
+        if (boneMatrices == nullptr) continue;
+
+        drawable->bonesOffset = (int)bonesCount;
+        std::copy(boneMatrices, boneMatrices + BONE_NUMBER, bonePalette + bonesCount);
+        bonesCount += BONE_NUMBER;
+    }
+
+    if (bonesCount == 0) return;
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, bonePaletteSSBO);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(bonePalette), nullptr, GL_DYNAMIC_DRAW);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, bonesCount * sizeof(glm::mat4), bonePalette);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+/**
+ * @annotation
+ * Groups runs of sorted commands which can be drawn with one instanced call
+ * and uploads their per instance data to the instance buffer.
+ */
+void RendererManager::CreateInstanceBatches() {
+#ifdef DEBUG
+    ZoneScopedNC("Create instance batches", 0xADD8E6);
+#endif
+    staticGeometryPool->BeginFrame();
+
+    unsigned int i = 0;
+    while (i < bufferIterator) {
+        const std::shared_ptr<Drawable>& first = drawBuffer[drawQueue[i].index];
+        Model* model = first->GetInstancingModel();
+        unsigned int end = i + 1;
+        if (model != nullptr) {
+            while (end < bufferIterator && CanShareBatch(first, drawBuffer[drawQueue[end].index])) ++end;
+        }
+        bool isAnimated = first->GetFinalBoneMatrices() != nullptr;
+        bool isPooled = model != nullptr && !isAnimated && staticGeometryPool->Contains(model);
+        // single objects are cheaper to draw without instancing, unless they live in the pool
+        if (end - i < 2 && !isPooled) {
+            ++i;
+            continue;
+        }
+
+        if (isPooled) {
+            // color and texture stretch are per instance values
+            Material sharedMaterial = {glm::vec3(1.0f), first->material.shininess,
+                                       first->material.reflection, first->material.refraction};
+            isPooled = staticGeometryPool->AddInstances(model, sharedMaterial, first->drawShadows,
+                                                        instancesCount, end - i);
+        }
+
+        instanceBatches[batchesCount] = {model, first->material, isAnimated, first->drawShadows, first->isStatic,
+                                         isPooled, instancesCount, end - i};
+        for (unsigned int j = i; j < end; ++j) {
+            const std::shared_ptr<Drawable>& drawable = drawBuffer[drawQueue[j].index];
+            instanceData[instancesCount] = {drawable->GetParent()->transform->GetModelMatrix(),
+                                            drawable->material.color, drawable->textScale, drawable->bonesOffset};
+            ++instancesCount;
+            drawQueue[j].batch = BATCHED;
+        }
+        drawQueue[i].batch = (int)batchesCount;
+        ++batchesCount;
+        i = end;
+    }
+
+    staticGeometryPool->EndFrame();
+
+    if (instancesCount == 0) return;
+
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    // orphan last frame's storage so the driver doesn't wait for draws still using it
+    glBufferData(GL_ARRAY_BUFFER, sizeof(instanceData), nullptr, GL_DYNAMIC_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, instancesCount * sizeof(InstanceData), instanceData);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+/**
+ * @annotation
+ * Splits the sorted queue into contiguous chunks recorded on separate threads,
+ * replaying buffers one after another keeps the sorted order
+ */
+void RendererManager::RecordCommands() {
+#ifdef DEBUG
+    ZoneScopedNC("Record commands", 0xADD8E6);
+#endif
+    const auto buffersCount = (unsigned int)commandBuffers.size();
+    const unsigned int chunk = std::max((unsigned int)MIN_RECORDED_PER_THREAD,
+                                        (bufferIterator + buffersCount - 1) / buffersCount);
+
+    unsigned int begin = 0;
+    unsigned int bufferIndex = 0;
+    for (; begin + chunk < bufferIterator && bufferIndex + 1 < buffersCount; begin += chunk, ++bufferIndex) {
+        threads.emplace_back(&RendererManager::RecordRange, this, std::ref(commandBuffers[bufferIndex]),
+                             begin, begin + chunk);
+    }
+    RecordRange(commandBuffers[bufferIndex], begin, bufferIterator);
+
+    for (auto& thread : threads) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+    threads.clear();
+}
+
+void RendererManager::RecordRange(RenderCommandBuffer& buffer, unsigned int begin, unsigned int end) {
+    for (unsigned int i = begin; i < end; ++i) {
+        const DrawCommand& command = drawQueue[i];
+        // drawn together with the first command of its batch
+        if (command.batch == BATCHED) continue;
+
+        if (command.batch != NOT_BATCHED) {
+            const InstanceBatch& batch = instanceBatches[command.batch];
+            RenderCommand batchCommand{};
+            batchCommand.type = RenderCommandType::InstancedMesh;
+            batchCommand.drawShadows = batch.drawShadows;
+            batchCommand.isStatic = batch.isStatic;
+            batchCommand.isAnimated = batch.isAnimated;
+            batchCommand.isPooled = batch.isPooled;
+            batchCommand.material = batch.material;
+            batchCommand.textScale = glm::vec2(1.0f);
+            batchCommand.firstInstance = batch.firstInstance;
+            batchCommand.instanceCount = batch.instanceCount;
+            buffer.AddModel(batch.model, batchCommand);
+            continue;
+        }
+
+        drawBuffer[command.index]->Record(buffer);
+    }
+}
+
+bool RendererManager::CanShareBatch(const std::shared_ptr<Drawable>& first, const std::shared_ptr<Drawable>& other) {
+    return other->GetInstancingModel() == first->GetInstancingModel() &&
+           other->drawShadows == first->drawShadows &&
+           other->isStatic == first->isStatic &&
+           other->material.shininess == first->material.shininess &&
+           other->material.reflection == first->material.reflection &&
+           other->material.refraction == first->material.refraction;
+}
+
+/**
+ * @annotation
+ * Key layout from the most significant bit:
+ * pass (4 bits), shader (6 bits), material (14 bits), texture set (14 bits), mesh (14 bits), depth (12 bits).
+ * Keys only decide the order, redundant state changes are filtered by the state cache.
+ * @param depth - distance from camera, objects are drawn front to back
+ */
+uint64_t RendererManager::CreateSortKey(RenderPass pass, unsigned int shaderId, unsigned int materialKey,
+                                        unsigned int textureSetKey, unsigned int meshKey, float depth) {
+    auto zFar = GetInstance()->zFar;
+    auto quantizedDepth = (uint64_t)(std::clamp(depth / zFar, 0.0f, 1.0f) * 4095.0f);
+
+    return ((uint64_t)pass & 0xF) << 60 |
+           ((uint64_t)shaderId & 0x3F) << 54 |
+           ((uint64_t)materialKey & 0x3FFF) << 40 |
+           ((uint64_t)textureSetKey & 0x3FFF) << 26 |
+           ((uint64_t)meshKey & 0x3FFF) << 12 |
+           quantizedDepth;
+}
+
+unsigned int RendererManager::CreateMaterialKey(const Material& material, const glm::vec2& textScale, bool isAnimated) {
+    const float values[] = {material.color.x, material.color.y, material.color.z, material.shininess,
+                            material.reflection, material.refraction, textScale.x, textScale.y,
+                            isAnimated ? 1.0f : 0.0f};
+
+    // FNV-1a
+    unsigned int hash = 2166136261u;
+    auto bytes = reinterpret_cast<const unsigned char*>(values);
+    for (int i = 0; i < sizeof(values); ++i) {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+    return hash ^ (hash >> 14) ^ (hash >> 28);
+}
+
+/**
+ * @annotation
+ * Forgets cached state and unbinds everything bound by the render queue,
+ * needs to be called before and after every pass which draws objects through the cache.
+ */
+void RendererManager::ResetRenderState() {
+    for (unsigned int i = 0; i < boundTexturesCount; ++i) {
+        if (boundTextures[i] == 0) continue;
+        glActiveTexture(GL_TEXTURE1 + i);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        boundTextures[i] = 0;
+    }
+    glActiveTexture(GL_TEXTURE0);
+    glBindVertexArray(0);
+
+    boundShader = 0;
+    boundVao = 0;
+    boundTexturesCount = 0;
+    isMaterialBound = false;
+}
+
+void RendererManager::BindShader(const std::shared_ptr<Shader>& drawShader) {
+    ++requestedStats.shaderChanges;
+    if (drawShader->GetShader() == boundShader) return;
+
+    drawShader->Activate();
+    boundShader = drawShader->GetShader();
+    ++issuedStats.shaderChanges;
+
+    // uniforms and samplers belong to the program
+    isMaterialBound = false;
+    for (unsigned int i = 0; i < boundTexturesCount; ++i) {
+        if (boundTextures[i] != 0) boundTextures[i] = UNKNOWN_TEXTURE;
+    }
+}
+
+void RendererManager::ApplyMaterial(const std::shared_ptr<Shader>& drawShader, const Material& material,
+                                    const glm::vec2& textScale, bool isAnimated, bool isInstanced) {
+    ++requestedStats.materialChanges;
+    if (isMaterialBound && boundIsAnimated == isAnimated && boundIsInstanced == isInstanced && boundTextScale == textScale &&
+        boundMaterial.color == material.color && boundMaterial.shininess == material.shininess &&
+        boundMaterial.reflection == material.reflection && boundMaterial.refraction == material.refraction) return;
+
+    drawShader->SetVec2("texStrech", textScale);
+    drawShader->SetVec3("material.color", material.color);
+    drawShader->SetFloat("material.shininess", material.shininess);
+    drawShader->SetFloat("material.reflection", material.reflection);
+    drawShader->SetFloat("material.refraction", material.refraction);
+    drawShader->SetBool("isAnimated", isAnimated);
+    drawShader->SetBool("isInstanced", isInstanced);
+
+    isMaterialBound = true;
+    boundMaterial = material;
+    boundTextScale = textScale;
+    boundIsAnimated = isAnimated;
+    boundIsInstanced = isInstanced;
+    ++issuedStats.materialChanges;
+}
+
+void RendererManager::BindTextures(const std::shared_ptr<Shader>& drawShader, const std::vector<Texture>& textures) {
+    requestedStats.textureBinds += textures.size();
+    unsigned int texturesCount = std::min((unsigned int)textures.size(), (unsigned int)MAX_BOUND_TEXTURES);
+
+    for (unsigned int i = 0; i < texturesCount; ++i) {
+        if (boundTextures[i] == textures[i].id) continue;
+
+        glActiveTexture(GL_TEXTURE1 + i);
+        glUniform1i(glGetUniformLocation(drawShader->GetShader(), textures[i].type.c_str()), (int)i + 1);
+        glBindTexture(GL_TEXTURE_2D, textures[i].id);
+        boundTextures[i] = textures[i].id;
+        ++issuedStats.textureBinds;
+    }
+    // textures of the previous mesh can't leak into this one
+    for (unsigned int i = texturesCount; i < boundTexturesCount; ++i) {
+        if (boundTextures[i] == 0) continue;
+
+        glActiveTexture(GL_TEXTURE1 + i);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        boundTextures[i] = 0;
+        ++issuedStats.textureBinds;
+    }
+    boundTexturesCount = std::max(boundTexturesCount, texturesCount);
+}
+
+void RendererManager::BindVertexArray(unsigned int vao) {
+    ++requestedStats.vertexArrayBinds;
+    if (vao == boundVao) return;
+
+    glBindVertexArray(vao);
+    boundVao = vao;
+    ++issuedStats.vertexArrayBinds;
+}
+
+/**
+ * @attention Needs to be called with mesh's vertex array bound
+ */
+void RendererManager::SetupInstanceAttributes() const {
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    // model matrix takes four locations, one per column
+    for (int i = 0; i < 4; ++i) {
+        glEnableVertexAttribArray(7 + i);
+        glVertexAttribPointer(7 + i, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+                              (void*)(offsetof(InstanceData, model) + i * sizeof(glm::vec4)));
+        glVertexAttribDivisor(7 + i, 1);
+    }
+    glEnableVertexAttribArray(11);
+    glVertexAttribPointer(11, 3, GL_FLOAT, GL_FALSE, sizeof(InstanceData), (void*)offsetof(InstanceData, color));
+    glVertexAttribDivisor(11, 1);
+    glEnableVertexAttribArray(12);
+    glVertexAttribPointer(12, 2, GL_FLOAT, GL_FALSE, sizeof(InstanceData), (void*)offsetof(InstanceData, texStrech));
+    glVertexAttribDivisor(12, 1);
+    glEnableVertexAttribArray(13);
+    glVertexAttribIPointer(13, 1, GL_INT, sizeof(InstanceData), (void*)offsetof(InstanceData, bonesOffset));
+    glVertexAttribDivisor(13, 1);
+}
+
 void RendererManager::UpdateProjection() const {
 #ifdef DEBUG
     ZoneScopedNC("Projection update", 0xDC143C);
@@ -79,145 +565,48 @@ void RendererManager::UpdateCamera() const {
 
     cubeMapShader->Activate();
     cubeMapShader->SetMat4("view", glm::mat4(glm::mat3(Camera::activeCamera->GetComponent<Camera>()->GetViewMatrix())));
+
+    lightingShader->Activate();
+    lightingShader->SetMat4("view", Camera::activeCamera->GetComponent<Camera>()->GetViewMatrix());
+    lightingShader->SetVec3("viewPos", Camera::activeCamera->transform->GetGlobalPosition());
 }
 
-void RendererManager::UpdateLight(int componentId) {
+/**
+ * @annotation
+ * Assigns lights to clusters of the active camera's view, needs to be called after lights and camera were updated
+ */
+void RendererManager::UpdateLightClusters() {
+    auto options = OptionsManager::GetInstance();
+    lightClusters->Update(Camera::activeCamera->GetComponent<Camera>()->GetViewMatrix(), fov,
+                          (float)options->width / (float)options->height, zNear, zFar);
 
-    for (int i = 0; i < spotLights.size(); ++i) {
-        if (spotLights.at(i) != nullptr && spotLights.at(i)->GetId() == componentId) {
-            UpdateSpotLight(i, shader);
-            return;
-        }
-    }
-    for (int i = 0; i < directionalLights.size(); ++i) {
-        if (directionalLights.at(i) != nullptr && directionalLights.at(i)->GetId() == componentId) {
-            UpdateDirectionalLight(i, shader);
-            return;
-        }
-    }
-    for (int i = 0; i < pointLights.size(); ++i) {
-        if (pointLights.at(i) != nullptr && pointLights.at(i)->GetId() == componentId) {
-            UpdatePointLight(i, shader);
-            return;
-        }
-    }
+    shader->Activate();
+    lightClusters->SetUniforms(shader, glm::vec2(renderSize));
+    lightingShader->Activate();
+    lightClusters->SetUniforms(lightingShader, glm::vec2(renderSize));
 }
 
 void RendererManager::RemoveLight(int componentId) {
-    for (int i = 0; i < spotLights.size(); ++i) {
-        if (spotLights.at(i) != nullptr && spotLights.at(i)->GetId() == componentId) {
-            RemoveSpotLight(i, shader);
+    for (auto&& spotLight : spotLights) {
+        if (spotLight.second != nullptr && spotLight.second->GetId() == componentId) {
+            spotLight.second.reset();
             return;
         }
     }
-    for (int i = 0; i < directionalLights.size(); ++i) {
-        if (directionalLights.at(i) != nullptr && directionalLights.at(i)->GetId() == componentId) {
-            RemoveDirectionalLight(i, shader);
+    for (auto&& directionalLight : directionalLights) {
+        if (directionalLight.second != nullptr && directionalLight.second->GetId() == componentId) {
+            directionalLight.second.reset();
             return;
         }
     }
-    for (int i = 0; i < pointLights.size(); ++i) {
-        if (pointLights.at(i) != nullptr && pointLights.at(i)->GetId() == componentId) {
-            RemovePointLight(i, shader);
+    for (auto&& pointLight : pointLights) {
+        if (pointLight.second != nullptr && pointLight.second->GetId() == componentId) {
+            pointLight.second.reset();
             return;
         }
     }
 }
 
-void RendererManager::UpdatePointLight(int lightNumber, const std::shared_ptr<Shader>& lightShader) {
-    lightShader->Activate();
-    std::shared_ptr<PointLight> pointLight = pointLights.find(lightNumber)->second;
-    std::string light = "pointLights[" + std::to_string(lightNumber) + "]";
-    lightShader->SetBool(light + ".isActive", pointLight->enabled);
-    lightShader->SetVec3(light + ".position", pointLight->GetParent()->transform->GetLocalPosition());
-    lightShader->SetFloat(light + ".constant", pointLight->GetConstant());
-    lightShader->SetFloat(light + ".linear", pointLight->GetLinear());
-    lightShader->SetFloat(light + ".quadratic", pointLight->GetQuadratic());
-    lightShader->SetVec3(light + ".ambient", pointLight->GetAmbient());
-    lightShader->SetVec3(light + ".diffuse", pointLight->GetDiffuse());
-    lightShader->SetVec3(light + ".specular", pointLight->GetSpecular());
-    lightShader->SetVec3(light + ".color", pointLight->GetColor());
-}
-
-void RendererManager::UpdateDirectionalLight(int lightNumber, const std::shared_ptr<Shader>& lightShader) {
-    lightShader->Activate();
-    std::shared_ptr<DirectionalLight> directionalLight = directionalLights.find(lightNumber)->second;
-    std::string light = "directionalLights[" + std::to_string(lightNumber) + "]";
-    lightShader->SetBool(light + ".isActive", directionalLight->enabled);
-    lightShader->SetVec3(light + ".direction", directionalLight->GetParent()->transform->GetForward());
-    lightShader->SetVec3(light + ".ambient", directionalLight->GetAmbient());
-    lightShader->SetVec3(light + ".diffuse", directionalLight->GetDiffuse());
-    lightShader->SetVec3(light + ".specular", directionalLight->GetSpecular());
-    lightShader->SetVec3(light + ".color", directionalLight->GetColor());
-}
-
-void RendererManager::UpdateSpotLight(int lightNumber, const std::shared_ptr<Shader>& lightShader) {
-    lightShader->Activate();
-    std::shared_ptr<SpotLight> spotLight = spotLights.find(lightNumber)->second;
-    std::string light = "spotLights[" + std::to_string(lightNumber) + "]";
-    lightShader->SetBool(light + ".isActive", spotLight->enabled);
-    lightShader->SetVec3(light + ".position", spotLight->GetParent()->transform->GetLocalPosition());
-    lightShader->SetVec3(light + ".direction", spotLight->GetParent()->transform->GetForward());
-    lightShader->SetFloat(light + ".cutOff", spotLight->GetCutOff());
-    lightShader->SetFloat(light + ".outerCutOff", spotLight->GetOuterCutOff());
-    lightShader->SetFloat(light + ".constant", spotLight->GetConstant());
-    lightShader->SetFloat(light + ".linear", spotLight->GetLinear());
-    lightShader->SetFloat(light + ".quadratic", spotLight->GetQuadratic());
-    lightShader->SetVec3(light + ".ambient", spotLight->GetAmbient());
-    lightShader->SetVec3(light + ".diffuse", spotLight->GetDiffuse());
-    lightShader->SetVec3(light + ".specular", spotLight->GetSpecular());
-    lightShader->SetVec3(light + ".color", spotLight->GetColor());
-}
-
-void RendererManager::RemovePointLight(int lightNumber, const std::shared_ptr<Shader>& lightShader) {
-    lightShader->Activate();
-    std::string light = "pointLights[" + std::to_string(lightNumber) + "]";
-    lightShader->SetBool(light + ".isActive", false);
-    lightShader->SetVec3(light + ".position", {0, 0, 0});
-    lightShader->SetFloat(light + ".constant", 0);
-    lightShader->SetFloat(light + ".linear", 0);
-    lightShader->SetFloat(light + ".quadratic", 0);
-    lightShader->SetVec3(light + ".ambient", {0, 0, 0});
-    lightShader->SetVec3(light + ".diffuse", {0, 0, 0});
-    lightShader->SetVec3(light + ".specular", {0, 0, 0});
-    lightShader->SetVec3(light + ".color", {0, 0, 0});
-
-    pointLights.find(lightNumber)->second.reset();
-}
-
-void RendererManager::RemoveDirectionalLight(int lightNumber, const std::shared_ptr<Shader>& lightShader) {
-    lightShader->Activate();
-    std::string light = "directionalLights[" + std::to_string(lightNumber) + "]";
-    lightShader->SetBool(light +".isActive", false);
-    lightShader->SetVec3(light + ".direction", {0, 0, 0});
-    lightShader->SetVec3(light + ".ambient", {0, 0, 0});
-    lightShader->SetVec3(light + ".diffuse", {0, 0, 0});
-    lightShader->SetVec3(light + ".specular", {0, 0, 0});
-    lightShader->SetVec3(light + ".color", {0, 0, 0});
-
-    directionalLights.find(lightNumber)->second.reset();
-}
-
-void RendererManager::RemoveSpotLight(int lightNumber, const std::shared_ptr<Shader>& lightShader) {
-    lightShader->Activate();
-    std::shared_ptr<SpotLight> spotLight = spotLights.find(lightNumber)->second;
-    std::string light = "spotLights[" + std::to_string(lightNumber) + "]";
-    lightShader->SetBool(light +".isActive", false);
-    lightShader->SetVec3(light + ".position", {0, 0, 0});
-    lightShader->SetVec3(light + ".direction", {0, 0, 0});
-    lightShader->SetFloat(light + ".cutOff", 0);
-    lightShader->SetFloat(light + ".outerCutOff", 0);
-    lightShader->SetFloat(light + ".constant", 0);
-    lightShader->SetFloat(light + ".linear", 0);
-    lightShader->SetFloat(light + ".quadratic", 0);
-    lightShader->SetVec3(light + ".ambient", {0, 0, 0});
-    lightShader->SetVec3(light + ".diffuse", {0, 0, 0});
-    lightShader->SetVec3(light + ".specular", {0, 0, 0});
-    lightShader->SetVec3(light + ".color", {0, 0, 0});
-
-    spotLights.find(lightNumber)->second.reset();
-}
-
 void RendererManager::SetFov(float fov) {
     RendererManager::fov = fov;
     UpdateProjection();
@@ -228,4 +617,7 @@ void RendererManager::ClearBuffer() {
         drawBuffer[i] = nullptr;
     }
     bufferIterator = 0;
+    for (auto& buffer : commandBuffers) {
+        buffer.Clear();
+    }
 }
@@ -16,9 +16,26 @@
 #include "Components/Scripts/Menus/LoadGameMenu.h"
 #include "Components/Audio/AudioSource.h"
 #include "Components/UI/Image.h"
+#include "Components/UI/Text.h"
+#include "EngineManagers/HIDManager.h"
 #include "EngineManagers/RandomnessManager.h"
-
+#include "EngineManagers/RendererManager.h"
+#include "EngineManagers/ShadowManager.h"
+#include "EngineManagers/FontManager.h"
+#include "EngineManagers/TextureManager.h"
+#include "LowLevelClasses/StaticGeometryPool.h"
+#include "LowLevelClasses/MappedFile.h"
+#include "LowLevelClasses/VirtualFileSystem.h"
+#include "LowLevelClasses/MeshCache.h"
+#include "LowLevelClasses/AnimationClip.h"
+#include "LowLevelClasses/StaticModel.h"
+#include "LowLevelClasses/AnimationModel.h"
+
+#include <algorithm>
 #include <fstream>
+#include <string_view>
+#include <thread>
+#include <unordered_set>
 
 
 #ifdef DEBUG
@@ -47,41 +64,28 @@ void SceneManager::InitializeScene() {
 
     loadingScreenNumber = RandomnessManager::GetInstance()->GetInt(1, 8);
 
-    glClearColor(0, 0, 0, 1);
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-    glEnable(GL_DEPTH_TEST);
     loadingScreen = GameObject::Instantiate("LoadingScreen", SceneManager::GetInstance()->activeScene)->AddComponent<Image>();
     loadingScreen->LoadTexture(0, 0, "UI/LoadingScreens/"+std::to_string(loadingScreenNumber)+".png");
-    loadingScreen->Draw();
-    deleteLoadingScreen = true;
-    glfwSwapBuffers(GloomEngine::GetInstance()->window);
-
-    std::filesystem::path path = std::filesystem::current_path();
-    path /= "res";
-    path /= "ProjectConfig";
-
-    SceneManager::GetInstance()->LoadStaticObjects(path.string(),"map0");
+    // destroyed with the loading screen
+    loadingProgress = GameObject::Instantiate("LoadingProgress", loadingScreen->GetParent())->AddComponent<Text>();
+    loadingProgress->LoadFont("0%", 1800, 40, 32, glm::vec3(1.0f));
+    // the loading screen is drawn before any frame could upload it
+    TextureManager::GetInstance()->FinishUploads();
+    DrawLoadingScreen();
 }
 
 void SceneManager::LoadScene(const std::string& scene) {
+    // a scene requested while another one loads replaces it
+    if (IsLoading()) StopLoading();
+    // fonts are rasterized on workers while the old scene is cleared and the new one loads
+    FontManager::GetInstance()->Prewarm(scene);
+
     if (scene == "Scene") {
         file = GloomEngine::GetInstance()->FindGameObjectWithName("LoadGameMenu")->GetComponent<LoadGameMenu>()->file;
-        ClearScene();
-        InitializeScene();
-        GloomEngine::GetInstance()->game->activeCamera = Camera::activeCamera;
-        GloomEngine::GetInstance()->game->activeScene = activeScene;
-        GloomEngine::GetInstance()->game->InitializeGame();
-        auto audio = activeScene->AddComponent<AudioSource>();
-        audio->LoadAudioData("res/sounds/direct/town.wav", AudioType::Direct);
-        audio->IsLooping(true);
-        audio->SetGain(0.2f);
-        audio->PlaySoundAfterStart(true);
-        glClearColor(0, 0, 0, 1);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-        glEnable(GL_DEPTH_TEST);
-        loadingScreen->LoadTexture(0, 0, "UI/LoadingScreens/"+std::to_string(loadingScreenNumber)+"_loaded.png");
-        loadingScreen->Draw();
-        glfwSwapBuffers(GloomEngine::GetInstance()->window);
+        // the old scene is cleared on the next frame, not in the middle of its components' updates
+        loadStage = SceneLoadStage::Start;
+        loadStart = std::chrono::steady_clock::now();
+        return;
     } else if (scene == "MainMenu") {
         ClearScene();
         activeScene = GameObject::Instantiate("MainMenuScene", nullptr, Tags::SCENE);
@@ -91,6 +95,362 @@ void SceneManager::LoadScene(const std::string& scene) {
         audio->PlaySoundAfterStart(true);
         Prefab::Instantiate<MainMenuPrefab>();
     }
+    PrepareScene();
+}
+
+/**
+ * @annotation
+ * Runs steps of the loading scene within the frame's budget and shows its progress, the map is parsed and
+ * its models are imported on workers meanwhile. Escape cancels the load.
+ */
+void SceneManager::UpdateLoading() {
+#ifdef DEBUG
+    ZoneScopedNC("Scene loading", 0xDC143C);
+#endif
+    HIDManager::GetInstance()->ManageInput();
+    if (loadStage != SceneLoadStage::Start && HIDManager::GetInstance()->IsKeyDown(Key::KEY_ESC)) {
+        CancelLoading();
+        // the escape shouldn't reach the main menu
+        HIDManager::GetInstance()->ManageInput();
+        return;
+    }
+
+    RunLoadingSteps();
+    if (!IsLoading()) return;
+
+    // images of objects created so far are uploaded meanwhile instead of all at once when the scene is loaded
+    TextureManager::GetInstance()->Update();
+    DrawLoadingScreen();
+}
+
+void SceneManager::CancelLoading() {
+    if (!IsLoading()) return;
+    spdlog::info("Scene loading cancelled at " + std::to_string((int)(GetLoadingProgress() * 100)) + "%");
+    LoadScene("MainMenu");
+    loadingScreen.reset();
+}
+
+bool SceneManager::IsLoading() const {
+    return loadStage != SceneLoadStage::None;
+}
+
+float SceneManager::GetLoadingProgress() const {
+    // rough shares of the load: map 5%, models 40%, static objects 25%, animations 10%, game 15%, finishing 5%
+    switch (loadStage) {
+        case SceneLoadStage::None:
+            return 1.0f;
+        case SceneLoadStage::Start:
+            return 0.0f;
+        case SceneLoadStage::Map:
+            return 0.05f;
+        case SceneLoadStage::Models:
+            if (preloadingModels.empty()) return 0.45f;
+            return 0.05f + 0.4f * (float)createdModelsCount / (float)preloadingModels.size();
+        case SceneLoadStage::StaticObjects:
+            if (loadingObjects->GetObjectsCount() == 0) return 0.7f;
+            return 0.45f + 0.25f * (float)loadedObjectsCount / (float)loadingObjects->GetObjectsCount();
+        case SceneLoadStage::Animations:
+            return 0.7f + 0.1f * (float)loadedAnimationsCount / (float)Game::GetAnimations().size();
+        case SceneLoadStage::Game:
+            return 0.8f;
+        case SceneLoadStage::Finish:
+            return 0.95f;
+    }
+    return 0.0f;
+}
+
+void SceneManager::RunLoadingSteps() {
+    auto start = std::chrono::steady_clock::now();
+    // at least one step a frame, a step longer than the budget can't stall the load
+    do {
+        if (!RunLoadingStep()) return;
+    } while (std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count() < SCENE_LOAD_BUDGET);
+}
+
+bool SceneManager::RunLoadingStep() {
+    auto engine = GloomEngine::GetInstance();
+
+    switch (loadStage) {
+        case SceneLoadStage::Start: {
+            std::filesystem::path path = std::filesystem::current_path();
+            path /= "res";
+            path /= "ProjectConfig";
+            loadingMap = std::async(std::launch::async, [this, path] { return LoadMap(path.string(), "map0"); });
+
+            ClearScene();
+            InitializeScene();
+            loadStage = SceneLoadStage::Map;
+            // the loading screen is shown before anything else is created
+            return false;
+        }
+        case SceneLoadStage::Map:
+            if (loadingMap.wait_for(std::chrono::seconds(0)) != std::future_status::ready) return false;
+            loadingObjects = loadingMap.get();
+            loadingMapObject = GameObject::Instantiate("map");
+            PreloadModels();
+            ReadAheadAnimations();
+            loadStage = SceneLoadStage::Models;
+            return true;
+        case SceneLoadStage::Models:
+            if (createdModelsCount < preloadingModels.size()) return CreatePreloadedModel();
+            spdlog::info("Preloaded " + std::to_string(preloadingModels.size()) + " models on " +
+                         std::to_string(preloadWorkers.size()) + " workers in " +
+                         std::to_string(std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - preloadStart).count()) +
+                         " ms, " + std::to_string((float)preloadWorkTime / 1000.0f) + " ms of work on the workers");
+            loadStage = SceneLoadStage::StaticObjects;
+            return true;
+        case SceneLoadStage::StaticObjects:
+            if (loadedObjectsCount < loadingObjects->GetObjectsCount()) {
+                LoadStaticObject(loadingMapObject, *loadingObjects, loadingObjects->GetObject(loadedObjectsCount));
+                ++loadedObjectsCount;
+                return true;
+            }
+            loadStage = SceneLoadStage::Animations;
+            return true;
+        case SceneLoadStage::Animations:
+            if (loadedAnimationsCount < Game::GetAnimations().size()) {
+                Animator::LoadAnimation(Game::GetAnimations()[loadedAnimationsCount]);
+                ++loadedAnimationsCount;
+                return true;
+            }
+            loadStage = SceneLoadStage::Game;
+            return true;
+        case SceneLoadStage::Game:
+            engine->game->activeCamera = Camera::activeCamera;
+            engine->game->activeScene = activeScene;
+            engine->game->InitializeGame();
+            loadStage = SceneLoadStage::Finish;
+            return true;
+        case SceneLoadStage::Finish:
+            FinishLoading();
+            return false;
+        case SceneLoadStage::None:
+            return false;
+    }
+    return false;
+}
+
+/**
+ * @annotation
+ * Touches every page of a file on a worker, so the main thread finds it in the system's cache
+ */
+static void ReadAhead(const std::string& path, const std::atomic<bool>& isCancelled) {
+    MappedFile file;
+    if (!file.Open(path)) return;
+    const unsigned char* data = file.GetData();
+    volatile unsigned char sum = 0;
+    for (size_t i = 0; i < file.GetSize() && !isCancelled; i += 4096) {
+        sum += data[i];
+    }
+}
+
+void SceneManager::PreloadModels() {
+    preloadStart = std::chrono::steady_clock::now();
+    auto assetManager = AssetManager::GetInstance();
+    std::unordered_set<std::string> modelPaths;
+    auto addModel = [&](const std::string& path, bool isSkinned) {
+        if (path.empty() || modelPaths.contains(path)) return;
+        modelPaths.insert(path);
+        // kept from an earlier scene, there is nothing to import
+        if (isSkinned) {
+            auto cached = assetManager->Acquire<AnimationModel>("res/models/" + path);
+            if (cached) {
+                loadedAnimationModels.push_back(std::move(cached));
+                return;
+            }
+        }
+        else {
+            auto cached = assetManager->Acquire<StaticModel>("res/models/" + path);
+            if (cached) {
+                loadedModels.push_back(std::move(cached));
+                return;
+            }
+        }
+        preloadingModels.push_back({path, isSkinned, {}});
+    };
+    for (uint32_t i = 0; i < loadingObjects->GetObjectsCount(); ++i) {
+        addModel(std::string(loadingObjects->GetString(loadingObjects->GetObject(i).modelPath)), false);
+    }
+    for (const auto& path : Game::GetModels()) addModel(path, false);
+    for (const auto& path : Game::GetAnimationModels()) addModel(path, true);
+    if (preloadingModels.empty()) return;
+
+    // every worker takes the next model until none is left
+    int numberOfThreads = (int)std::max(std::thread::hardware_concurrency() / 2, 1u);
+    numberOfThreads = std::min(numberOfThreads, (int)preloadingModels.size());
+    for (int i = 0; i < numberOfThreads; ++i) {
+        preloadWorkers.push_back(std::async(std::launch::async, [this] {
+            for (size_t index = nextPreloadedModel++; index < preloadingModels.size() && !isPreloadCancelled;
+                 index = nextPreloadedModel++) {
+                PreloadedModel model = preloadingModels[index];
+                auto modelStart = std::chrono::steady_clock::now();
+                try {
+                    PreloadModel(model);
+                }
+                catch (const std::exception& e) {
+                    // still pushed, the main thread loads it the usual way
+                    spdlog::error("Failed to preload model " + model.path + ": " + e.what());
+                    model.texturePaths.clear();
+                }
+                catch (...) {
+                    spdlog::error("Failed to preload model " + model.path);
+                    model.texturePaths.clear();
+                }
+                preloadWorkTime += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - modelStart).count();
+                std::lock_guard<std::mutex> lock(preloadMutex);
+                preloadedModels.push_back(std::move(model));
+            }
+        }));
+    }
+}
+
+/**
+ * @annotation
+ * Imports the model with Assimp on a worker unless it's cooked already, then reads its cooked file into the
+ * system's cache and collects its textures, so the main thread only creates GL buffers from the mapped file
+ */
+void SceneManager::PreloadModel(PreloadedModel& model) {
+#ifdef DEBUG
+    ZoneScopedNC("Preload model", 0xDC143C);
+#endif
+    std::string path = "res/models/" + model.path;
+    bool isCooked = model.isSkinned ? AnimationModel::Cook(path) : StaticModel::Cook(path);
+    CookedModel cooked;
+    if (!isCooked || !cooked.Open(path, model.isSkinned)) return;
+
+    std::string directory = path.substr(0, path.find_last_of('/'));
+    std::unordered_set<std::string_view> textures;
+    for (uint32_t i = 0; i < cooked.GetMeshesCount(); ++i) {
+        const CookedMesh& mesh = cooked.GetMesh(i);
+        for (uint32_t j = 0; j < mesh.texturesCount; ++j) {
+            std::string_view texture = cooked.GetString(cooked.GetTexture(mesh.firstTexture + j).path);
+            if (textures.insert(texture).second) model.texturePaths.push_back(directory + "/" + std::string(texture));
+        }
+    }
+    ReadAhead(CookedModel::GetCookedPath(path, model.isSkinned), isPreloadCancelled);
+}
+
+bool SceneManager::CreatePreloadedModel() {
+    PreloadedModel model;
+    {
+        std::lock_guard<std::mutex> lock(preloadMutex);
+        if (preloadedModels.empty()) return false;
+        model = std::move(preloadedModels.front());
+        preloadedModels.pop_front();
+    }
+#ifdef DEBUG
+    ZoneScopedNC("Create preloaded model", 0xDC143C);
+#endif
+    // the model acquires its textures while they are decoded on workers instead of decoding them itself
+    auto textureManager = TextureManager::GetInstance();
+    std::vector<unsigned int> textures;
+    for (const auto& texturePath : model.texturePaths) {
+        int width, height, nrChannels;
+        unsigned int texture = textureManager->LoadTextureAsync(texturePath, TextureWrap::Repeat, width, height, nrChannels);
+        if (texture != 0) textures.push_back(texture);
+    }
+
+    std::string path = "res/models/" + model.path;
+    auto assetManager = AssetManager::GetInstance();
+    if (model.isSkinned) {
+        loadedAnimationModels.push_back(assetManager->Load<AnimationModel>(path, [&path] {
+            return std::make_shared<AnimationModel>(path, RendererManager::GetInstance()->shader);
+        }));
+    }
+    else {
+        loadedModels.push_back(assetManager->Load<StaticModel>(path, [&path] {
+            return std::make_shared<StaticModel>(path, RendererManager::GetInstance()->shader, GL_TRIANGLES);
+        }));
+    }
+    for (auto texture : textures) textureManager->Release(texture);
+    ++createdModelsCount;
+    return true;
+}
+
+void SceneManager::ReadAheadAnimations() {
+    // in the order the main thread loads them, cooked files are preferred like the loaders do
+    std::vector<std::pair<std::string, std::string>> files;
+    for (const auto& animation : Game::GetAnimations()) {
+        std::string path = "res/models/" + animation;
+        files.emplace_back(AnimationClip::GetCookedPath(path), path);
+    }
+
+    readAhead = std::async(std::launch::async, [this, files = std::move(files)] {
+        std::error_code error;
+        for (const auto& [cookedPath, path] : files) {
+            if (isPreloadCancelled) return;
+            ReadAhead(std::filesystem::exists(cookedPath, error) ? cookedPath : path, isPreloadCancelled);
+        }
+    });
+}
+
+void SceneManager::FinishLoading() {
+    auto audio = activeScene->AddComponent<AudioSource>();
+    audio->LoadAudioData("res/sounds/direct/town.wav", AudioType::Direct);
+    audio->IsLooping(true);
+    audio->SetGain(0.2f);
+    audio->PlaySoundAfterStart(true);
+
+    glClearColor(0, 0, 0, 1);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    glEnable(GL_DEPTH_TEST);
+    loadingScreen->LoadTexture(0, 0, "UI/LoadingScreens/"+std::to_string(loadingScreenNumber)+"_loaded.png");
+    TextureManager::GetInstance()->FinishUploads();
+    loadingScreen->Draw();
+    glfwSwapBuffers(GloomEngine::GetInstance()->window);
+    deleteLoadingScreen = true;
+
+    PrepareScene();
+    StopLoading();
+    spdlog::info("Scene loaded in " + std::to_string(std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - loadStart).count()) + " ms");
+}
+
+void SceneManager::PrepareScene() {
+    // models loaded after this point are drawn outside of the pool
+    RendererManager::GetInstance()->staticGeometryPool->Build(Renderer::models);
+    ShadowManager::GetInstance()->InvalidateStaticCache();
+    FontManager::GetInstance()->FinishSceneLoad();
+    // images decoded while the scene loaded are ready on its first frame
+    TextureManager::GetInstance()->FinishUploads();
+}
+
+void SceneManager::DrawLoadingScreen() {
+    loadingProgress->text = std::to_string((int)(GetLoadingProgress() * 100)) + "%";
+
+    glClearColor(0, 0, 0, 1);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    // the progress goes over the image
+    glDisable(GL_DEPTH_TEST);
+    loadingScreen->Draw();
+    loadingProgress->Draw();
+    glEnable(GL_DEPTH_TEST);
+    glfwSwapBuffers(GloomEngine::GetInstance()->window);
+}
+
+void SceneManager::StopLoading() {
+    isPreloadCancelled = true;
+    if (loadingMap.valid()) loadingMap.wait();
+    if (readAhead.valid()) readAhead.wait();
+    for (auto& worker : preloadWorkers) worker.wait();
+    loadingMap = {};
+    readAhead = {};
+    preloadWorkers.clear();
+    isPreloadCancelled = false;
+
+    preloadingModels.clear();
+    preloadedModels.clear();
+    nextPreloadedModel = 0;
+    preloadWorkTime = 0;
+    createdModelsCount = 0;
+    loadedModels.clear();
+    loadedAnimationModels.clear();
+
+    loadStage = SceneLoadStage::None;
+    loadingObjects.reset();
+    loadingMapObject.reset();
+    loadingProgress.reset();
+    loadedObjectsCount = 0;
+    loadedAnimationsCount = 0;
 }
 
 void SceneManager::ClearScene() {
@@ -101,11 +461,13 @@ void SceneManager::ClearScene() {
     parents.clear();
     Animator::animationModels.clear();
     Animator::animations.clear();
+    RendererManager::GetInstance()->staticGeometryPool->Clear();
     Renderer::models.clear();
     GameObject::Destroy(activeScene);
 }
 
 void SceneManager::Free() {
+    StopLoading();
     ClearScene();
     Camera::activeCamera = nullptr;
     activeScene = nullptr;
@@ -123,85 +485,104 @@ void SceneManager::SaveStaticObjects(const std::string &dataDirectoryPath, const
     }
 
     SaveMap(staticObjectsData,dataDirectoryPath,dataFileName);
-}
-
-void SceneManager::LoadStaticObjects(const std::string &dataDirectoryPath, const std::string &dataFileName) {
-    std::vector<std::shared_ptr<StaticObjectData>> staticObjectsData;
-    staticObjectsData = LoadMap(dataDirectoryPath, dataFileName);
 
-    auto map = GameObject::Instantiate("map");
+    // cooked right away, so the next load doesn't parse the saved json
+    MapCooker cooker;
+    for (const auto& object : staticObjectsData) cooker.AddObject(*object);
+    std::filesystem::path path(dataDirectoryPath);
+    path /= dataFileName + ".json";
+    cooker.Write(VirtualFileSystem::NormalizePath(path.string()));
+}
 
+void SceneManager::LoadStaticObject(const std::shared_ptr<GameObject>& map, const CookedMap& cookedMap, const CookedMapObject& object) {
+    // strings are only copied out of the map where objects keep them
+    std::string uniqueName(cookedMap.GetString(object.uniqueName));
     std::shared_ptr<GameObject> newGameObject;
-    for (const auto &object: staticObjectsData) {
-        newGameObject.reset();
-        if(object->name == "House") {
-            newGameObject = Prefab::Instantiate<House>(object->uniqueName);
-        }
-        if(object->name == "Shop") {
-            newGameObject = Prefab::Instantiate<Shop>(object->uniqueName);
-        }
-        if(object->name == "SavePoint") {
-            newGameObject = Prefab::Instantiate<SavePoint>(object->uniqueName);
-        }
-        if(object->name == "InvisibleBlock") {
-            newGameObject = Prefab::Instantiate<InvisibleBlock>(object->uniqueName);
-        }
-        if(newGameObject) {
-
-            std::size_t found = object->uniqueName.find('_');
-            std::string parentName = object->uniqueName.substr(0, found);
-
-            if (found != std::string::npos) {
-                if (!parents.contains(parentName)) {
-                    auto p = GameObject::Instantiate(parentName, map);
-                    parents.insert({parentName, p});
-                }
-                newGameObject->SetParent(parents.at(parentName));
-            }
+    switch (object.prefab) {
+        case PrefabType::House:
+            newGameObject = Prefab::Instantiate<House>(uniqueName);
+            break;
+        case PrefabType::Shop:
+            newGameObject = Prefab::Instantiate<Shop>(uniqueName);
+            break;
+        case PrefabType::SavePoint:
+            newGameObject = Prefab::Instantiate<SavePoint>(uniqueName);
+            break;
+        case PrefabType::InvisibleBlock:
+            newGameObject = Prefab::Instantiate<InvisibleBlock>(uniqueName);
+            break;
+        case PrefabType::None:
+            break;
+    }
+    if(!newGameObject) return;
 
-            //if(!object->uniqueName.empty())
-            newGameObject->transform->SetLocalPosition(object->position);
-            newGameObject->transform->SetLocalRotation(object->rotation);
-            newGameObject->transform->SetLocalScale(object->scale);
+    std::size_t found = uniqueName.find('_');
+    std::string parentName = uniqueName.substr(0, found);
 
-            if (newGameObject->GetComponent<Renderer>()) {
-                std::shared_ptr<Renderer> objectRenderer = newGameObject->GetComponent<Renderer>();
-                objectRenderer->LoadModel(object->modelPath);
-            }
+    if (found != std::string::npos) {
+        if (!parents.contains(parentName)) {
+            auto p = GameObject::Instantiate(parentName, map);
+            parents.insert({parentName, p});
+        }
+        newGameObject->SetParent(parents.at(parentName));
+    }
 
-            if (newGameObject->GetComponent<BoxCollider>()) {
-                std::shared_ptr<BoxCollider> objectColider = newGameObject->GetComponent<BoxCollider>();
-                objectColider->SetSize(object->coliderSize);
-                objectColider->SetOffset(object->coliderOffset);
-            }
+    //if(!object.uniqueName.empty())
+    newGameObject->transform->SetLocalPosition(glm::make_vec3(object.position));
+    newGameObject->transform->SetLocalRotation(glm::make_vec3(object.rotation));
+    newGameObject->transform->SetLocalScale(glm::make_vec3(object.scale));
 
-        }
+    if (newGameObject->GetComponent<Renderer>()) {
+        std::shared_ptr<Renderer> objectRenderer = newGameObject->GetComponent<Renderer>();
+        objectRenderer->LoadModel(std::string(cookedMap.GetString(object.modelPath)));
+        objectRenderer->isStatic = true;
     }
 
-    staticObjectsData.clear();
+    if (newGameObject->GetComponent<BoxCollider>()) {
+        std::shared_ptr<BoxCollider> objectColider = newGameObject->GetComponent<BoxCollider>();
+        objectColider->SetSize(glm::make_vec3(object.coliderSize));
+        objectColider->SetOffset(glm::make_vec3(object.coliderOffset));
+    }
 }
 
-std::vector<std::shared_ptr<StaticObjectData>> SceneManager::LoadMap(std::string dataDirectoryPath, std::string dataFileName) {
+std::shared_ptr<CookedMap> SceneManager::LoadMap(std::string dataDirectoryPath, std::string dataFileName) {
     std::filesystem::path path(dataDirectoryPath);
     path /= dataFileName + ".json";
 #ifdef DEBUG
     spdlog::info("Save path: " + path.string());
 #endif
+    auto start = std::chrono::steady_clock::now();
+    // cooked maps are named after the json's path relative to the working directory
+    std::string jsonPath = VirtualFileSystem::NormalizePath(path.string());
+    auto cookedMap = std::make_shared<CookedMap>();
+    if (cookedMap->Open(jsonPath)) {
+        spdlog::info("Cooked map read in " + std::to_string(std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count()) + " ms");
+        return cookedMap;
+    }
 
     std::vector<std::shared_ptr<StaticObjectData>> mapData = {};
+    bool isParsed = false;
 
     try {
-        std::ifstream input(path);
+        VirtualFile input;
+        if (!VirtualFileSystem::GetInstance()->Open(path.string(), input)) throw std::runtime_error("missing map");
 
-        nlohmann::json json;
-        input >> json;
+        nlohmann::json json = nlohmann::json::parse(input.GetText());
         from_json(json, mapData);
+        isParsed = true;
     }
     catch (std::exception e) {
         spdlog::info("Failed to read a file content at path: " + path.string());
     }
 
-    return mapData;
+    // the next load reads the cooked map instead, it's used from memory if it can't be written
+    MapCooker cooker;
+    for (const auto& object : mapData) cooker.AddObject(*object);
+    std::vector<unsigned char> content = cooker.Cook(jsonPath);
+    if (isParsed) CookedSource::Write(CookedMap::GetCookedPath(jsonPath), content);
+    cookedMap->Load(std::move(content));
+    spdlog::info("Map parsed from json and cooked in " + std::to_string(std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count()) + " ms");
+    return cookedMap;
 }
 
 void SceneManager::SaveMap(std::vector<std::shared_ptr<StaticObjectData>> mapData, std::string dataDirectoryPath, std::string dataFileName) {
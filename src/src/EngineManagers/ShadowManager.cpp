@@ -1,10 +1,17 @@
 #include "EngineManagers/ShadowManager.h"
 #include "GloomEngine.h"
 #include "EngineManagers/RendererManager.h"
+#include "EngineManagers/OptionsManager.h"
 #include "GameObjectsAndPrefabs/GameObject.h"
 #include "Components/Renderers/Drawable.h"
+#include "Components/Renderers/Renderer.h"
+#include "Components/Renderers/Camera.h"
 #include "Components/Renderers/Lights/DirectionalLight.h"
 #include "LowLevelClasses/Shader.h"
+#include "Other/FrustumCulling.h"
+
+#include <algorithm>
+#include <cmath>
 
 #ifdef DEBUG
 #include <tracy/Tracy.hpp>
@@ -12,27 +19,7 @@
 
 ShadowManager::ShadowManager() {
     shadowShader = std::make_shared<Shader>("shadowMap.vert", "shadowMap.frag");
-
-    glGenFramebuffers(1, &depthMapFBO);
-    // create depth texture
-    glGenTextures(1, &depthMap);
-    glBindTexture(GL_TEXTURE_2D, depthMap);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, shadowResolution, shadowResolution, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
-    float borderColor[] = { 1.0, 1.0, 1.0, 1.0 };
-    glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
-    // attach depth texture as FBO's depth buffer
-    glBindFramebuffer(GL_FRAMEBUFFER, depthMapFBO);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, depthMap, 0);
-    glDrawBuffer(GL_NONE);
-    glReadBuffer(GL_NONE);
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-
-    RendererManager::GetInstance()->shader->Activate();
-    RendererManager::GetInstance()->shader->SetInt("shadowMap", depthMap);
+    CreateShadowMaps();
 }
 
 ShadowManager::~ShadowManager() {
@@ -46,50 +33,227 @@ ShadowManager *ShadowManager::GetInstance() {
     return shadowManager;
 }
 
+/**
+ * @annotation
+ * (Re)creates cascade textures with current resolution and cascades count
+ */
+void ShadowManager::CreateShadowMaps() {
+    if (depthMapFBO == 0) glGenFramebuffers(1, &depthMapFBO);
+    if (depthMap != 0) glDeleteTextures(1, &depthMap);
+    if (staticDepthMap != 0) glDeleteTextures(1, &staticDepthMap);
+
+    cascadeResolution = shadowResolution / 2;
+    allocatedCascadesCount = std::clamp(cascadesCount, 1, MAX_CASCADES);
+
+    unsigned int* maps[2] = {&depthMap, &staticDepthMap};
+    for (auto map : maps) {
+        // create depth texture
+        glGenTextures(1, map);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, *map);
+        glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_DEPTH_COMPONENT32F, (int)cascadeResolution,
+                     (int)cascadeResolution, allocatedCascadesCount, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+        float borderColor[] = { 1.0, 1.0, 1.0, 1.0 };
+        glTexParameterfv(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BORDER_COLOR, borderColor);
+    }
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+    // depth layer is attached for every drawn cascade
+    glBindFramebuffer(GL_FRAMEBUFFER, depthMapFBO);
+    glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, depthMap, 0, 0);
+    glDrawBuffer(GL_NONE);
+    glReadBuffer(GL_NONE);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    RendererManager::GetInstance()->shader->Activate();
+    RendererManager::GetInstance()->shader->SetInt("shadowMap", SHADOW_MAP_UNIT);
+
+    InvalidateStaticCache();
+}
+
+/**
+ * @annotation
+ * Static casters are drawn again into every cascade in the next frame, needs to be called
+ * after static objects were added, moved or removed
+ */
+void ShadowManager::InvalidateStaticCache() {
+    for (bool& isValid : isStaticCacheValid) {
+        isValid = false;
+    }
+}
+
+unsigned int ShadowManager::GetCascadeResolution() const {
+    return cascadeResolution;
+}
+
 void ShadowManager::PrepareShadow() {
     {
 #ifdef DEBUG
-        ZoneScopedNC("Calc mat4 and pass to shader", 0xFFD733);
+        ZoneScopedNC("Calc cascades and pass to shader", 0xFFD733);
 #endif
-        glm::mat4 lightProjection, lightView;
-        glm::mat4 lightSpaceMatrix;
-        glm::vec3 lightPos = RendererManager::GetInstance()->directionalLights[0]->GetParent()->transform->GetGlobalPosition();
-//    lightProjection = glm::perspective(glm::radians(45.0f), (GLfloat)shadowWidth / (GLfloat)shadowHeight, 0.1f, 10.0f); // note that if you use a perspective projection matrix you'll have to change the light position as the current light position isn't enough to reflect the whole scene
-        lightProjection = glm::ortho(-100.0f, 100.0f, -100.0f, 100.0f, nearPlane, farPlane);
-
-        glm::vec3 playerPos = GloomEngine::GetInstance()->FindGameObjectWithName(
-                "Player")->transform->GetGlobalPosition();
-        glm::vec3 upVector = RendererManager::GetInstance()->directionalLights[0]->GetParent()->transform->GetUp();
-        lightView = glm::lookAt(playerPos + lightPos, playerPos, upVector);
-        lightSpaceMatrix = lightProjection * lightView;
-
-        // render scene from light's point of view
-        shadowShader->Activate();
-        shadowShader->SetMat4("lightSpaceMatrix", lightSpaceMatrix);
-
-        RendererManager::GetInstance()->shader->Activate();
-        RendererManager::GetInstance()->shader->SetMat4("lightSpaceMatrix", lightSpaceMatrix);
+        UpdateCascades();
+
+        // shadows are sampled by forward shading and by the deferred lighting pass
+        for (const auto& shader : {RendererManager::GetInstance()->shader, RendererManager::GetInstance()->lightingShader}) {
+            shader->Activate();
+            shader->SetInt("cascadesCount", allocatedCascadesCount);
+            for (int i = 0; i < allocatedCascadesCount; ++i) {
+                shader->SetFloat("cascadeSplits[" + std::to_string(i) + "]", cascadeSplits[i]);
+                shader->SetMat4("lightSpaceMatrices[" + std::to_string(i) + "]", lightSpaceMatrices[i]);
+            }
+        }
     }
     {
 #ifdef DEBUG
         ZoneScopedNC("Draw objects", 0xFFD733);
 #endif
-        glViewport(0, 0, shadowResolution, shadowResolution);
+        const auto resolution = (int)GetCascadeResolution();
+        glViewport(0, 0, resolution, resolution);
         glBindFramebuffer(GL_FRAMEBUFFER, depthMapFBO);
-        glClear(GL_DEPTH_BUFFER_BIT);
         glEnable(GL_CULL_FACE);
         glCullFace(GL_FRONT);
 
-        for (int i = 0; i < RendererManager::GetInstance()->bufferIterator; ++i) {
-            std::shared_ptr<Drawable> object = RendererManager::GetInstance()->drawBuffer[i];
-            if (object->drawShadows) object->Draw(shadowShader);
+        for (int i = 0; i < allocatedCascadesCount; ++i) {
+            shadowShader->Activate();
+            shadowShader->SetMat4("lightSpaceMatrix", lightSpaceMatrices[i]);
+
+            if (!isStaticCacheValid[i]) {
+#ifdef DEBUG
+                ZoneScopedNC("Draw static casters", 0xFFD733);
+#endif
+                glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, staticDepthMap, 0, i);
+                glClear(GL_DEPTH_BUFFER_BIT);
+                DrawStaticCasters(i);
+                isStaticCacheValid[i] = true;
+            }
+
+            // dynamic casters are drawn on top of the cached static ones
+            glCopyImageSubData(staticDepthMap, GL_TEXTURE_2D_ARRAY, 0, 0, 0, i,
+                               depthMap, GL_TEXTURE_2D_ARRAY, 0, 0, 0, i, resolution, resolution, 1);
+            glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, depthMap, 0, i);
+            RendererManager::GetInstance()->DrawDynamicObjects(shadowShader);
         }
 
         glDisable(GL_CULL_FACE);
         glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+        glActiveTexture(GL_TEXTURE0 + SHADOW_MAP_UNIT);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, depthMap);
+        glActiveTexture(GL_TEXTURE0);
+    }
+}
+
+/**
+ * @annotation
+ * Splits camera frustum up to farPlane between cascades and fits an orthographic projection around every part.
+ * Projections keep their size and move in whole snap steps in light space, so static casters stay valid
+ * until a cascade snaps to the next step.
+ */
+void ShadowManager::UpdateCascades() {
+    auto rendererManager = RendererManager::GetInstance();
+    auto sun = rendererManager->directionalLights[0]->GetParent();
+
+    // light shines from sun's position towards the origin
+    glm::vec3 lightDirection = -glm::normalize(sun->transform->GetGlobalPosition());
+    if (glm::distance(lightDirection, cachedLightDirection) > 0.0001f) {
+        cachedLightDirection = lightDirection;
+        InvalidateStaticCache();
+    }
+    glm::mat4 lightRotation = glm::lookAt(glm::vec3(0.0f), lightDirection, sun->transform->GetUp());
+
+    glm::mat4 view = Camera::activeCamera->GetComponent<Camera>()->GetViewMatrix();
+    float aspect = (float)OptionsManager::GetInstance()->width / (float)OptionsManager::GetInstance()->height;
+    float cameraNear = rendererManager->zNear;
+
+    for (int i = 0; i < allocatedCascadesCount; ++i) {
+        float part = (float)(i + 1) / (float)allocatedCascadesCount;
+        float logarithmicSplit = cameraNear * std::pow(farPlane / cameraNear, part);
+        float uniformSplit = cameraNear + (farPlane - cameraNear) * part;
+        cascadeSplits[i] = splitLambda * logarithmicSplit + (1.0f - splitLambda) * uniformSplit;
+    }
+
+    for (int i = 0; i < allocatedCascadesCount; ++i) {
+        float sliceNear = i == 0 ? cameraNear : cascadeSplits[i - 1];
+        glm::mat4 inverseSlice = glm::inverse(glm::perspective(glm::radians(rendererManager->fov), aspect,
+                                                               sliceNear, cascadeSplits[i]) * view);
+
+        glm::vec3 corners[8];
+        glm::vec3 center = glm::vec3(0.0f);
+        for (int j = 0; j < 8; ++j) {
+            glm::vec4 corner = inverseSlice * glm::vec4(j & 1 ? 1.0f : -1.0f, j & 2 ? 1.0f : -1.0f,
+                                                        j & 4 ? 1.0f : -1.0f, 1.0f);
+            corners[j] = glm::vec3(corner) / corner.w;
+            center += corners[j] / 8.0f;
+        }
+
+        // bounding sphere keeps the projection size independent of camera rotation
+        float radius = 0.0f;
+        for (const auto& corner : corners) {
+            radius = std::max(radius, glm::distance(corner, center));
+        }
+        radius = std::ceil(radius * 16.0f) / 16.0f;
+
+        float snapStep = 2.0f * radius / (float)GetCascadeResolution() * snapTexels;
+        // projection is larger by one step, so the snapped cascade still covers the whole slice
+        float extent = radius + snapStep;
+        float depthRange = std::max(extent, farPlane);
+
+        glm::vec3 lightCenter = glm::vec3(lightRotation * glm::vec4(center, 1.0f));
+        glm::ivec3 origin = glm::ivec3(glm::floor(lightCenter / snapStep));
+        glm::vec3 snappedCenter = (glm::vec3(origin) + 0.5f) * snapStep;
+
+        glm::mat4 lightProjection = glm::ortho(snappedCenter.x - extent, snappedCenter.x + extent,
+                                               snappedCenter.y - extent, snappedCenter.y + extent,
+                                               -snappedCenter.z - depthRange, -snappedCenter.z + depthRange);
+        lightSpaceMatrices[i] = lightProjection * lightRotation;
+
+        if (origin != cascadeOrigins[i]) {
+            cascadeOrigins[i] = origin;
+            isStaticCacheValid[i] = false;
+        }
+    }
+}
+
+/**
+ * @annotation
+ * Draws every static renderer inside the cascade, not only the ones visible in this frame
+ */
+void ShadowManager::DrawStaticCasters(int cascade) {
+    // planes of the cascade's box, extracted from its matrix
+    const glm::mat4& m = lightSpaceMatrices[cascade];
+    glm::vec4 rows[4];
+    for (int i = 0; i < 4; ++i) {
+        rows[i] = glm::vec4(m[0][i], m[1][i], m[2][i], m[3][i]);
+    }
+    glm::vec4 equations[6] = {rows[3] + rows[0], rows[3] - rows[0], rows[3] + rows[1],
+                              rows[3] - rows[1], rows[3] + rows[2], rows[3] - rows[2]};
+    Plane planes[6];
+    for (int i = 0; i < 6; ++i) {
+        float length = glm::length(glm::vec3(equations[i]));
+        planes[i].normal = glm::vec3(equations[i]) / length;
+        planes[i].distance = -equations[i].w / length;
+    }
+    Frustum cascadeFrustum = {planes[3], planes[2], planes[1], planes[0], planes[5], planes[4]};
+
+    auto rendererManager = RendererManager::GetInstance();
+    rendererManager->ResetRenderState();
+    for (const auto& gameObject : GloomEngine::GetInstance()->gameObjects) {
+        auto renderer = gameObject.second->GetComponent<Renderer>();
+        if (renderer == nullptr || !renderer->enabled || !renderer->isStatic || !renderer->drawShadows) continue;
+        if (gameObject.second->bounds != nullptr &&
+            !gameObject.second->bounds->IsOnFrustum(cascadeFrustum, gameObject.second->transform)) continue;
+
+        renderer->Draw(shadowShader);
     }
+    rendererManager->ResetRenderState();
 }
 
 void ShadowManager::Free() const {
     shadowShader->Delete();
+    glDeleteTextures(1, &depthMap);
+    glDeleteTextures(1, &staticDepthMap);
+    glDeleteFramebuffers(1, &depthMapFBO);
 }
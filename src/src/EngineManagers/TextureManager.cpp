@@ -0,0 +1,550 @@
+#include "EngineManagers/TextureManager.h"
+#include "LowLevelClasses/DDS.h"
+#include "LowLevelClasses/VirtualFileSystem.h"
+#include "stb_image.h"
+#include "spdlog/spdlog.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+
+#ifdef DEBUG
+#include <tracy/Tracy.hpp>
+#endif
+
+// BC1 and BC3 come from an extension every desktop GPU has, BC4 and BC5 are core
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+
+static bool IsS3TCSupported() {
+    static int isSupported = -1;
+    if (isSupported == -1) {
+        isSupported = 0;
+        GLint extensionsCount = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &extensionsCount);
+        for (GLint i = 0; i < extensionsCount; ++i) {
+            auto extension = (const char*)glGetStringi(GL_EXTENSIONS, i);
+            if (extension != nullptr && std::strcmp(extension, "GL_EXT_texture_compression_s3tc") == 0) {
+                isSupported = 1;
+                break;
+            }
+        }
+    }
+    return isSupported == 1;
+}
+
+static GLenum GetFormat(int nrChannels) {
+    if (nrChannels == 1)
+        return GL_RED;
+    else if (nrChannels == 2)
+        return GL_RG;
+    else if (nrChannels == 3)
+        return GL_RGB;
+    return GL_RGBA;
+}
+
+// parameters of the bound texture, mipmaps have to be generated before
+static void SetParameters(TextureWrap wrap, GLenum format) {
+    GLint wrapMode = wrap == TextureWrap::ClampWithAlpha && format == GL_RGBA ? GL_CLAMP_TO_EDGE : GL_REPEAT;
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrapMode);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrapMode);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+}
+
+TextureManager::TextureManager() = default;
+
+TextureManager::~TextureManager() {
+    delete textureManager;
+}
+
+TextureManager* TextureManager::GetInstance() {
+    if (textureManager == nullptr) {
+        textureManager = new TextureManager();
+    }
+    return textureManager;
+}
+
+unsigned int TextureManager::LoadTexture(const std::string& path, TextureWrap wrap) {
+    unsigned int textureID = Acquire(path, wrap);
+    if (textureID != 0) return textureID;
+    textureID = LoadCompressed(path, wrap);
+    if (textureID != 0) return textureID;
+
+#ifdef DEBUG
+    ZoneScopedNC("Decode texture", 0xDC143C);
+#endif
+    int width, height, nrChannels;
+    unsigned char* data = LoadImage(path, width, height, nrChannels, 0);
+    if (!data) {
+        spdlog::info("Failed to load texture at path: " + path);
+        return 0;
+    }
+    textureID = AddTexture(path, wrap, data, width, height, nrChannels);
+    stbi_image_free(data);
+    return textureID;
+}
+
+unsigned int TextureManager::LoadTextureAsync(const std::string& path, TextureWrap wrap, int& width, int& height,
+                                              int& nrChannels) {
+    std::string key = GetKey(path, wrap);
+    unsigned int textureID = AcquireKey(key);
+    // compressed variants are only read from the disk, so they are loaded right away
+    if (textureID == 0) textureID = LoadCompressed(path, wrap);
+    if (textureID != 0) {
+        const CachedTexture& texture = *textures.Find(key);
+        width = texture.width;
+        height = texture.height;
+        nrChannels = texture.nrChannels;
+        return textureID;
+    }
+
+    // only the header is read, so callers can lay the image out before it's decoded
+    if (!GetImageInfo(path, width, height, nrChannels)) {
+        spdlog::info("Failed to load texture at path: " + path);
+        return 0;
+    }
+
+    // UI shows nothing and models show grey until the image is uploaded
+    const unsigned char placeholder[4] = {128, 128, 128, (unsigned char)(wrap == TextureWrap::ClampWithAlpha ? 0 : 255)};
+    glGenTextures(1, &textureID);
+    glBindTexture(GL_TEXTURE_2D, textureID);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, placeholder);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    CachedTexture& texture = textures.Insert(key, textureID, (size_t)width * height * nrChannels * 4 / 3);
+    texture.width = width;
+    texture.height = height;
+    texture.nrChannels = nrChannels;
+    texture.isPending = true;
+    ++pendingCount;
+
+    if (workers.empty()) StartWorkers();
+    {
+        std::lock_guard<std::mutex> lock(decodeMutex);
+        requests.push_back({key, path, textureID, wrap});
+        ++decodingCount;
+    }
+    requestsCondition.notify_one();
+    return textureID;
+}
+
+unsigned int TextureManager::Acquire(const std::string& path, TextureWrap wrap) {
+    return AcquireKey(GetKey(path, wrap));
+}
+
+unsigned int TextureManager::AddTexture(const std::string& path, TextureWrap wrap, const unsigned char* data,
+                                        int width, int height, int nrChannels) {
+    ++decodedCount;
+    GLenum format = GetFormat(nrChannels);
+
+    unsigned int textureID;
+    glGenTextures(1, &textureID);
+    glBindTexture(GL_TEXTURE_2D, textureID);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, (GLint)format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
+    glGenerateMipmap(GL_TEXTURE_2D);
+    SetParameters(wrap, format);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    // mipmaps add a third
+    CachedTexture& texture = textures.Insert(GetKey(path, wrap), textureID, (size_t)width * height * nrChannels * 4 / 3);
+    texture.width = width;
+    texture.height = height;
+    texture.nrChannels = nrChannels;
+    return textureID;
+}
+
+unsigned int TextureManager::LoadCubeMap(const std::string& basePath) {
+    std::string key = NormalizePath(basePath) + "#cube";
+    unsigned int textureID = AcquireKey(key);
+    if (textureID != 0) return textureID;
+
+#ifdef DEBUG
+    ZoneScopedNC("Decode cube map", 0xDC143C);
+#endif
+    glGenTextures(1, &textureID);
+    glBindTexture(GL_TEXTURE_CUBE_MAP, textureID);
+
+    size_t textureMemory = 0;
+    bool isLoaded = true;
+    for (unsigned int i = 0; i < 6; i++) {
+        auto path = basePath + std::to_string(i) + ".jpg";
+
+        int width, height, nrChannels;
+        unsigned char* data = LoadImage(path, width, height, nrChannels, 3);
+        if (!data) {
+            spdlog::info("Cubemap texture failed to load at path: " + path);
+            isLoaded = false;
+            break;
+        }
+        // faces are addressed from the inside of the cube, so they are flipped back instead of toggling
+        // stbi's global flag, which workers decoding other textures read at the same time
+        std::vector<unsigned char> row(width * 3);
+        for (int y = 0; y < height / 2; ++y) {
+            unsigned char* top = data + y * width * 3;
+            unsigned char* bottom = data + (height - 1 - y) * width * 3;
+            std::memcpy(row.data(), top, row.size());
+            std::memcpy(top, bottom, row.size());
+            std::memcpy(bottom, row.data(), row.size());
+        }
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
+        stbi_image_free(data);
+        textureMemory += (size_t)width * height * 3;
+    }
+
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+
+    if (!isLoaded) {
+        glDeleteTextures(1, &textureID);
+        return 0;
+    }
+    ++decodedCount;
+    textures.Insert(key, textureID, textureMemory);
+    return textureID;
+}
+
+void TextureManager::Release(unsigned int id) {
+    textures.Release(id);
+}
+
+void TextureManager::SetMemoryBudget(size_t newMemoryBudget) {
+    textures.SetMemoryBudget(newMemoryBudget);
+}
+
+/**
+ * @annotation
+ * Uploads textures decoded since the last frame, at least one per frame so loads always progress
+ */
+void TextureManager::Update() {
+    if (pendingCount == 0) return;
+#ifdef DEBUG
+    ZoneScopedNC("Upload textures", 0xDC143C);
+#endif
+    auto start = std::chrono::steady_clock::now();
+    while (true) {
+        DecodedTexture decoded;
+        {
+            std::lock_guard<std::mutex> lock(decodeMutex);
+            if (decodedTextures.empty()) return;
+            decoded = decodedTextures.front();
+            decodedTextures.pop_front();
+        }
+        if (!Upload(decoded, false)) {
+            // the ring is still read by the GPU, the texture goes first next frame
+            std::lock_guard<std::mutex> lock(decodeMutex);
+            decodedTextures.push_front(decoded);
+            return;
+        }
+        if (std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count() > TEXTURE_UPLOAD_BUDGET) return;
+    }
+}
+
+void TextureManager::FinishUploads() {
+    if (pendingCount == 0) return;
+#ifdef DEBUG
+    ZoneScopedNC("Finish texture uploads", 0xDC143C);
+#endif
+    std::deque<DecodedTexture> finished;
+    {
+        std::unique_lock<std::mutex> lock(decodeMutex);
+        decodedCondition.wait(lock, [this] { return decodingCount == 0; });
+        finished.swap(decodedTextures);
+    }
+    // waiting uploads don't fail, so every texture is finished and its pixels freed here
+    for (auto& decoded : finished) {
+        Upload(decoded, true);
+    }
+}
+
+size_t TextureManager::GetMemory() const {
+    return textures.GetMemory();
+}
+
+size_t TextureManager::GetUnusedMemory() const {
+    return textures.GetUnusedMemory();
+}
+
+size_t TextureManager::GetTexturesCount() const {
+    return textures.GetCount();
+}
+
+unsigned int TextureManager::GetRequestsCount() const {
+    return requestsCount;
+}
+
+unsigned int TextureManager::GetDecodedCount() const {
+    return decodedCount;
+}
+
+unsigned int TextureManager::GetCompressedCount() const {
+    return compressedCount;
+}
+
+unsigned int TextureManager::GetPendingCount() const {
+    return pendingCount;
+}
+
+unsigned char* TextureManager::LoadImage(const std::string& path, int& width, int& height, int& nrChannels,
+                                         int desiredChannels) {
+    VirtualFile file;
+    if (!VirtualFileSystem::GetInstance()->Open(path, file)) return nullptr;
+    return stbi_load_from_memory(file.GetData(), (int)file.GetSize(), &width, &height, &nrChannels, desiredChannels);
+}
+
+bool TextureManager::GetImageInfo(const std::string& path, int& width, int& height, int& nrChannels) {
+    VirtualFile file;
+    if (!VirtualFileSystem::GetInstance()->Open(path, file)) return false;
+    return stbi_info_from_memory(file.GetData(), (int)file.GetSize(), &width, &height, &nrChannels);
+}
+
+std::string TextureManager::NormalizePath(const std::string& path) {
+    return std::filesystem::path(path).lexically_normal().generic_string();
+}
+
+void TextureManager::Free() {
+    {
+        std::lock_guard<std::mutex> lock(decodeMutex);
+        isStopping = true;
+        requests.clear();
+    }
+    requestsCondition.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+    for (auto& decoded : decodedTextures) {
+        stbi_image_free(decoded.data);
+    }
+    decodedTextures.clear();
+
+    for (auto& slot : uploadSlots) {
+        if (slot.fence != nullptr) glDeleteSync(slot.fence);
+        slot.fence = nullptr;
+    }
+    if (uploadBuffer != 0) {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, uploadBuffer);
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        glDeleteBuffers(1, &uploadBuffer);
+        uploadBuffer = 0;
+        uploadMemory = nullptr;
+    }
+
+    textures.Clear();
+    pendingCount = 0;
+}
+
+std::string TextureManager::GetCompressedPath(const std::string& path) {
+    std::filesystem::path normalizedPath = std::filesystem::path(NormalizePath(path));
+    std::filesystem::path compressedPath = "res/compressed";
+    compressedPath /= normalizedPath.lexically_relative("res");
+    compressedPath.replace_extension(".dds");
+    return compressedPath.generic_string();
+}
+
+// the same file may be wrapped differently by UI and models, each needs its own texture object
+std::string TextureManager::GetKey(const std::string& path, TextureWrap wrap) {
+    return NormalizePath(path) + (wrap == TextureWrap::ClampWithAlpha ? "#clamp" : "");
+}
+
+unsigned int TextureManager::AcquireKey(const std::string& key) {
+    ++requestsCount;
+    CachedTexture* texture = textures.Acquire(key);
+    return texture == nullptr ? 0 : texture->id;
+}
+
+unsigned int TextureManager::LoadCompressed(const std::string& path, TextureWrap wrap) {
+    std::string compressedPath = GetCompressedPath(path);
+    // variants older than their image were made before it changed
+    auto fileSystem = VirtualFileSystem::GetInstance();
+    VirtualFileInfo compressedInfo, info;
+    if (!fileSystem->GetInfo(compressedPath, compressedInfo) || !fileSystem->GetInfo(path, info)) return 0;
+    if (compressedInfo.writeTime < info.writeTime) return 0;
+
+#ifdef DEBUG
+    ZoneScopedNC("Load compressed texture", 0xDC143C);
+#endif
+    // levels are uploaded straight from the mapping
+    VirtualFile file;
+    if (!fileSystem->Open(compressedPath, file)) return 0;
+    const unsigned char* data = file.GetData();
+
+    uint32_t magic = 0;
+    DDSHeader header{};
+    if (file.GetSize() < sizeof(magic) + sizeof(header)) return 0;
+    std::memcpy(&magic, data, sizeof(magic));
+    std::memcpy(&header, data + sizeof(magic), sizeof(header));
+    if (magic != DDS_MAGIC || !(header.pixelFormat.flags & DDPF_FOURCC)) {
+        spdlog::info("Failed to read a file content at path: " + compressedPath);
+        return 0;
+    }
+
+    GLenum format;
+    int nrChannels;
+    const uint32_t fourCC = header.pixelFormat.fourCC;
+    if (fourCC == DDS_BC1) {
+        format = GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+        nrChannels = 3;
+    } else if (fourCC == DDS_BC3) {
+        format = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+        nrChannels = 4;
+    } else if (fourCC == DDS_BC4) {
+        format = GL_COMPRESSED_RED_RGTC1;
+        nrChannels = 1;
+    } else if (fourCC == DDS_BC5) {
+        format = GL_COMPRESSED_RG_RGTC2;
+        nrChannels = 2;
+    } else {
+        return 0;
+    }
+    if ((fourCC == DDS_BC1 || fourCC == DDS_BC3) && !IsS3TCSupported()) return 0;
+
+    unsigned int textureID;
+    glGenTextures(1, &textureID);
+    glBindTexture(GL_TEXTURE_2D, textureID);
+    size_t offset = sizeof(magic) + sizeof(header);
+    const uint32_t levelsCount = std::max(header.mipMapCount, 1u);
+    uint32_t width = header.width, height = header.height;
+    for (uint32_t level = 0; level < levelsCount; ++level) {
+        uint32_t size = GetDDSLevelSize(fourCC, width, height);
+        if (offset + size > file.GetSize()) {
+            spdlog::info("Failed to read a file content at path: " + compressedPath);
+            glBindTexture(GL_TEXTURE_2D, 0);
+            glDeleteTextures(1, &textureID);
+            return 0;
+        }
+        glCompressedTexImage2D(GL_TEXTURE_2D, (GLint)level, format, (GLsizei)width, (GLsizei)height, 0, (GLsizei)size,
+                               data + offset);
+        offset += size;
+        width = std::max(width / 2, 1u);
+        height = std::max(height / 2, 1u);
+    }
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, (GLint)levelsCount - 1);
+    SetParameters(wrap, GetFormat(nrChannels));
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    ++compressedCount;
+    CachedTexture& texture = textures.Insert(GetKey(path, wrap), textureID, offset - sizeof(magic) - sizeof(header));
+    texture.width = (int)header.width;
+    texture.height = (int)header.height;
+    texture.nrChannels = nrChannels;
+    return textureID;
+}
+
+void TextureManager::StartWorkers() {
+    // the main thread keeps running frames, so the workers take half of the cores like other loaders
+    int numberOfThreads = (int)std::max(std::thread::hardware_concurrency() / 2, 1u);
+    for (int i = 0; i < numberOfThreads; ++i) {
+        workers.emplace_back([this] { DecodeRequests(); });
+    }
+
+    glGenBuffers(1, &uploadBuffer);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, uploadBuffer);
+    GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    glBufferStorage(GL_PIXEL_UNPACK_BUFFER, TEXTURE_UPLOAD_SLOTS * TEXTURE_UPLOAD_SLOT_SIZE, nullptr, flags);
+    uploadMemory = (unsigned char*)glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0,
+                                                    TEXTURE_UPLOAD_SLOTS * TEXTURE_UPLOAD_SLOT_SIZE, flags);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+}
+
+void TextureManager::DecodeRequests() {
+    while (true) {
+        TextureRequest request;
+        {
+            std::unique_lock<std::mutex> lock(decodeMutex);
+            requestsCondition.wait(lock, [this] { return isStopping || !requests.empty(); });
+            if (isStopping) return;
+            request = requests.front();
+            requests.pop_front();
+        }
+
+        DecodedTexture decoded;
+        decoded.request = request;
+        decoded.data = LoadImage(request.path, decoded.width, decoded.height, decoded.nrChannels, 0);
+
+        {
+            std::lock_guard<std::mutex> lock(decodeMutex);
+            decodedTextures.push_back(decoded);
+            --decodingCount;
+        }
+        decodedCondition.notify_all();
+    }
+}
+
+bool TextureManager::Upload(DecodedTexture& decoded, bool canWait) {
+    // released and evicted while decoding, the id may already belong to another texture
+    CachedTexture* cached = textures.Find(decoded.request.key);
+    if (cached == nullptr || cached->id != decoded.request.id || !cached->isPending) {
+        stbi_image_free(decoded.data);
+        return true;
+    }
+    if (decoded.data == nullptr) {
+        spdlog::info("Failed to load texture at path: " + decoded.request.path);
+        cached->isPending = false;
+        --pendingCount;
+        return true;
+    }
+
+    const size_t size = (size_t)decoded.width * decoded.height * decoded.nrChannels;
+    TextureUploadSlot* slot = nullptr;
+    if (size <= TEXTURE_UPLOAD_SLOT_SIZE && uploadMemory != nullptr) {
+        slot = &uploadSlots[nextUploadSlot];
+        if (slot->fence != nullptr) {
+            GLenum status = glClientWaitSync(slot->fence, canWait ? GL_SYNC_FLUSH_COMMANDS_BIT : 0,
+                                             canWait ? 1000000000 : 0);
+            if (status == GL_TIMEOUT_EXPIRED && !canWait) return false;
+            if (status == GL_TIMEOUT_EXPIRED || status == GL_WAIT_FAILED) {
+                // the GPU may still read the slot, texels go straight from the decoded image instead
+                slot = nullptr;
+            }
+            else {
+                glDeleteSync(slot->fence);
+                slot->fence = nullptr;
+            }
+        }
+    }
+
+#ifdef DEBUG
+    ZoneScopedNC("Upload texture", 0xDC143C);
+#endif
+    GLenum format = GetFormat(decoded.nrChannels);
+    glBindTexture(GL_TEXTURE_2D, decoded.request.id);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    // replaces the placeholder's storage, texels come from the ring or straight from the decoded image
+    glTexImage2D(GL_TEXTURE_2D, 0, (GLint)format, decoded.width, decoded.height, 0, format, GL_UNSIGNED_BYTE, nullptr);
+    if (slot != nullptr) {
+        const size_t offset = (size_t)nextUploadSlot * TEXTURE_UPLOAD_SLOT_SIZE;
+        std::memcpy(uploadMemory + offset, decoded.data, size);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, uploadBuffer);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, decoded.width, decoded.height, format, GL_UNSIGNED_BYTE, (void*)offset);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        slot->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        nextUploadSlot = (nextUploadSlot + 1) % TEXTURE_UPLOAD_SLOTS;
+    }
+    else {
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, decoded.width, decoded.height, format, GL_UNSIGNED_BYTE, decoded.data);
+    }
+    glGenerateMipmap(GL_TEXTURE_2D);
+    SetParameters(decoded.request.wrap, format);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    stbi_image_free(decoded.data);
+
+    cached->isPending = false;
+    --pendingCount;
+    ++decodedCount;
+    return true;
+}
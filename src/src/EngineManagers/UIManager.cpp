@@ -1,10 +1,14 @@
 #include "EngineManagers/UIManager.h"
 #include "Components/UI/UIComponent.h"
 #include "LowLevelClasses/Shader.h"
+#include "LowLevelClasses/SpriteBatch.h"
+#include "LowLevelClasses/SpriteAtlas.h"
 #include "stb_image.h"
 
 UIManager::UIManager() {
     shader = std::make_shared<Shader>("UI.vert", "UI.frag");
+    spriteBatch = std::make_shared<SpriteBatch>();
+    spriteAtlas = std::make_shared<SpriteAtlas>();
 }
 
 UIManager::~UIManager() {
@@ -20,6 +24,8 @@ UIManager* UIManager::GetInstance() {
 
 void UIManager::Free() const {
     shader->Delete();
+    spriteBatch->Free();
+    spriteAtlas->Free();
 }
 
 void UIManager::Draw() {
@@ -27,10 +33,17 @@ void UIManager::Draw() {
     ClearBuffer();
 }
 
+/**
+ * @annotation
+ * Every component adds its quads to one batch, which sorts and draws them in a few calls
+ */
 void UIManager::DrawUI() {
+    spriteAtlas->Update();
     for (int i = 0; i < bufferIterator; ++i) {
-        drawBuffer[i]->Draw();
+        spriteBatch->NextComponent();
+        drawBuffer[i]->AddQuads(*spriteBatch);
     }
+    spriteBatch->Draw(shader);
 }
 
 void UIManager::AddToDrawBuffer(const std::shared_ptr<UIComponent> &component) {
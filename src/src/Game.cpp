@@ -32,10 +32,29 @@
 #include "Components/Scripts/Crowd.h"
 #include "Components/Scripts/Menus/MapTrigger.h"
 
+#include "GameObjectsAndPrefabs/Prefabs/House.h"
+#include "GameObjectsAndPrefabs/Prefabs/Shop.h"
+#include "GameObjectsAndPrefabs/Prefabs/SavePoint.h"
+#include "GameObjectsAndPrefabs/Prefabs/Crowd/Default.h"
+#include "GameObjectsAndPrefabs/Prefabs/Crowd/Jazz.h"
+#include "Components/Scripts/Menus/ShopTrigger.h"
+
 #ifdef DEBUG
 #include <tracy/Tracy.hpp>
 #endif
 
+// models InitializeGame loads itself, prefabs and scripts keep their own ones
+static const std::string mapModel = "Buildings/Environment/Mapa.obj";
+static const std::string drummerModel = "Opponent/Drummer/MainDrummer/Drummer.dae";
+static const std::string trumpeterModel = "Opponent/Trumpeter/MainTrumpeter/Trumpeter.dae";
+static const std::string basicDrummerModel = "Opponent/Drummer/BasicDrummer001/Drummer.dae";
+static const std::string basicManModel = "Crowd/BasicMan003/BasicMan003.dae";
+static const std::string felynnModel = "Crowd/BasicMan001/BasicMan001.dae";
+static const std::string jazzManModel = "Crowd/JazzMan004/JazzMan004.dae";
+static const std::string builderModel = "Crowd/BobTheBuilder/Builder.dae";
+static const std::string jimmyBravoModel = "Crowd/JimmyBravo/JimmyBravo.dae";
+static const std::string josephModel = "Crowd/Joseph/Joseph.dae";
+
 Game::Game() {
     activeCamera = Camera::activeCamera;
     activeScene = SceneManager::GetInstance()->activeScene;
@@ -58,19 +77,6 @@ void Game::InitializeGame() const {
     auto skyCubeMap = sky->AddComponent<CubeMap>();
     skyCubeMap->LoadTextures("skybox/");
 
-    // Load all animations
-    // -------------
-    Animator::LoadAnimation("CrowdAnimations/Walk.dae");
-    Animator::LoadAnimation("CrowdAnimations/Happy.dae");
-    Animator::LoadAnimation("CrowdAnimations/Angry.dae");
-    Animator::LoadAnimation("CrowdAnimations/Idle1.dae");
-    Animator::LoadAnimation("CrowdAnimations/Idle3.dae");
-    Animator::LoadAnimation("MainHero/MainHeroIdle.dae");
-    Animator::LoadAnimation("MainHero/MainHeroRun.dae");
-    Animator::LoadAnimation("MainHero/MainHeroClap.dae");
-    Animator::LoadAnimation("MainHero/MainHeroTrumpet.dae");
-    Animator::LoadAnimation("MainHero/MainHeroDrums.dae");
-
     // Set up player
     // -------------
     std::shared_ptr<GameObject> player = Prefab::Instantiate<Player>();
@@ -93,7 +99,7 @@ void Game::InitializeGame() const {
     // Opponents
     auto drummer = GameObject::Instantiate("DrumOpponent", activeScene);
     auto drummerAnimator = drummer->AddComponent<Animator>();
-    drummerAnimator->LoadAnimationModel("Opponent/Drummer/MainDrummer/Drummer.dae");
+    drummerAnimator->LoadAnimationModel(drummerModel);
     drummerAnimator->SetAnimation("MainHero/MainHeroDrums.dae");
     drummer->AddComponent<BoxCollider>()->SetSize({0.5, 1, 0.5});
     drummer->transform->SetLocalPosition(glm::vec3(-53, 0, 18));
@@ -108,7 +114,7 @@ void Game::InitializeGame() const {
 
     auto trumpeter = GameObject::Instantiate("JazzOpponent", activeScene);
     auto trumpeterAnimator = trumpeter->AddComponent<Animator>();
-    trumpeterAnimator->LoadAnimationModel("Opponent/Trumpeter/MainTrumpeter/Trumpeter.dae");
+    trumpeterAnimator->LoadAnimationModel(trumpeterModel);
     trumpeterAnimator->SetAnimation("MainHero/MainHeroTrumpet.dae");
     trumpeter->AddComponent<BoxCollider>()->SetSize({0.5, 1, 0.5});
     trumpeter->transform->SetLocalPosition(glm::vec3(-87, 0, -42));
@@ -124,7 +130,7 @@ void Game::InitializeGame() const {
 
     auto opponent1 = GameObject::Instantiate("NormalOpponent", activeScene);
     auto opponent1Animator = opponent1->AddComponent<Animator>();
-    opponent1Animator->LoadAnimationModel("Crowd/BasicMan003/BasicMan003.dae");
+    opponent1Animator->LoadAnimationModel(basicManModel);
     opponent1Animator->SetAnimation("MainHero/MainHeroClap.dae");
     opponent1->AddComponent<BoxCollider>()->SetSize({0.5, 1, 0.5});
     opponent1->transform->SetLocalPosition(glm::vec3(12, 0, 7));
@@ -139,7 +145,7 @@ void Game::InitializeGame() const {
 
     auto opponent2 = GameObject::Instantiate("NormalOpponent", activeScene);
     auto opponent2Animator = opponent2->AddComponent<Animator>();
-    opponent2Animator->LoadAnimationModel("Crowd/BasicMan003/BasicMan003.dae");
+    opponent2Animator->LoadAnimationModel(basicManModel);
     opponent2Animator->SetAnimation("MainHero/MainHeroClap.dae");
     opponent2->AddComponent<BoxCollider>()->SetSize({0.5, 1, 0.5});
     opponent2->transform->SetLocalPosition(glm::vec3(-36.5, 0, -26));
@@ -154,7 +160,7 @@ void Game::InitializeGame() const {
 
     auto opponent3 = GameObject::Instantiate("NormalOpponent", activeScene);
     auto opponent3Animator = opponent3->AddComponent<Animator>();
-    opponent3Animator->LoadAnimationModel("Opponent/Drummer/BasicDrummer001/Drummer.dae");
+    opponent3Animator->LoadAnimationModel(basicDrummerModel);
     opponent3Animator->SetAnimation("MainHero/MainHeroDrums.dae");
     opponent3->AddComponent<BoxCollider>()->SetSize({0.5, 1, 0.5});
     opponent3->transform->SetLocalPosition(glm::vec3(-75.5, 0, -65.5));
@@ -170,7 +176,7 @@ void Game::InitializeGame() const {
     dialogue->transform->SetLocalScale(glm::vec3(0.5f));
     dialogue->AddComponent<BoxCollider>()->SetSize({1, 1, 1});
     auto dialogueAnimator = dialogue->AddComponent<Animator>();
-    dialogueAnimator->LoadAnimationModel("Crowd/BobTheBuilder/Builder.dae");
+    dialogueAnimator->LoadAnimationModel(builderModel);
     dialogueAnimator->SetAnimation("CrowdAnimations/Idle3.dae");
     auto dialogueComponent = GameObject::Instantiate("Dialogue", dialogue)->AddComponent<Dialogue>();
     dialogueComponent->name = "Tru Bob";
@@ -188,7 +194,7 @@ void Game::InitializeGame() const {
     dialogue->transform->SetLocalScale(glm::vec3(0.5f));
     dialogue->AddComponent<BoxCollider>()->SetSize({1, 1, 1});
     dialogueAnimator = dialogue->AddComponent<Animator>();
-    dialogueAnimator->LoadAnimationModel("Crowd/BasicMan003/BasicMan003.dae");
+    dialogueAnimator->LoadAnimationModel(basicManModel);
     dialogueAnimator->SetAnimation("CrowdAnimations/Idle3.dae");
     dialogueComponent = GameObject::Instantiate("Dialogue", dialogue)->AddComponent<Dialogue>();
     dialogueComponent->name = "David Kafferdale";
@@ -206,7 +212,7 @@ void Game::InitializeGame() const {
     dialogue->transform->SetLocalRotation(glm::vec3(0, 355, 0));
     dialogue->AddComponent<BoxCollider>()->SetSize({1, 1, 1});
     dialogueAnimator = dialogue->AddComponent<Animator>();
-    dialogueAnimator->LoadAnimationModel("Crowd/BasicMan001/BasicMan001.dae");
+    dialogueAnimator->LoadAnimationModel(felynnModel);
     dialogueAnimator->SetAnimation("CrowdAnimations/Idle3.dae");
     dialogueComponent = GameObject::Instantiate("Dialogue", dialogue)->AddComponent<Dialogue>();
     dialogueComponent->name = "Felynn Rutin";
@@ -224,7 +230,7 @@ void Game::InitializeGame() const {
     dialogue->transform->SetLocalScale(glm::vec3(0.5f));
     dialogue->AddComponent<BoxCollider>()->SetSize({1, 1, 1});
     dialogueAnimator = dialogue->AddComponent<Animator>();
-    dialogueAnimator->LoadAnimationModel("Crowd/JimmyBravo/JimmyBravo.dae");
+    dialogueAnimator->LoadAnimationModel(jimmyBravoModel);
     dialogueAnimator->SetAnimation("CrowdAnimations/Idle1.dae");
     dialogueComponent = GameObject::Instantiate("Dialogue", dialogue)->AddComponent<Dialogue>();
     dialogueComponent->name = "Jimmy Bravo";
@@ -242,7 +248,7 @@ void Game::InitializeGame() const {
     dialogue->transform->SetLocalRotation(glm::vec3(0, 295, 0));
     dialogue->AddComponent<BoxCollider>()->SetSize({1, 1, 1});
     dialogueAnimator = dialogue->AddComponent<Animator>();
-    dialogueAnimator->LoadAnimationModel("Crowd/Joseph/Joseph.dae");
+    dialogueAnimator->LoadAnimationModel(josephModel);
     dialogueAnimator->SetAnimation("CrowdAnimations/Idle3.dae");
     dialogueComponent = GameObject::Instantiate("Dialogue", dialogue)->AddComponent<Dialogue>();
     dialogueComponent->name = "Joseph Joe Starr";
@@ -259,7 +265,7 @@ void Game::InitializeGame() const {
     dialogue->transform->SetLocalScale(glm::vec3(0.5f));
     dialogue->AddComponent<BoxCollider>()->SetSize({1, 1, 1});
     dialogueAnimator = dialogue->AddComponent<Animator>();
-    dialogueAnimator->LoadAnimationModel("Crowd/JazzMan004/JazzMan004.dae");
+    dialogueAnimator->LoadAnimationModel(jazzManModel);
     dialogueAnimator->SetAnimation("CrowdAnimations/Idle3.dae");
     dialogueComponent = GameObject::Instantiate("Dialogue", dialogue)->AddComponent<Dialogue>();
     dialogueComponent->name = "Tom Bone";
@@ -277,7 +283,7 @@ void Game::InitializeGame() const {
     dialogue->transform->SetLocalRotation(glm::vec3(0,275,0));
     dialogue->AddComponent<BoxCollider>()->SetSize({1, 1, 1});
     dialogueAnimator = dialogue->AddComponent<Animator>();
-    dialogueAnimator->LoadAnimationModel("Crowd/BasicMan003/BasicMan003.dae");
+    dialogueAnimator->LoadAnimationModel(basicManModel);
     dialogueAnimator->SetAnimation("CrowdAnimations/Idle3.dae");
     dialogueComponent = GameObject::Instantiate("Dialogue", dialogue)->AddComponent<Dialogue>();
     dialogueComponent->name = "Bob Mallet";
@@ -294,7 +300,7 @@ void Game::InitializeGame() const {
     shopkeeper->AddComponent<Shopkeeper>();
 
     auto map = GameObject::Instantiate("Map", activeScene);
-    map->AddComponent<Renderer>()->LoadModel("Buildings/Environment/Mapa.obj");
+    map->AddComponent<Renderer>()->LoadModel(mapModel);
     map->transform->SetLocalPosition(glm::vec3(14, 0, -9));
     map->AddComponent<BoxCollider>()->SetSize(glm::vec3(2,2,0.5));
     auto mapTrigger = GameObject::Instantiate("MapTrigger", map);
@@ -314,6 +320,61 @@ void Game::InitializeGame() const {
     camera->SetTarget(nullptr);
 }
 
+const std::vector<std::string>& Game::GetAnimations() {
+    static const std::vector<std::string> animations = {
+            "CrowdAnimations/Walk.dae",
+            "CrowdAnimations/Happy.dae",
+            "CrowdAnimations/Angry.dae",
+            "CrowdAnimations/Idle1.dae",
+            "CrowdAnimations/Idle3.dae",
+            "MainHero/MainHeroIdle.dae",
+            "MainHero/MainHeroRun.dae",
+            "MainHero/MainHeroClap.dae",
+            "MainHero/MainHeroTrumpet.dae",
+            "MainHero/MainHeroDrums.dae"
+    };
+    return animations;
+}
+
+const std::vector<std::string>& Game::GetModels() {
+    static const std::vector<std::string> models = {
+            House::model,
+            Shop::model,
+            ShopTrigger::doorModel,
+            SavePoint::columnModel,
+            SavePoint::diskModel,
+            Indicator::model,
+            Die::model,
+            mapModel
+    };
+    return models;
+}
+
+const std::vector<std::string>& Game::GetAnimationModels() {
+    static const std::vector<std::string> animationModels = [] {
+        std::vector<std::string> paths = {
+                PlayerManager::animationModel,
+                Shopkeeper::animationModel,
+                drummerModel,
+                trumpeterModel,
+                basicDrummerModel,
+                basicManModel,
+                felynnModel,
+                jazzManModel,
+                builderModel,
+                jimmyBravoModel,
+                josephModel,
+                // Animator reads animations with the first one when it has no model yet
+                GetAnimations().front()
+        };
+        // spawned characters pick from the crowd's models
+        paths.insert(paths.end(), Crowd::Default::animationModels.begin(), Crowd::Default::animationModels.end());
+        paths.insert(paths.end(), Crowd::Jazz::animationModels.begin(), Crowd::Jazz::animationModels.end());
+        return paths;
+    }();
+    return animationModels;
+}
+
 bool Game::GameLoop() {
     auto pauseMenu = GloomEngine::GetInstance()->FindGameObjectWithName("Pause");
     if (pauseMenu)
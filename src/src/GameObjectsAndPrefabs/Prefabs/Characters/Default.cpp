@@ -3,6 +3,7 @@
 //
 
 #include "GameObjectsAndPrefabs/Prefabs/Characters/Default.h"
+#include "GameObjectsAndPrefabs/Prefabs/Crowd/Default.h"
 #include "Components/PhysicsAndColliders/Rigidbody.h"
 #include "Components/PhysicsAndColliders/BoxCollider.h"
 #include "Components/AI/CharacterLogic.h"
@@ -31,16 +32,9 @@ std::shared_ptr<GameObject> Default::Create() {
     character->AddComponent<CharacterMovement>();
     auto characterLogic = character->AddComponent<CharacterLogic>();
 
-    int modelIndex = RandomnessManager::GetInstance()->GetInt(1, 6);
-
-    std::string model;
-
-    if (modelIndex < 10)
-        model = "BasicMan00" + std::to_string(modelIndex);
-    else
-        model = "BasicMan0" + std::to_string(modelIndex);
-
-    characterLogic->SetAnimationModelToLoad("Crowd/" + model + "/" + model + ".dae");
+    const auto& animationModels = Crowd::Default::animationModels;
+    int modelIndex = RandomnessManager::GetInstance()->GetInt(0, (int)animationModels.size() - 1);
+    characterLogic->SetAnimationModelToLoad(animationModels[modelIndex]);
 
     int randomIndex;
 //    enum MusicGenre { Rhythmic = 60, Jazz = 70, RnB = 80, SynthPop=100, Rock=120 };
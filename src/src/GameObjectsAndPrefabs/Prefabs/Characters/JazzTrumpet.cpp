@@ -3,6 +3,7 @@
 //
 
 #include "GameObjectsAndPrefabs/Prefabs/Characters/JazzTrumpet.h"
+#include "GameObjectsAndPrefabs/Prefabs/Crowd/Jazz.h"
 #include "Components/PhysicsAndColliders/Rigidbody.h"
 #include "Components/PhysicsAndColliders/BoxCollider.h"
 #include "Components/AI/CharacterLogic.h"
@@ -30,16 +31,9 @@ std::shared_ptr<GameObject> JazzTrumpet::Create() {
     character->AddComponent<CharacterMovement>();
     auto characterLogic = character->AddComponent<CharacterLogic>();
 
-    int modelIndex = RandomnessManager::GetInstance()->GetInt(1, 5);
-
-    std::string model;
-
-    if (modelIndex < 10)
-        model = "JazzMan00" + std::to_string(modelIndex);
-    else
-        model = "JazzMan0" + std::to_string(modelIndex);
-
-    characterLogic->SetAnimationModelToLoad("Crowd/" + model + "/" + model + ".dae");
+    const auto& animationModels = Crowd::Jazz::animationModels;
+    int modelIndex = RandomnessManager::GetInstance()->GetInt(0, (int)animationModels.size() - 1);
+    characterLogic->SetAnimationModelToLoad(animationModels[modelIndex]);
 
 //    enum MusicGenre { Rhythmic = 60, Jazz = 70, RnB = 80, SynthPop=100, Rock=120 };
     characterLogic->favGenres.push_back(Jazz);
@@ -26,16 +26,8 @@ namespace Crowd {
 
         auto animator = character->AddComponent<Animator>();
 
-        int modelIndex = RandomnessManager::GetInstance()->GetInt(1, 5);
-
-        std::string model;
-
-        if (modelIndex < 10)
-            model = "JazzMan00" + std::to_string(modelIndex);
-        else
-            model = "JazzMan0" + std::to_string(modelIndex);
-
-        animator->LoadAnimationModel("Crowd/" + model + "/" + model + ".dae");
+        int modelIndex = RandomnessManager::GetInstance()->GetInt(0, (int)animationModels.size() - 1);
+        animator->LoadAnimationModel(animationModels[modelIndex]);
 
 
         modelIndex = RandomnessManager::GetInstance()->GetInt(1, 3);
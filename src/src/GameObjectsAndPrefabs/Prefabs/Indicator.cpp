@@ -16,7 +16,7 @@ Indicator::~Indicator() = default;
 std::shared_ptr<GameObject> Indicator::Create() {
     auto indicator = shared_from_this();
     auto renderer = indicator->AddComponent<Renderer>();
-    renderer->LoadModel("Indicator/Indicator.obj");
+    renderer->LoadModel(model);
     renderer->drawShadows = false;
     auto positionAnimator = GameObject::Instantiate("PositionAnimator", indicator);
     positionAnimator->AddComponent<GameObjectAnimator>()->Setup(indicator->transform, {
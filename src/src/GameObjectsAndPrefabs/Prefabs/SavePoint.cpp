@@ -13,11 +13,11 @@ SavePoint::~SavePoint() = default;
 
 std::shared_ptr<GameObject> SavePoint::Create() {
     auto savePoint = shared_from_this();
-    savePoint->AddComponent<Renderer>()->LoadModel("Buildings/Environment/PostersColumn.obj");
+    savePoint->AddComponent<Renderer>()->LoadModel(columnModel);
     savePoint->transform->SetLocalScale(glm::vec3(0.25));
     savePoint->AddComponent<BoxCollider>()->SetOffset({0, 0, 0});
     std::shared_ptr<GameObject> s = GameObject::Instantiate("S", savePoint);
-    s->AddComponent<Renderer>()->LoadModel("Buildings/Environment/floppyDisk.obj");
+    s->AddComponent<Renderer>()->LoadModel(diskModel);
     s->AddComponent<GameObjectAnimator>()->Setup(s->transform, {
             {AnimatedProperty::Rotation, glm::vec3(0.0f, -360.0f, 0.0f), 5.0f},
     }, true);
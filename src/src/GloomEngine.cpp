@@ -4,6 +4,9 @@
 #include "EngineManagers/RendererManager.h"
 #include "EngineManagers/PostProcessingManager.h"
 #include "EngineManagers/UIManager.h"
+#include "EngineManagers/FontManager.h"
+#include "EngineManagers/TextureManager.h"
+#include "EngineManagers/AssetManager.h"
 #include "EngineManagers/CollisionManager.h"
 #include "EngineManagers/ShadowManager.h"
 #include "EngineManagers/AnimationManager.h"
@@ -22,8 +25,12 @@
 #include "Other/FrustumCulling.h"
 #include "Components/Renderers/Animator.h"
 #include "Components/UI/Image.h"
+#include "LowLevelClasses/FrameGraph.h"
+#include "LowLevelClasses/DynamicResolution.h"
+#include "LowLevelClasses/VirtualFileSystem.h"
 
 #include <stb_image.h>
+#include <filesystem>
 
 #ifdef DEBUG
 #include "EngineManagers/DebugManager.h"
@@ -48,10 +55,17 @@ void GloomEngine::Initialize() {
     ZoneScopedNC("Init", 0xDC143C);
 #endif
 
+    // loose files are read if the archive isn't there, the working directory may be the executable's or the project's
+    std::filesystem::path packPath(VirtualFileSystem::GetExecutableDirectory());
+    VirtualFileSystem::GetInstance()->Mount((packPath / VIRTUAL_FILE_SYSTEM_PACK).string());
     RandomnessManager::GetInstance()->InitializeRandomEngine();
     AudioManager::GetInstance()->InitializeAudio();
     OptionsManager::GetInstance()->Load();
+    FontManager::GetInstance()->LoadManifest();
     InitializeWindow();
+    BuildFrameGraph();
+    dynamicResolution = std::make_shared<DynamicResolution>();
+    dynamicResolution->frameBudget = 1000.0f * idealDeltaTime;
     HIDManager::GetInstance();
 
     game = std::make_shared<Game>();
@@ -88,25 +102,20 @@ bool GloomEngine::MainLoop() {
     int multiplier60LastRate = (int)((lastFrameTime - (float)(int)lastFrameTime) * 60);
 
 
+    // the loading scene isn't updated, its loading screen is drawn instead
+    if (SceneManager::GetInstance()->IsLoading()) {
+        componentsCopy.clear();
+        DestroyBufferedObjects();
+        SceneManager::GetInstance()->UpdateLoading();
+#ifdef DEBUG
+        FrameMark;
+#endif
+        return glfwWindowShouldClose(window);
+    }
+
     if (multiplier120Rate > multiplier120LastRate || (multiplier120Rate == 0 && multiplier120LastRate != 0)) {
         componentsCopy.clear();
-        for (int i = 0; i < destroyComponentBufferIterator; ++i) {
-            auto component = destroyComponentBuffer[i];
-            if (!component) continue;
-            component->OnDestroy();
-            RemoveComponent(component);
-            destroyComponentBuffer[i].reset();
-        }
-        destroyComponentBufferIterator = 0;
-
-        for (int i = 0; i < destroyGameObjectBufferIterator; ++i) {
-            auto gameObject = destroyGameObjectBuffer[i];
-            if (!gameObject) continue;
-            gameObject->Destroy();
-            RemoveGameObject(gameObject);
-            destroyGameObjectBuffer[i].reset();
-        }
-        destroyGameObjectBufferIterator = 0;
+        DestroyBufferedObjects();
 
         SceneManager::GetInstance()->activeScene->UpdateSelfAndChildren();
 
@@ -220,67 +229,34 @@ void GloomEngine::Update() {
         AnimationManager::GetInstance()->UpdateAnimations();
 
     }
-    // Preparing shadow map
-    if (SceneManager::GetInstance()->activeScene->GetName() != "MainMenuScene")
+    // Sorting render queue
     {
-#ifdef DEBUG
-        ZoneScopedNC("Prepare shadow", 0xFFD733);
-#endif
-
-        // Prepare shadow framebuffer
-        glBindFramebuffer(GL_FRAMEBUFFER, ShadowManager::GetInstance()->depthMapFBO);
-        glClear(GL_DEPTH_BUFFER_BIT);
-
-        ShadowManager::GetInstance()->PrepareShadow();
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        RendererManager::GetInstance()->SortDrawBuffer();
     }
-    // Drawing objects to textures
+    // Uploading textures decoded on workers
     {
-#ifdef DEBUG
-        ZoneScopedNC("Draw objects", 0xADD8E6);
-#endif
-        glViewport(0, 0, OptionsManager::GetInstance()->width, OptionsManager::GetInstance()->height);
-
-        // Prepare texture framebuffer
-        glBindFramebuffer(GL_FRAMEBUFFER, PostProcessingManager::GetInstance()->framebuffer);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-        glBindTexture(GL_TEXTURE_2D, ShadowManager::GetInstance()->depthMap);
-        RendererManager::GetInstance()->Draw();
-
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        TextureManager::GetInstance()->Update();
     }
-    // Applying post-processing
+    // Scaling scene resolution to the frame budget
     {
-#ifdef DEBUG
-        ZoneScopedNC("Post processing", 0xFFD733);
-#endif
-        PostProcessingManager::GetInstance()->Draw();
-
-        glEnable(GL_DEPTH_TEST);
-    }
-    // Drawing debug lines for colliders
-    if (SceneManager::GetInstance()->activeScene->GetName() != "MainMenuScene")
-    {
-#ifdef DEBUG
-        ZoneScopedNC("Draw colliders", 0x800000);
-        CollisionManager::GetInstance()->Draw();
-#endif
+        if (isFrameGraphDeferred != RendererManager::GetInstance()->deferredShading) BuildFrameGraph();
+        frameGraph->SetScreenSize(OptionsManager::GetInstance()->width, OptionsManager::GetInstance()->height);
+        frameGraph->SetRenderScale(dynamicResolution->Update());
+        RendererManager::GetInstance()->renderSize = {frameGraph->GetScaledSize(OptionsManager::GetInstance()->width),
+                                                      frameGraph->GetScaledSize(OptionsManager::GetInstance()->height)};
     }
-    // Drawing UI elements
+    // Assigning lights to clusters
     {
-#ifdef DEBUG
-        ZoneScopedNC("Draw UI", 0xFFD733);
-#endif
-
-        UIManager::GetInstance()->Draw();
+        RendererManager::GetInstance()->UpdateLightClusters();
     }
-    // Rendering IMGUI debug windows
+    // Drawing passes of the frame graph
     {
 #ifdef DEBUG
-        ZoneScopedNC("Debug windows", 0xC71585);
-        DebugManager::GetInstance()->Render();
+        ZoneScopedNC("Frame graph", 0xADD8E6);
 #endif
+        dynamicResolution->BeginFrame();
+        frameGraph->Execute();
+        dynamicResolution->EndFrame();
     }
     // Managing input
     {
@@ -291,6 +267,26 @@ void GloomEngine::Update() {
     }
 }
 
+void GloomEngine::DestroyBufferedObjects() {
+    for (int i = 0; i < destroyComponentBufferIterator; ++i) {
+        auto component = destroyComponentBuffer[i];
+        if (!component) continue;
+        component->OnDestroy();
+        RemoveComponent(component);
+        destroyComponentBuffer[i].reset();
+    }
+    destroyComponentBufferIterator = 0;
+
+    for (int i = 0; i < destroyGameObjectBufferIterator; ++i) {
+        auto gameObject = destroyGameObjectBuffer[i];
+        if (!gameObject) continue;
+        gameObject->Destroy();
+        RemoveGameObject(gameObject);
+        destroyGameObjectBuffer[i].reset();
+    }
+    destroyGameObjectBufferIterator = 0;
+}
+
 void GloomEngine::FixedUpdate() {
     for (const auto& component : componentsCopy) {
         if (component.second->enabled) component.second->FixedUpdate();
@@ -311,6 +307,8 @@ void GloomEngine::Free() const {
     ShadowManager::GetInstance()->Free();
     RendererManager::GetInstance()->Free();
     PostProcessingManager::GetInstance()->Free();
+    frameGraph->Free();
+    dynamicResolution->Free();
     UIManager::GetInstance()->Free();
     RandomnessManager::GetInstance()->Free();
     AIManager::GetInstance()->Free();
@@ -318,6 +316,10 @@ void GloomEngine::Free() const {
     DebugManager::GetInstance()->Free();
 #endif
     SceneManager::GetInstance()->Free();
+    // models release their textures, so they go first
+    AssetManager::GetInstance()->Free();
+    FontManager::GetInstance()->Free();
+    TextureManager::GetInstance()->Free();
     glfwDestroyWindow(window);
     glfwTerminate();
 }
@@ -397,6 +399,82 @@ void GloomEngine::InitializeWindow() {
     stbi_set_flip_vertically_on_load(true);
 }
 
+/**
+ * @annotation
+ * Declares passes drawn every frame, the graph orders them by the textures they read and write
+ */
+void GloomEngine::BuildFrameGraph() {
+    if (frameGraph != nullptr) frameGraph->Free();
+    frameGraph = std::make_shared<FrameGraph>();
+    isFrameGraphDeferred = RendererManager::GetInstance()->deferredShading;
+    auto graph = frameGraph.get();
+
+    int shadowMap = frameGraph->ImportTexture("ShadowMap", ShadowManager::GetInstance()->depthMap);
+    int sceneScreen = frameGraph->CreateTexture("SceneScreen", {GL_RGB8, 1.0f, GL_LINEAR, true});
+    int scenePosition = frameGraph->CreateTexture("ScenePosition", {GL_RGBA32F, 1.0f, GL_NEAREST, true});
+    int sceneNormal = frameGraph->CreateTexture("SceneNormal", {GL_RGBA16F, 1.0f, GL_NEAREST, true});
+    int sceneColor = frameGraph->CreateTexture("SceneColor", {GL_RGBA8, 1.0f, GL_NEAREST, true});
+    int sceneDepth = frameGraph->CreateTexture("SceneDepth", {GL_DEPTH_COMPONENT24, 1.0f, GL_NEAREST, true});
+
+    frameGraph->AddPass("Shadows", [] {
+        if (SceneManager::GetInstance()->activeScene->GetName() == "MainMenuScene") return;
+        ShadowManager::GetInstance()->PrepareShadow();
+    }).Write(shadowMap);
+
+    if (isFrameGraphDeferred) {
+        int albedo = frameGraph->CreateTexture("GBufferAlbedo", {GL_RGBA8, 1.0f, GL_NEAREST, true});
+        int material = frameGraph->CreateTexture("GBufferMaterial", {GL_RGBA8, 1.0f, GL_NEAREST, true});
+
+        frameGraph->AddPass("Geometry", [] {
+            const float noGeometry[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            // lighting pass skips pixels with zero position w
+            glClearBufferfv(GL_COLOR, 1, noGeometry);
+            RendererManager::GetInstance()->Draw();
+        }).Write(albedo).Write(scenePosition).Write(sceneNormal).Write(material).Write(sceneDepth);
+
+        frameGraph->AddPass("Lighting", [graph, albedo, scenePosition, sceneNormal, material] {
+            RendererManager::GetInstance()->DrawLighting(graph->GetTexture(albedo), graph->GetTexture(scenePosition),
+                                                         graph->GetTexture(sceneNormal), graph->GetTexture(material));
+        }).Read(shadowMap).Read(albedo).Read(scenePosition).Read(sceneNormal).Read(material)
+          .Write(sceneScreen).Write(sceneColor);
+    }
+    else {
+        frameGraph->AddPass("Scene", [] {
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            RendererManager::GetInstance()->Draw();
+        }).Read(shadowMap).Write(sceneScreen).Write(scenePosition).Write(sceneNormal).Write(sceneColor).Write(sceneDepth);
+    }
+
+    // upscales the scene to the window, so everything drawn after it stays at native resolution
+    frameGraph->AddPass("Post processing", [graph, sceneScreen, scenePosition, sceneNormal, sceneColor] {
+        auto options = OptionsManager::GetInstance();
+        glm::vec2 renderScale = {(float)graph->GetScaledSize(options->width) / (float)options->width,
+                                 (float)graph->GetScaledSize(options->height) / (float)options->height};
+        PostProcessingManager::GetInstance()->Draw(graph->GetTexture(sceneScreen), graph->GetTexture(scenePosition),
+                                                   graph->GetTexture(sceneNormal), graph->GetTexture(sceneColor),
+                                                   renderScale);
+        glEnable(GL_DEPTH_TEST);
+    }).Read(sceneScreen).Read(scenePosition).Read(sceneNormal).Read(sceneColor).Write(frameGraph->backbuffer);
+
+#ifdef DEBUG
+    frameGraph->AddPass("Colliders", [] {
+        if (SceneManager::GetInstance()->activeScene->GetName() == "MainMenuScene") return;
+        CollisionManager::GetInstance()->Draw();
+    }).Write(frameGraph->backbuffer);
+#endif
+
+    frameGraph->AddPass("UI", [] {
+        UIManager::GetInstance()->Draw();
+    }).Write(frameGraph->backbuffer);
+
+#ifdef DEBUG
+    frameGraph->AddPass("Debug windows", [] {
+        DebugManager::GetInstance()->Render();
+    }).Write(frameGraph->backbuffer);
+#endif
+}
+
 void GloomEngine::AddGameObject(const std::shared_ptr<GameObject>& gameObject) {
     gameObjects.insert({gameObject->GetId(), gameObject});
 }
@@ -2,11 +2,13 @@
 
 #include "LowLevelClasses/Animation.h"
 #include "LowLevelClasses/Bone.h"
+#include "LowLevelClasses/AnimationClip.h"
 #include "ProjectSettings.h"
 
 #include "assimp/Importer.hpp"
 #include "stb_image.h"
 #include "spdlog/spdlog.h"
+#include <cstring>
 
 Animation::Animation() = default;
 
@@ -45,33 +47,22 @@ const std::unordered_map<std::string, BoneInfo>& Animation::GetBoneIDMap() {
     return boneInfoMap;
 }
 
-void Animation::ReadMissingBones(const aiAnimation* animation, const std::shared_ptr<AnimationModel>& model) {
-    unsigned int size = animation->mNumChannels;
+size_t Animation::GetMemory() const {
+    return clip == nullptr ? 0 : clip->GetSize();
+}
+
+void Animation::ReadMissingBones(const std::shared_ptr<const AnimationClip>& animationClip, const std::shared_ptr<AnimationModel>& model) {
+    clip = animationClip;
+    const CookedClipHeader& header = clip->GetHeader();
 
     boneInfoMap = model->GetBoneInfoMap();//getting m_BoneInfoMap from Model class
     uint16_t boneCount = model->GetBoneCount(); //getting the m_BoneCounter from Model class
 
-    //reading channels(bones engaged in an animation and their keyframes)
-    for (unsigned int i = 0; i < size; i++)
+    //reading tracks(bones engaged in an animation and their keyframes)
+    for (uint32_t i = 0; i < header.tracksCount; i++)
     {
-        auto channel = animation->mChannels[i];
-
-        std::string boneName = channel->mNodeName.data;
-
-        int counter = 0;
-
-        for (int j = 0; j < boneName.size(); j++) {
-            if (boneName[j] == '_') counter++;
-            if (counter == 2) {
-                boneName = boneName.substr(j + 1, boneName.back());
-                break;
-            }
-        }
-
-        /// DO NOT TOUCH DOOPA
-        if (counter == 1) {
-            boneName = "doopa";
-        }
+        const CookedTrack& track = clip->GetTrack(i);
+        std::string boneName(clip->GetString(track.name));
 
         if (boneInfoMap.find(boneName) == boneInfoMap.end())
         {
@@ -79,41 +70,28 @@ void Animation::ReadMissingBones(const aiAnimation* animation, const std::shared
             boneCount++;
         }
 
-        bones.insert({boneName, std::make_shared<Bone>(boneName, boneInfoMap[boneName].id, channel)});
+        bones.insert({boneName, std::make_shared<Bone>(boneName, boneInfoMap[boneName].id, clip, &track)});
     }
 }
 
-void Animation::ReadHierarchyData(AssimpNodeData& dest, const aiNode* src) {
-    assert(src);
+uint32_t Animation::ReadHierarchyData(AssimpNodeData& dest, const AnimationClip& clip, uint32_t index) {
+    const CookedNode& node = clip.GetNode(index);
 
-    dest.name = src->mName.data;
+    dest.name = clip.GetString(node.name);
 
     nodeCounter++;
 
-    int counter = 0;
-
-    for (int j = 0; j < dest.name.size(); j++) {
-        if (dest.name[j] == '_') counter++;
-        if (counter == 2) {
-            dest.name = dest.name.substr(j + 1, dest.name.back());
-            break;
-        }
-    }
+    std::memcpy(&dest.transformation, node.transformation, sizeof(dest.transformation));
+    dest.children.resize(node.childrenCount);
 
-    /// DO NOT TOUCH DOOPA
-    if (counter == 1) {
-        dest.name = "doopa";
-    }
-
-    dest.transformation = ConvertMatrixToGLMFormat(src->mTransformation);
-    dest.children.reserve(src->mNumChildren);
-
-    for (int i = 0; i < src->mNumChildren; i++)
+    // children follow their parent depth first
+    ++index;
+    for (auto& child : dest.children)
     {
-        AssimpNodeData newData;
-        ReadHierarchyData(newData, src->mChildren[i]);
-        dest.children.push_back(newData);
+        if (index >= clip.GetHeader().nodesCount) break;
+        index = ReadHierarchyData(child, clip, index);
     }
+    return index;
 }
 
 void Animation::Recalculate(const std::shared_ptr<AnimationModel>& model) {
@@ -131,3 +109,21 @@ void Animation::Recalculate(const std::shared_ptr<AnimationModel>& model) {
     }
 }
 
+
+std::string Animation::GetBoneName(std::string nodeName) {
+    int counter = 0;
+
+    for (int j = 0; j < nodeName.size(); j++) {
+        if (nodeName[j] == '_') counter++;
+        if (counter == 2) {
+            nodeName = nodeName.substr(j + 1, nodeName.back());
+            break;
+        }
+    }
+
+    /// DO NOT TOUCH DOOPA
+    if (counter == 1) {
+        nodeName = "doopa";
+    }
+    return nodeName;
+}
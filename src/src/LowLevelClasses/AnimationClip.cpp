@@ -0,0 +1,359 @@
+#include "LowLevelClasses/AnimationClip.h"
+#include "LowLevelClasses/Animation.h"
+#include "Other/GLMHelper.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+
+#ifdef DEBUG
+#include <tracy/Tracy.hpp>
+#endif
+
+#define QUANTIZED_MAX 65535.0f
+// components other than the largest one lie within [-1/sqrt(2), 1/sqrt(2)]
+#define SMALLEST_THREE_RANGE 0.70710678f
+#define SMALLEST_THREE_MAX 32767.0f
+
+static uint16_t Quantize(float value, float min, float scale) {
+    if (scale <= 0.0f) return 0;
+    return (uint16_t)std::round(std::clamp((value - min) / scale, 0.0f, QUANTIZED_MAX));
+}
+
+static void PackRotation(glm::quat rotation, uint16_t packed[3]) {
+    rotation = glm::normalize(rotation);
+    const float components[4] = {rotation.x, rotation.y, rotation.z, rotation.w};
+    int largest = 0;
+    for (int i = 1; i < 4; ++i) {
+        if (std::abs(components[i]) > std::abs(components[largest])) largest = i;
+    }
+    // q and -q are the same rotation, so the largest component is always made positive and can be restored
+    const float sign = components[largest] < 0.0f ? -1.0f : 1.0f;
+    for (int i = 0, j = 0; i < 4; ++i) {
+        if (i == largest) continue;
+        float normalized = std::clamp(components[i] * sign / SMALLEST_THREE_RANGE, -1.0f, 1.0f);
+        packed[j++] = (uint16_t)std::round((normalized * 0.5f + 0.5f) * SMALLEST_THREE_MAX);
+    }
+    packed[0] |= (uint16_t)((largest & 1) << 15);
+    packed[1] |= (uint16_t)((largest >> 1) << 15);
+}
+
+static glm::quat UnpackRotation(const uint16_t packed[3]) {
+    const int largest = (packed[0] >> 15) | ((packed[1] >> 15) << 1);
+    float components[4];
+    float sum = 0.0f;
+    for (int i = 0, j = 0; i < 4; ++i) {
+        if (i == largest) continue;
+        components[i] = ((float)(packed[j++] & 0x7FFF) / SMALLEST_THREE_MAX * 2.0f - 1.0f) * SMALLEST_THREE_RANGE;
+        sum += components[i] * components[i];
+    }
+    components[largest] = std::sqrt(std::max(0.0f, 1.0f - sum));
+    return {components[3], components[0], components[1], components[2]};
+}
+
+static float GetRotationError(const glm::quat& a, const glm::quat& b) {
+    float dot = std::abs(glm::dot(glm::normalize(a), glm::normalize(b)));
+    return 2.0f * std::acos(std::min(dot, 1.0f));
+}
+
+/**
+ * @annotation
+ * Indices of keys which can't be restored by interpolating between the kept ones, first and last keys are always kept
+ * unless the whole track holds one value.
+ */
+template <typename Value, typename Interpolate, typename Error>
+static std::vector<uint32_t> ReduceKeys(const std::vector<float>& times, const std::vector<Value>& values,
+                                        Interpolate interpolate, Error error, float tolerance) {
+    const auto count = (uint32_t)values.size();
+    if (count == 0) return {};
+    bool isConstant = true;
+    for (uint32_t i = 1; i < count && isConstant; ++i) {
+        isConstant = error(values[0], values[i]) <= tolerance;
+    }
+    if (isConstant) return {0};
+
+    std::vector<uint32_t> keptKeys = {0};
+    uint32_t start = 0;
+    for (uint32_t end = start + 2; end < count; ++end) {
+        const float span = times[end] - times[start];
+        bool canDrop = true;
+        for (uint32_t i = start + 1; i < end && canDrop; ++i) {
+            float factor = span > 0.0f ? (times[i] - times[start]) / span : 0.0f;
+            canDrop = error(interpolate(values[start], values[end], factor), values[i]) <= tolerance;
+        }
+        if (!canDrop) {
+            start = end - 1;
+            keptKeys.push_back(start);
+        }
+    }
+    keptKeys.push_back(count - 1);
+    return keptKeys;
+}
+
+std::shared_ptr<AnimationClip> AnimationClip::Load(const std::string& path) {
+#ifdef DEBUG
+    ZoneScopedNC("Open cooked animation", 0xDC143C);
+#endif
+    std::string cookedPath = GetCookedPath(path);
+    auto clip = std::make_shared<AnimationClip>();
+    if (!clip->file.Open(cookedPath) || !clip->SetContent(clip->file.GetData(), clip->file.GetSize())) return nullptr;
+
+    CookedStamp stamp{};
+    CookedState state = CookedSource::Compare(path, clip->header->stamp, stamp);
+    if (state == CookedState::Current) return clip;
+    clip->file.Close();
+    if (state == CookedState::Changed) return nullptr;
+
+    CookedSource::WriteStamp(cookedPath, offsetof(CookedClipHeader, stamp), stamp);
+    if (!clip->file.Open(cookedPath) || !clip->SetContent(clip->file.GetData(), clip->file.GetSize())) return nullptr;
+    return clip;
+}
+
+std::shared_ptr<AnimationClip> AnimationClip::Create(std::vector<unsigned char> content) {
+    auto clip = std::make_shared<AnimationClip>();
+    clip->content = std::move(content);
+    if (!clip->SetContent(clip->content.data(), clip->content.size())) return nullptr;
+    return clip;
+}
+
+const CookedClipHeader& AnimationClip::GetHeader() const {
+    return *header;
+}
+
+const CookedNode& AnimationClip::GetNode(uint32_t index) const {
+    return ((const CookedNode*)(data + header->nodesOffset))[index];
+}
+
+const CookedTrack& AnimationClip::GetTrack(uint32_t index) const {
+    return ((const CookedTrack*)(data + header->tracksOffset))[index];
+}
+
+std::string_view AnimationClip::GetString(const CookedString& string) const {
+    return {(const char*)(data + header->stringsOffset + string.offset), string.length};
+}
+
+size_t AnimationClip::GetSize() const {
+    return size;
+}
+
+float AnimationClip::GetPositionTime(const CookedTrack& track, uint32_t index) const {
+    return (float)((const uint16_t*)(data + track.positionTimesOffset))[index] / QUANTIZED_MAX * header->duration;
+}
+
+float AnimationClip::GetRotationTime(const CookedTrack& track, uint32_t index) const {
+    return (float)((const uint16_t*)(data + track.rotationTimesOffset))[index] / QUANTIZED_MAX * header->duration;
+}
+
+glm::vec3 AnimationClip::GetPosition(const CookedTrack& track, uint32_t index) const {
+    const uint16_t* position = (const uint16_t*)(data + track.positionsOffset) + index * 3;
+    return {track.minPosition[0] + (float)position[0] * track.positionScale[0],
+            track.minPosition[1] + (float)position[1] * track.positionScale[1],
+            track.minPosition[2] + (float)position[2] * track.positionScale[2]};
+}
+
+glm::quat AnimationClip::GetRotation(const CookedTrack& track, uint32_t index) const {
+    return UnpackRotation((const uint16_t*)(data + track.rotationsOffset) + index * 3);
+}
+
+int AnimationClip::FindPositionIndex(const CookedTrack& track, float time) const {
+    return FindIndex((const uint16_t*)(data + track.positionTimesOffset), track.positionsCount, time);
+}
+
+int AnimationClip::FindRotationIndex(const CookedTrack& track, float time) const {
+    return FindIndex((const uint16_t*)(data + track.rotationTimesOffset), track.rotationsCount, time);
+}
+
+std::string AnimationClip::GetCookedPath(const std::string& path) {
+    return CookedSource::GetCookedPath(path, ".anim");
+}
+
+bool AnimationClip::SetContent(const unsigned char* newData, size_t newSize) {
+    header = nullptr;
+    if (newSize < sizeof(CookedClipHeader)) return false;
+    auto clipHeader = (const CookedClipHeader*)newData;
+    if (clipHeader->magic != ANIMATION_CLIP_MAGIC || clipHeader->version != ANIMATION_CLIP_VERSION ||
+        clipHeader->nodesCount == 0) return false;
+
+    if (!CookedSource::IsInside(clipHeader->nodesOffset, (uint64_t)clipHeader->nodesCount * sizeof(CookedNode), newSize) ||
+        !CookedSource::IsInside(clipHeader->tracksOffset, (uint64_t)clipHeader->tracksCount * sizeof(CookedTrack), newSize) ||
+        !CookedSource::IsInside(clipHeader->stringsOffset, clipHeader->stringsSize, newSize)) return false;
+
+    auto nodes = (const CookedNode*)(newData + clipHeader->nodesOffset);
+    uint64_t childrenCount = 0;
+    for (uint32_t i = 0; i < clipHeader->nodesCount; ++i) {
+        if (!CookedSource::IsInside(nodes[i].name, clipHeader->stringsSize)) return false;
+        childrenCount += nodes[i].childrenCount;
+    }
+    // every node but the root is a child of one other node
+    if (childrenCount != clipHeader->nodesCount - 1) return false;
+
+    auto tracks = (const CookedTrack*)(newData + clipHeader->tracksOffset);
+    for (uint32_t i = 0; i < clipHeader->tracksCount; ++i) {
+        const CookedTrack& track = tracks[i];
+        if (!CookedSource::IsInside(track.name, clipHeader->stringsSize) ||
+            !CookedSource::IsInside(track.positionTimesOffset, (uint64_t)track.positionsCount * sizeof(uint16_t), newSize) ||
+            !CookedSource::IsInside(track.positionsOffset, (uint64_t)track.positionsCount * 3 * sizeof(uint16_t), newSize) ||
+            !CookedSource::IsInside(track.rotationTimesOffset, (uint64_t)track.rotationsCount * sizeof(uint16_t), newSize) ||
+            !CookedSource::IsInside(track.rotationsOffset, (uint64_t)track.rotationsCount * 3 * sizeof(uint16_t), newSize)) return false;
+    }
+
+    data = newData;
+    size = newSize;
+    header = clipHeader;
+    return true;
+}
+
+int AnimationClip::FindIndex(const uint16_t* times, uint32_t count, float time) const {
+    const float quantizedTime = header->duration > 0.0f ? time / header->duration * QUANTIZED_MAX : 0.0f;
+    // first key after the time
+    const uint16_t* next = std::upper_bound(times, times + count, quantizedTime, [](float value, uint16_t key) {
+        return value < (float)key;
+    });
+    if (next == times + count) return -1;
+    return std::max((int)(next - times) - 1, 0);
+}
+
+void AnimationClipCooker::AddHierarchy(const aiNode* node) {
+    nodes.clear();
+    AddNode(node);
+}
+
+void AnimationClipCooker::AddTrack(const aiNodeAnim* channel, float clipDuration) {
+    CookedTrack track{};
+    track.name = AddString(Animation::GetBoneName(channel->mNodeName.C_Str()));
+    sourceKeysMemory += channel->mNumPositionKeys * (sizeof(glm::vec3) + sizeof(float));
+    sourceKeysMemory += channel->mNumRotationKeys * (sizeof(glm::quat) + sizeof(float));
+
+    auto quantizeTime = [clipDuration](float time) {
+        return Quantize(time, 0.0f, clipDuration > 0.0f ? clipDuration / QUANTIZED_MAX : 0.0f);
+    };
+
+    std::vector<float> times(channel->mNumPositionKeys);
+    std::vector<glm::vec3> positions(channel->mNumPositionKeys);
+    for (unsigned int i = 0; i < channel->mNumPositionKeys; ++i) {
+        times[i] = (float)channel->mPositionKeys[i].mTime;
+        positions[i] = GetGLMVec(channel->mPositionKeys[i].mValue);
+    }
+    auto keptPositions = ReduceKeys(times, positions, [](const glm::vec3& a, const glm::vec3& b, float factor) {
+        return glm::mix(a, b, factor);
+    }, [](const glm::vec3& a, const glm::vec3& b) {
+        return glm::distance(a, b);
+    }, ANIMATION_POSITION_TOLERANCE);
+
+    glm::vec3 minPosition(0.0f), maxPosition(0.0f);
+    if (!keptPositions.empty()) minPosition = maxPosition = positions[keptPositions[0]];
+    for (uint32_t key : keptPositions) {
+        minPosition = glm::min(minPosition, positions[key]);
+        maxPosition = glm::max(maxPosition, positions[key]);
+    }
+    const glm::vec3 positionScale = (maxPosition - minPosition) / QUANTIZED_MAX;
+    std::memcpy(track.minPosition, &minPosition, sizeof(track.minPosition));
+    std::memcpy(track.positionScale, &positionScale, sizeof(track.positionScale));
+
+    std::vector<uint16_t> quantizedTimes;
+    std::vector<uint16_t> quantizedValues;
+    for (uint32_t key : keptPositions) {
+        quantizedTimes.push_back(quantizeTime(times[key]));
+        for (int axis = 0; axis < 3; ++axis) {
+            quantizedValues.push_back(Quantize(positions[key][axis], minPosition[axis], positionScale[axis]));
+        }
+    }
+    track.positionsCount = (uint32_t)keptPositions.size();
+    track.positionTimesOffset = AddKeys(quantizedTimes.data(), quantizedTimes.size() * sizeof(uint16_t));
+    track.positionsOffset = AddKeys(quantizedValues.data(), quantizedValues.size() * sizeof(uint16_t));
+
+    times.resize(channel->mNumRotationKeys);
+    std::vector<glm::quat> rotations(channel->mNumRotationKeys);
+    for (unsigned int i = 0; i < channel->mNumRotationKeys; ++i) {
+        times[i] = (float)channel->mRotationKeys[i].mTime;
+        rotations[i] = GetGLMQuat(channel->mRotationKeys[i].mValue);
+    }
+    auto keptRotations = ReduceKeys(times, rotations, [](const glm::quat& a, const glm::quat& b, float factor) {
+        return glm::slerp(a, b, factor);
+    }, GetRotationError, ANIMATION_ROTATION_TOLERANCE);
+
+    quantizedTimes.clear();
+    quantizedValues.clear();
+    for (uint32_t key : keptRotations) {
+        quantizedTimes.push_back(quantizeTime(times[key]));
+        uint16_t packed[3];
+        PackRotation(rotations[key], packed);
+        quantizedValues.insert(quantizedValues.end(), packed, packed + 3);
+    }
+    track.rotationsCount = (uint32_t)keptRotations.size();
+    track.rotationTimesOffset = AddKeys(quantizedTimes.data(), quantizedTimes.size() * sizeof(uint16_t));
+    track.rotationsOffset = AddKeys(quantizedValues.data(), quantizedValues.size() * sizeof(uint16_t));
+
+    tracks.push_back(track);
+}
+
+std::shared_ptr<AnimationClip> AnimationClipCooker::Cook(const std::string& path, float clipDuration, int ticksPerSecond,
+                                                         float importTime) {
+#ifdef DEBUG
+    ZoneScopedNC("Cook animation", 0xDC143C);
+#endif
+    CookedClipHeader header{};
+    header.magic = ANIMATION_CLIP_MAGIC;
+    header.version = ANIMATION_CLIP_VERSION;
+    bool hasStamp = CookedSource::GetStamp(path, header.stamp);
+    header.duration = clipDuration;
+    header.ticksPerSecond = ticksPerSecond;
+    header.nodesCount = (uint32_t)nodes.size();
+    header.tracksCount = (uint32_t)tracks.size();
+    header.sourceKeysMemory = sourceKeysMemory;
+    header.sourceImportTime = importTime;
+    header.nodesOffset = sizeof(CookedClipHeader);
+    header.tracksOffset = header.nodesOffset + nodes.size() * sizeof(CookedNode);
+    header.stringsOffset = header.tracksOffset + tracks.size() * sizeof(CookedTrack);
+    header.stringsSize = strings.size();
+    const uint64_t keysOffset = (header.stringsOffset + header.stringsSize + 7) / 8 * 8;
+
+    std::vector<CookedTrack> fileTracks = tracks;
+    for (auto& track : fileTracks) {
+        track.positionTimesOffset += keysOffset;
+        track.positionsOffset += keysOffset;
+        track.rotationTimesOffset += keysOffset;
+        track.rotationsOffset += keysOffset;
+    }
+
+    std::vector<unsigned char> content(keysOffset + keys.size());
+    std::memcpy(content.data(), &header, sizeof(header));
+    std::memcpy(content.data() + header.nodesOffset, nodes.data(), nodes.size() * sizeof(CookedNode));
+    std::memcpy(content.data() + header.tracksOffset, fileTracks.data(), fileTracks.size() * sizeof(CookedTrack));
+    std::memcpy(content.data() + header.stringsOffset, strings.data(), strings.size());
+    std::memcpy(content.data() + keysOffset, keys.data(), keys.size());
+
+    // a clip without a stamp would be cooked again on every load anyway
+    std::string cookedPath = AnimationClip::GetCookedPath(path);
+    if (hasStamp && CookedSource::Write(cookedPath, content)) {
+        auto clip = std::make_shared<AnimationClip>();
+        if (clip->file.Open(cookedPath) && clip->SetContent(clip->file.GetData(), clip->file.GetSize())) return clip;
+    }
+    return AnimationClip::Create(std::move(content));
+}
+
+void AnimationClipCooker::AddNode(const aiNode* node) {
+    CookedNode cookedNode{};
+    cookedNode.name = AddString(Animation::GetBoneName(node->mName.C_Str()));
+    cookedNode.childrenCount = node->mNumChildren;
+    glm::mat4 transformation = ConvertMatrixToGLMFormat(node->mTransformation);
+    std::memcpy(cookedNode.transformation, &transformation, sizeof(cookedNode.transformation));
+    nodes.push_back(cookedNode);
+
+    for (unsigned int i = 0; i < node->mNumChildren; ++i) {
+        AddNode(node->mChildren[i]);
+    }
+}
+
+CookedString AnimationClipCooker::AddString(const std::string& string) {
+    CookedString cookedString = {(uint32_t)strings.size(), (uint32_t)string.size()};
+    strings += string;
+    return cookedString;
+}
+
+uint64_t AnimationClipCooker::AddKeys(const void* source, size_t keysSize) {
+    uint64_t offset = keys.size();
+    keys.insert(keys.end(), (const unsigned char*)source, (const unsigned char*)source + keysSize);
+    return offset;
+}
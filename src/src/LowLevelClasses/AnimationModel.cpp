@@ -1,11 +1,14 @@
 #include "LowLevelClasses/AnimationModel.h"
 #include "Other/GLMHelper.h"
 #include "ProjectSettings.h"
+#include "LowLevelClasses/MeshCache.h"
+#include "LowLevelClasses/AssimpFileSystem.h"
 
 #include "assimp/Importer.hpp"
 #include "assimp/postprocess.h"
 #include "stb_image.h"
 #include "spdlog/spdlog.h"
+#include <cstring>
 #include <filesystem>
 
 AnimationModel::AnimationModel(const std::string &path, std::shared_ptr<Shader> &shader,
@@ -15,27 +18,71 @@ AnimationModel::AnimationModel(const std::string &path, std::shared_ptr<Shader>
 }
 
 
-AnimationModel::AnimationModel(const Mesh &mesh, std::shared_ptr<Shader> &shader,
+AnimationModel::AnimationModel(Mesh &&mesh, std::shared_ptr<Shader> &shader,
                                int type) : Model(mesh, shader, type) {
     boneInfoMap.reserve(BONE_NUMBER);
-    meshes.push_back(mesh);
+    meshes.push_back(std::move(mesh));
+}
+
+AnimationModel::AnimationModel(std::shared_ptr<Shader> &shader) : Model("", shader) {
+    boneInfoMap.reserve(BONE_NUMBER);
 }
 
 void AnimationModel::LoadModel(std::string const &path)
+{
+    // retrieve the directory path of the filepath
+    directory = path.substr(0, path.find_last_of('/'));
+    // cooked meshes are uploaded straight from the mapped file, Assimp only runs when there is none or the source changed
+    CookedModel cooked;
+    if (cooked.Open(path, true)) {
+        LoadCookedMeshes(cooked);
+        for (uint32_t i = 0; i < cooked.GetBonesCount(); ++i) {
+            const CookedBone& bone = cooked.GetBone(i);
+            BoneInfo boneInfo{};
+            boneInfo.id = bone.id;
+            std::memcpy(&boneInfo.offset, bone.offset, sizeof(boneInfo.offset));
+            boneInfoMap[std::string(cooked.GetString(bone.name))] = boneInfo;
+        }
+        boneCounter = (uint16_t)cooked.GetBonesCount();
+        return;
+    }
+    Import(path);
+}
+
+bool AnimationModel::Cook(const std::string &path) {
+    CookedModel cooked;
+    if (cooked.Open(path, true)) return true;
+    std::shared_ptr<Shader> shader;
+    AnimationModel model(shader);
+    model.directory = path.substr(0, path.find_last_of('/'));
+    model.isCookingOnly = true;
+    return model.Import(path);
+}
+
+bool AnimationModel::Import(const std::string &path)
 {
     // read file via ASSIMP
     Assimp::Importer importer;
+    importer.SetIOHandler(new AssimpFileSystem());
     const aiScene* scene = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_CalcTangentSpace);
     // check for errors
     if(!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) // if is Not Zero
     {
         spdlog::error("ERROR::ASSIMP:: ", importer.GetErrorString());
-        return;
+        return false;
     }
-    // retrieve the directory path of the filepath
-    directory = path.substr(0, path.find_last_of('/'));
-    // process ASSIMP's root node recursively
+    // nodes may share meshes, so there can be more, the vector then grows by moving them
+    if (!isCookingOnly) meshes.reserve(scene->mNumMeshes);
+    // process ASSIMP's root node recursively, cooking every mesh for the next load
+    ModelCooker modelCooker;
+    cooker = &modelCooker;
     ProcessNode(scene->mRootNode, scene);
+    cooker = nullptr;
+    for (const auto& [boneName, boneInfo] : boneInfoMap) {
+        modelCooker.AddBone(boneName, boneInfo.id, boneInfo.offset);
+    }
+    modelCooker.Write(path, true);
+    return true;
 }
 
 void AnimationModel::SetVertexBoneDataToDefault(Vertex& vertex)
@@ -128,7 +175,8 @@ void AnimationModel::ProcessMesh(aiMesh *mesh, const aiScene *scene)
 	ExtractBoneWeightForVertices(vertices,mesh,scene);
 
     // return a mesh object created from the extracted mesh data
-    meshes.emplace_back(vertices, indices, textures);
+    if (cooker != nullptr) cooker->AddMesh(VertexLayout::Skinned, textures, vertices, indices);
+    if (!isCookingOnly) meshes.emplace_back(vertices, indices, textures, VertexLayout::Skinned);
 }
 
 void AnimationModel::SetVertexBoneData(Vertex& vertex, int boneID, float weight)
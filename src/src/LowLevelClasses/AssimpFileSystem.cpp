@@ -0,0 +1,58 @@
+#include "LowLevelClasses/AssimpFileSystem.h"
+
+#include <algorithm>
+#include <cstring>
+
+AssimpFileStream::AssimpFileStream(VirtualFile&& file) : file(std::move(file)) {}
+
+size_t AssimpFileStream::Read(void* buffer, size_t size, size_t count) {
+    if (size == 0) return 0;
+    count = std::min(count, (file.GetSize() - position) / size);
+    std::memcpy(buffer, file.GetData() + position, size * count);
+    position += size * count;
+    return count;
+}
+
+// models are only read
+size_t AssimpFileStream::Write(const void* buffer, size_t size, size_t count) {
+    return 0;
+}
+
+aiReturn AssimpFileStream::Seek(size_t offset, aiOrigin origin) {
+    size_t newPosition;
+    if (origin == aiOrigin_SET) newPosition = offset;
+    else if (origin == aiOrigin_CUR) newPosition = position + offset;
+    else newPosition = file.GetSize() - offset;
+    if (newPosition > file.GetSize()) return aiReturn_FAILURE;
+    position = newPosition;
+    return aiReturn_SUCCESS;
+}
+
+size_t AssimpFileStream::Tell() const {
+    return position;
+}
+
+size_t AssimpFileStream::FileSize() const {
+    return file.GetSize();
+}
+
+void AssimpFileStream::Flush() {}
+
+bool AssimpFileSystem::Exists(const char* path) const {
+    return VirtualFileSystem::GetInstance()->Exists(path);
+}
+
+char AssimpFileSystem::getOsSeparator() const {
+    return '/';
+}
+
+Assimp::IOStream* AssimpFileSystem::Open(const char* path, const char* mode) {
+    if (std::strchr(mode, 'w') != nullptr || std::strchr(mode, 'a') != nullptr) return nullptr;
+    VirtualFile file;
+    if (!VirtualFileSystem::GetInstance()->Open(path, file)) return nullptr;
+    return new AssimpFileStream(std::move(file));
+}
+
+void AssimpFileSystem::Close(Assimp::IOStream* file) {
+    delete file;
+}
@@ -1,40 +1,12 @@
 #include "LowLevelClasses/Bone.h"
 #include "GloomEngine.h"
+#include <algorithm>
 #include <utility>
 
-Bone::Bone(std::string  name, int ID, const aiNodeAnim* channel) : name(std::move(name)), ID(ID), localTransform(1.0f)
-{
-    numPositions = channel->mNumPositionKeys;
-    positions = new KeyPosition[numPositions];
-
-    for (unsigned int positionIndex = 0; positionIndex < numPositions; ++positionIndex)
-    {
-        aiVector3D aiPosition = channel->mPositionKeys[positionIndex].mValue;
-        auto timeStamp = (float)channel->mPositionKeys[positionIndex].mTime;
-        KeyPosition data{};
-        data.position = GetGLMVec(aiPosition);
-        data.timeStamp = timeStamp;
-        positions[positionIndex] = data;
-    }
-
-    numRotations = channel->mNumRotationKeys;
-    rotations = new KeyRotation[numRotations];
-
-    for (unsigned int rotationIndex = 0; rotationIndex < numRotations; ++rotationIndex)
-    {
-        aiQuaternion aiOrientation = channel->mRotationKeys[rotationIndex].mValue;
-        auto timeStamp = (float)channel->mRotationKeys[rotationIndex].mTime;
-        KeyRotation data{};
-        data.orientation = GetGLMQuat(aiOrientation);
-        data.timeStamp = timeStamp;
-        rotations[rotationIndex] = data;
-    }
-}
+Bone::Bone(std::string  name, int ID, std::shared_ptr<const AnimationClip> clip, const CookedTrack* track)
+    : clip(std::move(clip)), track(track), localTransform(1.0f), name(std::move(name)), ID(ID) {}
 
-Bone::~Bone() {
-    delete[] positions;
-    delete[] rotations;
-}
+Bone::~Bone() = default;
 
 
 void Bone::Update(float animationTime, float previousAnimationTime, float blendingTime, const Animation& previousAnimation)
@@ -60,82 +32,87 @@ int Bone::GetBoneID() const{
 }
 
 int Bone::GetPositionIndex(float animationTime) const {
-    for (int index = 0; index < numPositions - 1; ++index)
-    {
-        if (animationTime < positions[index + 1].timeStamp)
-            return index;
-    }
-    return -1;
+    return clip->FindPositionIndex(*track, animationTime);
 }
 
 int Bone::GetRotationIndex(float animationTime) const {
-    for (int index = 0; index < numRotations - 1; ++index)
-    {
-        if (animationTime < rotations[index + 1].timeStamp)
-            return index;
-    }
-    return -1;
+    return clip->FindRotationIndex(*track, animationTime);
 }
 
+// how far the time is between the keys, 0 at the last one and 1 at the next one
 float Bone::GetScaleFactor(float lastTimeStamp, float nextTimeStamp, float animationTime)
 {
-    if (lastTimeStamp + nextTimeStamp == 0)
-        return abs(animationTime / 0.0001f);
-    return abs(animationTime / (nextTimeStamp + lastTimeStamp));
+    float framesDifference = nextTimeStamp - lastTimeStamp;
+    if (framesDifference <= 0.0001f)
+        return 1.0f;
+    return std::clamp((animationTime - lastTimeStamp) / framesDifference, 0.0f, 1.0f);
+}
+
+// -1 is the last key
+glm::vec3 Bone::GetPosition(int index) const {
+    if (track->positionsCount == 0) return glm::vec3(0.0f);
+    return clip->GetPosition(*track, index < 0 ? track->positionsCount - 1 : index);
+}
+
+glm::quat Bone::GetRotation(int index) const {
+    if (track->rotationsCount == 0) return glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+    return clip->GetRotation(*track, index < 0 ? track->rotationsCount - 1 : index);
 }
 
 glm::vec3 Bone::InterpolatePosition(float animationTime, float previousAnimationTime, float blendingTime, Animation& previousAnimation)
 {
-    if (numPositions == 1)
-        return positions[0].position;
+    if (track->positionsCount <= 1)
+        return GetPosition(0);
 
     int p0Index = GetPositionIndex(animationTime);
-    if (p0Index == -1) return glm::vec3(1);
+    // past the last key
+    if (p0Index == -1) return GetPosition(-1);
     if (animationTime <= 0) {
-        float scaleFactor = GetScaleFactor(blendingTime, positions[p0Index].timeStamp, animationTime);
+        float scaleFactor = GetScaleFactor(blendingTime, clip->GetPositionTime(*track, p0Index), animationTime);
 
         auto bone = previousAnimation.FindBone(name);
         if (bone) {
-            const glm::vec3 finalPosition = glm::mix(bone->positions[bone->GetPositionIndex(previousAnimationTime)].position,
-                                                     positions[p0Index].position, 1 - scaleFactor);
+            const glm::vec3 finalPosition = glm::mix(bone->GetPosition(bone->GetPositionIndex(previousAnimationTime)),
+                                                     GetPosition(p0Index), scaleFactor);
             return finalPosition;
         }
-        return glm::vec3(1);
+        return GetPosition(p0Index);
     }
 
     int p1Index = p0Index + 1;
-    float scaleFactor = GetScaleFactor(positions[p0Index].timeStamp, positions[p1Index].timeStamp, animationTime);
-    glm::vec3 finalPosition = glm::mix(positions[p0Index].position, positions[p1Index].position, scaleFactor);
+    float scaleFactor = GetScaleFactor(clip->GetPositionTime(*track, p0Index), clip->GetPositionTime(*track, p1Index), animationTime);
+    glm::vec3 finalPosition = glm::mix(GetPosition(p0Index), GetPosition(p1Index), scaleFactor);
     return finalPosition;
 }
 
 glm::mat4 Bone::InterpolateRotation(float animationTime, float previousAnimationTime, float blendingTime, Animation& previousAnimation)
 {
-    if (numRotations == 1)
+    if (track->rotationsCount <= 1)
     {
-        auto rotation = glm::normalize(rotations[0].orientation);
+        auto rotation = glm::normalize(GetRotation(0));
         return glm::toMat4(rotation);
     }
 
     int p0Index = GetRotationIndex(animationTime);
-    if (p0Index == -1) return glm::mat4(1);
+    // past the last key
+    if (p0Index == -1) return glm::toMat4(glm::normalize(GetRotation(-1)));
 
     if (animationTime <= 0) {
-        float scaleFactor = GetScaleFactor(blendingTime, rotations[p0Index].timeStamp, animationTime);
+        float scaleFactor = GetScaleFactor(blendingTime, clip->GetRotationTime(*track, p0Index), animationTime);
 
         auto bone = previousAnimation.FindBone(name);
         if (bone) {
-            glm::quat finalRotation = glm::slerp(bone->rotations[bone->GetPositionIndex(previousAnimationTime)].orientation,
-                                                 rotations[p0Index].orientation, 1 - scaleFactor);
+            glm::quat finalRotation = glm::slerp(bone->GetRotation(bone->GetRotationIndex(previousAnimationTime)),
+                                                 GetRotation(p0Index), scaleFactor);
             finalRotation = glm::normalize(finalRotation);
             return glm::toMat4(finalRotation);
         }
-        return glm::mat4(1);
+        return glm::toMat4(glm::normalize(GetRotation(p0Index)));
     }
 
     int p1Index = p0Index + 1;
-    float scaleFactor = GetScaleFactor(rotations[p0Index].timeStamp, rotations[p1Index].timeStamp, animationTime);
-    glm::quat finalRotation = glm::slerp(rotations[p0Index].orientation, rotations[p1Index].orientation, scaleFactor);
+    float scaleFactor = GetScaleFactor(clip->GetRotationTime(*track, p0Index), clip->GetRotationTime(*track, p1Index), animationTime);
+    glm::quat finalRotation = glm::slerp(GetRotation(p0Index), GetRotation(p1Index), scaleFactor);
     finalRotation = glm::normalize(finalRotation);
 
     return glm::toMat4(finalRotation);
@@ -0,0 +1,109 @@
+#include "LowLevelClasses/CookedSource.h"
+#include "LowLevelClasses/VirtualFileSystem.h"
+#include "spdlog/spdlog.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <thread>
+
+// material library of .obj files shares the model's name and changes what the import produces as much as the model
+static std::vector<std::string> GetSourceFiles(const std::string& path) {
+    std::vector<std::string> files = {path};
+    std::string materialPath = std::filesystem::path(path).replace_extension(".mtl").string();
+    if (materialPath != files[0] && VirtualFileSystem::GetInstance()->Exists(materialPath)) files.push_back(materialPath);
+    return files;
+}
+
+static bool GetSizeAndTime(const std::vector<std::string>& files, CookedStamp& stamp) {
+    stamp.sourceSize = 0;
+    stamp.sourceTime = 0;
+    VirtualFileInfo info;
+    for (const auto& file : files) {
+        if (!VirtualFileSystem::GetInstance()->GetInfo(file, info)) return false;
+        stamp.sourceSize += info.size;
+        stamp.sourceTime = std::max(stamp.sourceTime, info.writeTime);
+    }
+    return true;
+}
+
+// hash of every file's hash, packed files already store theirs
+static uint64_t Hash(const std::vector<std::string>& files) {
+    auto fileSystem = VirtualFileSystem::GetInstance();
+    uint64_t hash = PACK_HASH_SEED;
+    VirtualFileInfo info;
+    for (const auto& file : files) {
+        uint64_t fileHash = 0;
+        if (fileSystem->GetInfo(file, info) && info.isPacked) {
+            fileHash = info.contentHash;
+        } else {
+            VirtualFile source;
+            fileSystem->Open(file, source);
+            fileHash = PackFile::Hash(source.GetData(), source.GetSize());
+        }
+        hash = PackFile::Hash(&fileHash, sizeof(fileHash), hash);
+    }
+    return hash;
+}
+
+std::string CookedSource::GetCookedPath(const std::string& path, const std::string& extension) {
+    std::filesystem::path normalizedPath = std::filesystem::path(path).lexically_normal();
+    std::filesystem::path cookedPath = "res/cooked";
+    cookedPath /= normalizedPath.lexically_relative("res");
+    cookedPath.replace_extension(extension);
+    return cookedPath.generic_string();
+}
+
+bool CookedSource::GetStamp(const std::string& path, CookedStamp& stamp) {
+    auto files = GetSourceFiles(path);
+    if (!GetSizeAndTime(files, stamp)) return false;
+    stamp.sourceHash = Hash(files);
+    return true;
+}
+
+CookedState CookedSource::Compare(const std::string& path, const CookedStamp& cooked, CookedStamp& current) {
+    auto files = GetSourceFiles(path);
+    if (!GetSizeAndTime(files, current)) return CookedState::Changed;
+    current.sourceHash = cooked.sourceHash;
+    if (current.sourceSize == cooked.sourceSize && current.sourceTime == cooked.sourceTime) return CookedState::Current;
+
+    current.sourceHash = Hash(files);
+    return current.sourceHash == cooked.sourceHash ? CookedState::Touched : CookedState::Changed;
+}
+
+void CookedSource::WriteStamp(const std::string& cookedPath, uint64_t offset, const CookedStamp& stamp) {
+    std::fstream file(cookedPath, std::ios::binary | std::ios::in | std::ios::out);
+    file.seekp((std::streamoff)offset);
+    file.write((const char*)&stamp, sizeof(stamp));
+}
+
+bool CookedSource::Write(const std::string& cookedPath, const std::vector<unsigned char>& content) {
+    std::string temporaryPath = cookedPath + "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + ".tmp";
+    std::error_code error;
+    std::filesystem::create_directories(std::filesystem::path(cookedPath).parent_path(), error);
+    {
+        std::ofstream file(temporaryPath, std::ios::binary);
+        file.write((const char*)content.data(), (std::streamsize)content.size());
+        if (!file) {
+            file.close();
+            std::filesystem::remove(temporaryPath, error);
+            spdlog::info("Failed to write a cooked file at path: " + cookedPath);
+            return false;
+        }
+    }
+    std::filesystem::rename(temporaryPath, cookedPath, error);
+    if (error) {
+        std::filesystem::remove(temporaryPath, error);
+        return false;
+    }
+    return true;
+}
+
+bool CookedSource::IsInside(uint64_t offset, uint64_t rangeSize, uint64_t size) {
+    return offset <= size && rangeSize <= size - offset;
+}
+
+bool CookedSource::IsInside(const CookedString& string, uint64_t stringsSize) {
+    return IsInside(string.offset, string.length, stringsSize);
+}
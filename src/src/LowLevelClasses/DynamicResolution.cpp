@@ -0,0 +1,94 @@
+#include "LowLevelClasses/DynamicResolution.h"
+#include "glad/glad.h"
+
+#include <algorithm>
+
+DynamicResolution::DynamicResolution() {
+    glGenQueries(RESOLUTION_TIMER_QUERIES, queries);
+}
+
+DynamicResolution::~DynamicResolution() = default;
+
+/**
+ * @annotation
+ * Starts measuring GPU time of everything until EndFrame, skipped when all queries are still in flight
+ */
+void DynamicResolution::BeginFrame() {
+    if (pendingQueriesCount == RESOLUTION_TIMER_QUERIES) return;
+
+    unsigned int query = queries[(firstPendingQuery + pendingQueriesCount) % RESOLUTION_TIMER_QUERIES];
+    glBeginQuery(GL_TIME_ELAPSED, query);
+    isTiming = true;
+}
+
+void DynamicResolution::EndFrame() {
+    if (!isTiming) return;
+
+    glEndQuery(GL_TIME_ELAPSED);
+    ++pendingQueriesCount;
+    isTiming = false;
+}
+
+/**
+ * @annotation
+ * Collects finished measurements and moves the scale by one step once enough of them were gathered
+ * @returns scale of scene render targets for this frame
+ */
+float DynamicResolution::Update() {
+    ReadFinishedQueries();
+
+    if (!enabled) {
+        scale = maxScale;
+        frameTimesCount = 0;
+        return scale;
+    }
+    if (frameTimesCount < RESOLUTION_SAMPLES) return scale;
+
+    float sum = 0.0f;
+    for (float frameTime : frameTimes) {
+        sum += frameTime;
+    }
+    lastAverageFrameTime = sum / RESOLUTION_SAMPLES;
+    frameTimesCount = 0;
+
+    float previousScale = scale;
+    if (lastAverageFrameTime > frameBudget * upperThreshold) {
+        scale = std::max(minScale, scale - stepDown);
+    }
+    else if (lastAverageFrameTime < frameBudget * lowerThreshold) {
+        scale = std::min(maxScale, scale + stepUp);
+    }
+    // measurements taken at the old scale mustn't decide the next step
+    if (scale != previousScale) queriesToSkip = pendingQueriesCount;
+    return scale;
+}
+
+float DynamicResolution::GetAverageFrameTime() const {
+    return lastAverageFrameTime;
+}
+
+void DynamicResolution::Free() {
+    glDeleteQueries(RESOLUTION_TIMER_QUERIES, queries);
+}
+
+void DynamicResolution::ReadFinishedQueries() {
+    while (pendingQueriesCount > 0) {
+        unsigned int query = queries[firstPendingQuery];
+        int isAvailable = 0;
+        glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &isAvailable);
+        if (!isAvailable) return;
+
+        GLuint64 elapsed = 0;
+        glGetQueryObjectui64v(query, GL_QUERY_RESULT, &elapsed);
+        firstPendingQuery = (firstPendingQuery + 1) % RESOLUTION_TIMER_QUERIES;
+        --pendingQueriesCount;
+
+        if (queriesToSkip > 0) {
+            --queriesToSkip;
+        }
+        else if (frameTimesCount < RESOLUTION_SAMPLES) {
+            frameTimes[frameTimesCount] = (float)elapsed / 1000000.0f;
+            ++frameTimesCount;
+        }
+    }
+}
@@ -0,0 +1,379 @@
+#include "LowLevelClasses/FrameGraph.h"
+#include "spdlog/spdlog.h"
+
+#include <utility>
+#include <algorithm>
+#include <cmath>
+
+#ifdef DEBUG
+#include <tracy/Tracy.hpp>
+#endif
+
+FrameGraphPass::FrameGraphPass(std::string name, std::function<void()> execute)
+        : name(std::move(name)), execute(std::move(execute)) {}
+
+FrameGraphPass& FrameGraphPass::Read(int resource) {
+    reads.push_back(resource);
+    return *this;
+}
+
+FrameGraphPass& FrameGraphPass::Write(int resource) {
+    writes.push_back(resource);
+    return *this;
+}
+
+FrameGraph::FrameGraph() {
+    backbuffer = ImportTexture("Backbuffer", 0);
+}
+
+FrameGraph::~FrameGraph() {
+    Free();
+}
+
+int FrameGraph::CreateTexture(const std::string& name, const FrameGraphTextureDesc& desc) {
+    FrameGraphResource resource;
+    resource.name = name;
+    resource.desc = desc;
+    resources.push_back(resource);
+    isCompiled = false;
+    return (int)resources.size() - 1;
+}
+
+int FrameGraph::ImportTexture(const std::string& name, unsigned int texture) {
+    FrameGraphResource resource;
+    resource.name = name;
+    resource.desc = {0};
+    resource.isImported = true;
+    resource.texture = texture;
+    resources.push_back(resource);
+    isCompiled = false;
+    return (int)resources.size() - 1;
+}
+
+/**
+ * @annotation
+ * Passes can be added in any order, they are executed after the passes writing textures they read
+ * @param execute - draws the pass, framebuffer and viewport are already bound
+ */
+FrameGraphPass& FrameGraph::AddPass(const std::string& name, const std::function<void()>& execute) {
+    passes.emplace_back(name, execute);
+    isCompiled = false;
+    return passes.back();
+}
+
+/**
+ * @annotation
+ * Single place where the window size reaches render targets, transient textures are recreated on change
+ */
+void FrameGraph::SetScreenSize(int width, int height) {
+    if (width == screenWidth && height == screenHeight) return;
+    screenWidth = width;
+    screenHeight = height;
+    isCompiled = false;
+}
+
+/**
+ * @annotation
+ * Scales the viewport of passes writing textures with isScaled, can change every frame
+ * @param scale - values: (0, 1>
+ */
+void FrameGraph::SetRenderScale(float scale) {
+    renderScale = std::clamp(scale, 0.01f, 1.0f);
+}
+
+void FrameGraph::Compile() {
+#ifdef DEBUG
+    ZoneScopedNC("Compile frame graph", 0xDC143C);
+#endif
+    Free();
+    Cull();
+    Order();
+    AllocateTextures();
+    CreateFramebuffers();
+    isCompiled = true;
+
+    spdlog::info("Frame graph: " + std::to_string(order.size()) + " of " + std::to_string(passes.size()) +
+                 " passes, " + std::to_string(texturePool.size()) + " transient textures, " +
+                 std::to_string(GetTransientMemory() / 1024) + " KB");
+}
+
+void FrameGraph::Execute() {
+    if (!isCompiled) Compile();
+
+    for (int passIndex : order) {
+        const FrameGraphPass& pass = passes[passIndex];
+#ifdef DEBUG
+        ZoneScoped;
+        ZoneName(pass.name.c_str(), pass.name.size());
+#endif
+        if (pass.fbo != 0) {
+            glBindFramebuffer(GL_FRAMEBUFFER, pass.fbo);
+            if (pass.isScaled) glViewport(0, 0, GetScaledSize(pass.width), GetScaledSize(pass.height));
+            else glViewport(0, 0, pass.width, pass.height);
+        }
+        else if (pass.writesBackbuffer) {
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            glViewport(0, 0, screenWidth, screenHeight);
+        }
+        pass.execute();
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+unsigned int FrameGraph::GetTexture(int resource) const {
+    return resources[resource].texture;
+}
+
+float FrameGraph::GetRenderScale() const {
+    return renderScale;
+}
+
+int FrameGraph::GetScaledSize(int size) const {
+    return std::max(1, (int)std::round((float)size * renderScale));
+}
+
+unsigned long long FrameGraph::GetTransientMemory() const {
+    unsigned long long memory = 0;
+    for (const auto& texture : texturePool) {
+        memory += (unsigned long long)texture.width * texture.height * GetBytesPerPixel(texture.internalFormat);
+    }
+    return memory;
+}
+
+int FrameGraph::GetExecutedPassesCount() const {
+    return (int)order.size();
+}
+
+/**
+ * @annotation
+ * Passes writing imported resources are kept, every other pass is kept only if one of its writes is read
+ */
+void FrameGraph::Cull() {
+    std::vector<int> writersCount(passes.size(), 0);
+    std::vector<int> unreadResources;
+
+    for (auto& resource : resources) {
+        resource.readersCount = 0;
+    }
+    for (int i = 0; i < passes.size(); ++i) {
+        FrameGraphPass& pass = passes[i];
+        pass.isCulled = false;
+        pass.hasSideEffects = false;
+        pass.writesBackbuffer = false;
+        for (int resource : pass.reads) {
+            ++resources[resource].readersCount;
+        }
+        for (int resource : pass.writes) {
+            if (resources[resource].isImported) pass.hasSideEffects = true;
+            if (resource == backbuffer) pass.writesBackbuffer = true;
+        }
+        writersCount[i] = (int)pass.writes.size();
+    }
+
+    for (int i = 0; i < resources.size(); ++i) {
+        if (resources[i].readersCount == 0 && !resources[i].isImported) unreadResources.push_back(i);
+    }
+
+    while (!unreadResources.empty()) {
+        int resource = unreadResources.back();
+        unreadResources.pop_back();
+
+        for (int i = 0; i < passes.size(); ++i) {
+            FrameGraphPass& pass = passes[i];
+            if (pass.isCulled || pass.hasSideEffects) continue;
+            if (std::find(pass.writes.begin(), pass.writes.end(), resource) == pass.writes.end()) continue;
+
+            --writersCount[i];
+            if (writersCount[i] > 0) continue;
+
+            pass.isCulled = true;
+            for (int read : pass.reads) {
+                --resources[read].readersCount;
+                if (resources[read].readersCount == 0 && !resources[read].isImported) {
+                    unreadResources.push_back(read);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @annotation
+ * A pass runs after every pass writing a resource it reads and after earlier added passes writing
+ * the same resources, ties are resolved by the order passes were added
+ */
+void FrameGraph::Order() {
+    order.clear();
+
+    std::vector<std::vector<int>> dependencies(passes.size());
+    for (int i = 0; i < passes.size(); ++i) {
+        if (passes[i].isCulled) continue;
+        for (int j = 0; j < passes.size(); ++j) {
+            if (i == j || passes[j].isCulled) continue;
+            const auto& writes = passes[j].writes;
+            auto isWrittenByJ = [&writes](int resource) {
+                return std::find(writes.begin(), writes.end(), resource) != writes.end();
+            };
+            bool readsResult = std::any_of(passes[i].reads.begin(), passes[i].reads.end(), isWrittenByJ);
+            bool writesAfter = j < i && std::any_of(passes[i].writes.begin(), passes[i].writes.end(), isWrittenByJ);
+            if (readsResult || writesAfter) dependencies[i].push_back(j);
+        }
+    }
+
+    std::vector<bool> isOrdered(passes.size(), false);
+    unsigned int passesToOrder = 0;
+    for (const auto& pass : passes) {
+        if (!pass.isCulled) ++passesToOrder;
+    }
+
+    while (order.size() < passesToOrder) {
+        int next = -1;
+        for (int i = 0; i < passes.size() && next == -1; ++i) {
+            if (passes[i].isCulled || isOrdered[i]) continue;
+            bool isReady = std::all_of(dependencies[i].begin(), dependencies[i].end(),
+                                       [&isOrdered](int dependency) { return isOrdered[dependency]; });
+            if (isReady) next = i;
+        }
+        if (next == -1) {
+            spdlog::error("Frame graph has a cycle, remaining passes are executed in the order they were added");
+            for (int i = 0; i < passes.size(); ++i) {
+                if (!passes[i].isCulled && !isOrdered[i]) order.push_back(i);
+            }
+            break;
+        }
+        isOrdered[next] = true;
+        order.push_back(next);
+    }
+}
+
+/**
+ * @annotation
+ * A pooled texture is reused by a transient resource of the same size and format
+ * whose first use comes after the last use of the texture's previous owner
+ */
+void FrameGraph::AllocateTextures() {
+    for (auto& resource : resources) {
+        resource.firstUse = -1;
+        resource.lastUse = -1;
+        if (!resource.isImported) resource.texture = 0;
+    }
+    for (int i = 0; i < order.size(); ++i) {
+        const FrameGraphPass& pass = passes[order[i]];
+        for (const std::vector<int>* accesses : {&pass.reads, &pass.writes}) {
+            for (int resource : *accesses) {
+                if (resources[resource].firstUse == -1) resources[resource].firstUse = i;
+                resources[resource].lastUse = i;
+            }
+        }
+    }
+
+    for (int i = 0; i < order.size(); ++i) {
+        for (auto& resource : resources) {
+            if (resource.isImported || resource.firstUse != i) continue;
+
+            int width = std::max(1, (int)std::round((float)screenWidth * resource.desc.scale));
+            int height = std::max(1, (int)std::round((float)screenHeight * resource.desc.scale));
+
+            PooledTexture* pooled = nullptr;
+            for (auto& texture : texturePool) {
+                if (texture.freeAfter < i && texture.width == width && texture.height == height &&
+                    texture.internalFormat == resource.desc.internalFormat && texture.filter == resource.desc.filter) {
+                    pooled = &texture;
+                    break;
+                }
+            }
+
+            if (pooled == nullptr) {
+                unsigned int texture;
+                glGenTextures(1, &texture);
+                glBindTexture(GL_TEXTURE_2D, texture);
+                glTexStorage2D(GL_TEXTURE_2D, 1, resource.desc.internalFormat, width, height);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, (int)resource.desc.filter);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, (int)resource.desc.filter);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+                texturePool.push_back({texture, width, height, resource.desc.internalFormat,
+                                       resource.desc.filter, -1});
+                pooled = &texturePool.back();
+            }
+
+            pooled->freeAfter = resource.lastUse;
+            resource.texture = pooled->texture;
+        }
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void FrameGraph::CreateFramebuffers() {
+    for (int passIndex : order) {
+        FrameGraphPass& pass = passes[passIndex];
+
+        unsigned int attachments[8];
+        int colorAttachmentsCount = 0;
+        bool hasTransientWrites = false;
+        for (int resource : pass.writes) {
+            if (!resources[resource].isImported) hasTransientWrites = true;
+        }
+        if (!hasTransientWrites) continue;
+
+        pass.isScaled = false;
+        glGenFramebuffers(1, &pass.fbo);
+        glBindFramebuffer(GL_FRAMEBUFFER, pass.fbo);
+        for (int resource : pass.writes) {
+            if (resources[resource].isImported) continue;
+
+            const FrameGraphResource& texture = resources[resource];
+            pass.width = std::max(1, (int)std::round((float)screenWidth * texture.desc.scale));
+            pass.height = std::max(1, (int)std::round((float)screenHeight * texture.desc.scale));
+            pass.isScaled = pass.isScaled || texture.desc.isScaled;
+
+            if (IsDepthFormat(texture.desc.internalFormat)) {
+                glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, texture.texture, 0);
+            }
+            else if (colorAttachmentsCount < 8) {
+                attachments[colorAttachmentsCount] = GL_COLOR_ATTACHMENT0 + colorAttachmentsCount;
+                glFramebufferTexture2D(GL_FRAMEBUFFER, attachments[colorAttachmentsCount], GL_TEXTURE_2D,
+                                       texture.texture, 0);
+                ++colorAttachmentsCount;
+            }
+        }
+        if (colorAttachmentsCount > 0) {
+            glDrawBuffers(colorAttachmentsCount, attachments);
+        }
+        else {
+            glDrawBuffer(GL_NONE);
+        }
+
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+            spdlog::error("Framebuffer of pass " + pass.name + " is not complete!");
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void FrameGraph::Free() {
+    for (auto& pass : passes) {
+        if (pass.fbo != 0) glDeleteFramebuffers(1, &pass.fbo);
+        pass.fbo = 0;
+    }
+    for (const auto& texture : texturePool) {
+        glDeleteTextures(1, &texture.texture);
+    }
+    texturePool.clear();
+    isCompiled = false;
+}
+
+bool FrameGraph::IsDepthFormat(unsigned int internalFormat) {
+    return internalFormat == GL_DEPTH_COMPONENT16 || internalFormat == GL_DEPTH_COMPONENT24 ||
+           internalFormat == GL_DEPTH_COMPONENT32F;
+}
+
+int FrameGraph::GetBytesPerPixel(unsigned int internalFormat) {
+    switch (internalFormat) {
+        case GL_R8: return 1;
+        case GL_DEPTH_COMPONENT16: case GL_RG8: case GL_R16F: return 2;
+        case GL_RGB8: return 3;
+        case GL_RGBA16F: case GL_RG32F: return 8;
+        case GL_RGBA32F: return 16;
+        default: return 4;
+    }
+}
@@ -0,0 +1,130 @@
+#include "LowLevelClasses/GlyphAtlas.h"
+#include "LowLevelClasses/VirtualFileSystem.h"
+#include "glad/glad.h"
+#include "spdlog/spdlog.h"
+
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <ft2build.h>
+#include FT_FREETYPE_H
+
+#define BASE_PATH "res/fonts/"
+
+/**
+ * @param path - path of the font relative to res/fonts
+ * @param fontSize - height of glyphs in pixels
+ */
+GlyphAtlas::GlyphAtlas(const std::string& path, unsigned int fontSize) : path(path), fontSize(fontSize) {}
+
+GlyphAtlas::~GlyphAtlas() = default;
+
+/**
+ * @annotation
+ * Renders glyphs with FreeType and packs them into rows of the atlas on CPU side
+ */
+void GlyphAtlas::Rasterize() {
+    FT_Library ft;
+    if (FT_Init_FreeType(&ft)) {
+        spdlog::info("Could not init FreeType Library");
+        return;
+    }
+    FT_Face face;
+    std::string file = BASE_PATH + path;
+    // the face reads the font until it's done below
+    VirtualFile fontFile;
+    if (!VirtualFileSystem::GetInstance()->Open(file, fontFile) ||
+        FT_New_Memory_Face(ft, fontFile.GetData(), (FT_Long)fontFile.GetSize(), 0, &face)) {
+        spdlog::info("Failed to load font at path: " + file);
+        FT_Done_FreeType(ft);
+        return;
+    }
+    FT_Set_Pixel_Sizes(face, 0, fontSize);
+
+    std::vector<unsigned char> bitmaps[GLYPHS_COUNT];
+    glm::ivec2 positions[GLYPHS_COUNT];
+    glm::ivec2 cursor = {GLYPH_PADDING, GLYPH_PADDING};
+    int rowHeight = 0;
+
+    for (int c = 0; c < GLYPHS_COUNT; ++c) {
+        if (FT_Load_Char(face, c, FT_LOAD_RENDER)) {
+            spdlog::info("Failed to load glyph " + std::to_string(c) + " of font " + path);
+            continue;
+        }
+        FT_GlyphSlot slot = face->glyph;
+        Glyph& glyph = glyphs[c];
+        glyph.size = {slot->bitmap.width, slot->bitmap.rows};
+        glyph.bearing = {slot->bitmap_left, slot->bitmap_top};
+        // advance is number of 1/64 pixels
+        glyph.advance = (int)(slot->advance.x >> 6);
+
+        if (cursor.x + glyph.size.x + GLYPH_PADDING > width) {
+            cursor = {GLYPH_PADDING, cursor.y + rowHeight + GLYPH_PADDING};
+            rowHeight = 0;
+        }
+        positions[c] = cursor;
+        cursor.x += glyph.size.x + GLYPH_PADDING;
+        rowHeight = std::max(rowHeight, glyph.size.y);
+
+        // rows of FreeType bitmaps may be padded, copy them tightly
+        bitmaps[c].resize(glyph.size.x * glyph.size.y);
+        for (int row = 0; row < glyph.size.y; ++row) {
+            std::memcpy(bitmaps[c].data() + row * glyph.size.x,
+                        slot->bitmap.buffer + row * slot->bitmap.pitch, glyph.size.x);
+        }
+    }
+    FT_Done_Face(face);
+    FT_Done_FreeType(ft);
+
+    height = cursor.y + rowHeight + GLYPH_PADDING;
+    pixels.assign(width * height, 0);
+    for (int c = 0; c < GLYPHS_COUNT; ++c) {
+        Glyph& glyph = glyphs[c];
+        for (int row = 0; row < glyph.size.y; ++row) {
+            std::memcpy(pixels.data() + (positions[c].y + row) * width + positions[c].x,
+                        bitmaps[c].data() + row * glyph.size.x, glyph.size.x);
+        }
+        glyph.uvMin = glm::vec2(positions[c]) / glm::vec2(width, height);
+        glyph.uvMax = glm::vec2(positions[c] + glyph.size) / glm::vec2(width, height);
+    }
+}
+
+void GlyphAtlas::Upload() {
+    if (pixels.empty()) return;
+
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, width, height, 0, GL_RED, GL_UNSIGNED_BYTE, pixels.data());
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    pixels.clear();
+    pixels.shrink_to_fit();
+}
+
+// characters outside of ASCII fall back to glyph 0, which draws nothing
+const Glyph& GlyphAtlas::GetGlyph(char character) const {
+    auto index = (unsigned char)character;
+    return glyphs[index < GLYPHS_COUNT ? index : 0];
+}
+
+int GlyphAtlas::GetTextWidth(const std::string& text) const {
+    int textWidth = 0;
+    for (char character : text) {
+        textWidth += GetGlyph(character).advance;
+    }
+    return textWidth;
+}
+
+size_t GlyphAtlas::GetMemory() const {
+    return (size_t)width * height;
+}
+
+void GlyphAtlas::Free() {
+    glDeleteTextures(1, &texture);
+    texture = 0;
+}
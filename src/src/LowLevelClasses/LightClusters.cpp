@@ -0,0 +1,272 @@
+#include "LowLevelClasses/LightClusters.h"
+#include "LowLevelClasses/Shader.h"
+#include "EngineManagers/RendererManager.h"
+#include "GameObjectsAndPrefabs/GameObject.h"
+#include "Components/Renderers/Lights/PointLight.h"
+#include "Components/Renderers/Lights/DirectionalLight.h"
+#include "Components/Renderers/Lights/SpotLight.h"
+#include "spdlog/spdlog.h"
+
+#include <cmath>
+#include <algorithm>
+#include <limits>
+
+#ifdef DEBUG
+#include <tracy/Tracy.hpp>
+#endif
+
+LightClusters::LightClusters() {
+    unsigned int* buffers[5] = {&directionalLightsSSBO, &pointLightsSSBO, &spotLightsSSBO,
+                                &clustersSSBO, &lightIndicesSSBO};
+    for (int i = 0; i < 5; ++i) {
+        glGenBuffers(1, buffers[i]);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, *buffers[i]);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(LightCluster), nullptr, GL_DYNAMIC_DRAW);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1 + i, *buffers[i]);
+    }
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+LightClusters::~LightClusters() {
+    glDeleteBuffers(1, &directionalLightsSSBO);
+    glDeleteBuffers(1, &pointLightsSSBO);
+    glDeleteBuffers(1, &spotLightsSSBO);
+    glDeleteBuffers(1, &clustersSSBO);
+    glDeleteBuffers(1, &lightIndicesSSBO);
+}
+
+/**
+ * @annotation
+ * Gathers enabled lights, assigns them to clusters of the current view and uploads the result
+ * @param view - view matrix of the active camera
+ * @param fov - vertical field of view in degrees
+ */
+void LightClusters::Update(const glm::mat4& view, float fov, float aspect, float near, float far) {
+#ifdef DEBUG
+    ZoneScopedNC("Light clusters", 0xFFD733);
+#endif
+    zNear = near;
+    zFar = far;
+
+    GatherLights(view);
+
+    const float tanHalfFov = std::tan(glm::radians(fov) / 2.0f);
+    const auto chunk = (int)std::ceil((float)CLUSTER_GRID_Z / (float)(maxNumberOfThreads + 1));
+
+    int slice = 0;
+    for (; slice + chunk < CLUSTER_GRID_Z; slice += chunk) {
+        threads.emplace_back(&LightClusters::AssignSlices, this, slice, slice + chunk, tanHalfFov, aspect);
+    }
+    AssignSlices(slice, CLUSTER_GRID_Z, tanHalfFov, aspect);
+
+    for (auto& thread : threads) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+    threads.clear();
+
+    // pack indices of every cluster into one list
+    lightIndices.clear();
+    unsigned int previousFullClustersCount = fullClustersCount;
+    droppedLightsCount = 0;
+    fullClustersCount = 0;
+    for (int i = 0; i < CLUSTERS_NUMBER; ++i) {
+        clusters[i].offset = (unsigned int)lightIndices.size();
+        unsigned int count = clusters[i].pointLightsCount + clusters[i].spotLightsCount;
+        lightIndices.insert(lightIndices.end(), clusterLights[i], clusterLights[i] + count);
+        droppedLightsCount += clusterDroppedLights[i];
+        if (clusterDroppedLights[i] > 0) ++fullClustersCount;
+    }
+#ifdef DEBUG
+    // logged once when clusters fill up, counts of every frame are in the debug window
+    if (fullClustersCount > 0 && previousFullClustersCount == 0) {
+        spdlog::warn("Light clusters: " + std::to_string(droppedLightsCount) + " lights dropped in " +
+                     std::to_string(fullClustersCount) + " clusters over " +
+                     std::to_string(MAX_LIGHTS_PER_CLUSTER) + " lights");
+    }
+#endif
+
+    Upload(directionalLightsSSBO, directionalLights);
+    Upload(pointLightsSSBO, pointLights);
+    Upload(spotLightsSSBO, spotLights);
+    Upload(lightIndicesSSBO, lightIndices);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, clustersSSBO);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(clusters), clusters, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+/**
+ * @attention Shader needs to be active
+ * @param screenSize - size of the framebuffer the shader draws to
+ */
+void LightClusters::SetUniforms(const std::shared_ptr<Shader>& shader, const glm::vec2& screenSize) const {
+    const float logDepthRatio = std::log(zFar / zNear);
+    shader->SetInt("directionalLightsCount", (int)directionalLights.size());
+    shader->SetVec2("clusterTileSize", screenSize / glm::vec2(CLUSTER_GRID_X, CLUSTER_GRID_Y));
+    shader->SetFloat("clusterScale", (float)CLUSTER_GRID_Z / logDepthRatio);
+    shader->SetFloat("clusterBias", (float)CLUSTER_GRID_Z * std::log(zNear) / logDepthRatio);
+}
+
+unsigned int LightClusters::GetLightIndicesCount() const {
+    return (unsigned int)lightIndices.size();
+}
+
+unsigned int LightClusters::GetDroppedLightsCount() const {
+    return droppedLightsCount;
+}
+
+unsigned int LightClusters::GetFullClustersCount() const {
+    return fullClustersCount;
+}
+
+void LightClusters::GatherLights(const glm::mat4& view) {
+    auto rendererManager = RendererManager::GetInstance();
+
+    directionalLights.clear();
+    pointLights.clear();
+    spotLights.clear();
+    pointLightSpheres.clear();
+    spotLightSpheres.clear();
+
+    for (const auto& light : rendererManager->directionalLights) {
+        if (light.second == nullptr || !light.second->enabled) continue;
+        directionalLights.push_back({glm::vec4(light.second->GetParent()->transform->GetForward(), 0.0f),
+                                     glm::vec4(light.second->GetAmbient() * light.second->GetColor(), 0.0f),
+                                     glm::vec4(light.second->GetDiffuse() * light.second->GetColor(), 0.0f)});
+    }
+
+    for (const auto& light : rendererManager->pointLights) {
+        if (light.second == nullptr || !light.second->enabled) continue;
+        glm::vec3 ambient = light.second->GetAmbient() * light.second->GetColor();
+        glm::vec3 diffuse = light.second->GetDiffuse() * light.second->GetColor();
+        float range = CalculateRange(light.second->GetConstant(), light.second->GetLinear(),
+                                     light.second->GetQuadratic(), ambient, diffuse);
+        if (range <= 0.0f) continue;
+        glm::vec3 position = light.second->GetParent()->transform->GetGlobalPosition();
+
+        pointLights.push_back({glm::vec4(position, range),
+                               glm::vec4(light.second->GetConstant(), light.second->GetLinear(),
+                                         light.second->GetQuadratic(), 0.0f),
+                               glm::vec4(ambient, 0.0f), glm::vec4(diffuse, 0.0f)});
+        pointLightSpheres.emplace_back(glm::vec3(view * glm::vec4(position, 1.0f)), range);
+    }
+
+    for (const auto& light : rendererManager->spotLights) {
+        if (light.second == nullptr || !light.second->enabled) continue;
+        glm::vec3 ambient = light.second->GetAmbient() * light.second->GetColor();
+        glm::vec3 diffuse = light.second->GetDiffuse() * light.second->GetColor();
+        float range = CalculateRange(light.second->GetConstant(), light.second->GetLinear(),
+                                     light.second->GetQuadratic(), ambient, diffuse);
+        if (range <= 0.0f) continue;
+        glm::vec3 position = light.second->GetParent()->transform->GetGlobalPosition();
+
+        // cone is bounded by the sphere of its range
+        spotLights.push_back({glm::vec4(position, range),
+                              glm::vec4(light.second->GetParent()->transform->GetForward(), light.second->GetCutOff()),
+                              glm::vec4(light.second->GetConstant(), light.second->GetLinear(),
+                                        light.second->GetQuadratic(), light.second->GetOuterCutOff()),
+                              glm::vec4(ambient, 0.0f), glm::vec4(diffuse, 0.0f)});
+        spotLightSpheres.emplace_back(glm::vec3(view * glm::vec4(position, 1.0f)), range);
+    }
+}
+
+/**
+ * @annotation
+ * Builds bounds of clusters in depth slices [firstSlice, lastSlice) and tests them against light spheres,
+ * slices don't share any data so they can be assigned on separate threads
+ */
+void LightClusters::AssignSlices(int firstSlice, int lastSlice, float tanHalfFov, float aspect) {
+    const float depthRatio = zFar / zNear;
+
+    for (int z = firstSlice; z < lastSlice; ++z) {
+        const float sliceNear = zNear * std::pow(depthRatio, (float)z / CLUSTER_GRID_Z);
+        const float sliceFar = zNear * std::pow(depthRatio, (float)(z + 1) / CLUSTER_GRID_Z);
+
+        for (int y = 0; y < CLUSTER_GRID_Y; ++y) {
+            const float bottom = (-1.0f + 2.0f * (float)y / CLUSTER_GRID_Y) * tanHalfFov;
+            const float top = (-1.0f + 2.0f * (float)(y + 1) / CLUSTER_GRID_Y) * tanHalfFov;
+
+            for (int x = 0; x < CLUSTER_GRID_X; ++x) {
+                const float left = (-1.0f + 2.0f * (float)x / CLUSTER_GRID_X) * tanHalfFov * aspect;
+                const float right = (-1.0f + 2.0f * (float)(x + 1) / CLUSTER_GRID_X) * tanHalfFov * aspect;
+                const int index = x + CLUSTER_GRID_X * (y + CLUSTER_GRID_Y * z);
+
+                ClusterBounds& box = bounds[index];
+                box.min = {std::min(left * sliceNear, left * sliceFar),
+                           std::min(bottom * sliceNear, bottom * sliceFar), -sliceFar};
+                box.max = {std::max(right * sliceNear, right * sliceFar),
+                           std::max(top * sliceNear, top * sliceFar), -sliceNear};
+
+                LightCluster& cluster = clusters[index];
+                cluster.pointLightsCount = 0;
+                cluster.spotLightsCount = 0;
+                unsigned int count = 0;
+                clusterDroppedLights[index] = 0;
+
+                for (unsigned int i = 0; i < pointLightSpheres.size(); ++i) {
+                    if (!Intersects(pointLightSpheres[i], box)) continue;
+                    if (count == MAX_LIGHTS_PER_CLUSTER) {
+                        ++clusterDroppedLights[index];
+                        continue;
+                    }
+                    clusterLights[index][count] = i;
+                    ++count;
+                    ++cluster.pointLightsCount;
+                }
+                for (unsigned int i = 0; i < spotLightSpheres.size(); ++i) {
+                    if (!Intersects(spotLightSpheres[i], box)) continue;
+                    if (count == MAX_LIGHTS_PER_CLUSTER) {
+                        ++clusterDroppedLights[index];
+                        continue;
+                    }
+                    clusterLights[index][count] = i;
+                    ++count;
+                    ++cluster.spotLightsCount;
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @annotation
+ * Distance at which attenuation drops the brightest channel of the light below LIGHT_CUTOFF
+ */
+float LightClusters::CalculateRange(float constant, float linear, float quadratic, const glm::vec3& ambient,
+                                    const glm::vec3& diffuse) {
+    glm::vec3 brightest = glm::max(ambient, diffuse);
+    float intensity = std::max(brightest.x, std::max(brightest.y, brightest.z));
+    if (intensity <= 0.0f) return 0.0f;
+
+    // solve quadratic * d^2 + linear * d + constant = intensity / LIGHT_CUTOFF
+    float c = constant - intensity / LIGHT_CUTOFF;
+    // light is below the cutoff already at its center
+    if (c >= 0.0f) return 0.0f;
+    if (quadratic > 0.0f) {
+        return (-linear + std::sqrt(linear * linear - 4.0f * quadratic * c)) / (2.0f * quadratic);
+    }
+    if (linear > 0.0f) {
+        return -c / linear;
+    }
+    // light without falloff reaches everything
+    return std::numeric_limits<float>::max();
+}
+
+bool LightClusters::Intersects(const glm::vec4& sphere, const ClusterBounds& box) {
+    glm::vec3 center = glm::vec3(sphere);
+    glm::vec3 closest = glm::clamp(center, box.min, box.max);
+    glm::vec3 distance = closest - center;
+    return glm::dot(distance, distance) <= sphere.w * sphere.w;
+}
+
+template<typename T>
+void LightClusters::Upload(unsigned int ssbo, const std::vector<T>& data) {
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, ssbo);
+    // empty buffers are still allocated, so bindings always point to valid storage
+    glBufferData(GL_SHADER_STORAGE_BUFFER, (long long)(std::max<size_t>(data.size(), 1) * sizeof(T)), nullptr,
+                 GL_DYNAMIC_DRAW);
+    if (!data.empty()) {
+        glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, (long long)(data.size() * sizeof(T)), data.data());
+    }
+}
@@ -0,0 +1,141 @@
+#include "LowLevelClasses/MapCache.h"
+
+#include <cstddef>
+#include <cstring>
+
+#ifdef DEBUG
+#include <tracy/Tracy.hpp>
+#endif
+
+bool CookedMap::Open(const std::string& path) {
+#ifdef DEBUG
+    ZoneScopedNC("Open cooked map", 0xDC143C);
+#endif
+    header = nullptr;
+    std::string cookedPath = GetCookedPath(path);
+    auto map = [this, &cookedPath] {
+        if (!file.Open(cookedPath)) return false;
+        data = file.GetData();
+        size = file.GetSize();
+        if (IsValid()) return true;
+        file.Close();
+        return false;
+    };
+    if (!map()) return false;
+    header = (const CookedMapHeader*)data;
+
+    CookedStamp stamp{};
+    CookedState state = CookedSource::Compare(path, header->stamp, stamp);
+    if (state == CookedState::Current) return true;
+    file.Close();
+    header = nullptr;
+    if (state == CookedState::Changed) return false;
+
+    CookedSource::WriteStamp(cookedPath, offsetof(CookedMapHeader, stamp), stamp);
+    if (!map()) return false;
+    header = (const CookedMapHeader*)data;
+    return true;
+}
+
+bool CookedMap::Load(std::vector<unsigned char> cookedContent) {
+    file.Close();
+    header = nullptr;
+    content = std::move(cookedContent);
+    data = content.data();
+    size = content.size();
+    if (!IsValid()) return false;
+    header = (const CookedMapHeader*)data;
+    return true;
+}
+
+uint32_t CookedMap::GetObjectsCount() const {
+    return header == nullptr ? 0 : header->objectsCount;
+}
+
+const CookedMapObject& CookedMap::GetObject(uint32_t index) const {
+    return ((const CookedMapObject*)(data + header->objectsOffset))[index];
+}
+
+std::string_view CookedMap::GetString(const CookedString& string) const {
+    return {(const char*)(data + header->stringsOffset + string.offset), string.length};
+}
+
+size_t CookedMap::GetSize() const {
+    return size;
+}
+
+std::string CookedMap::GetCookedPath(const std::string& path) {
+    return CookedSource::GetCookedPath(path, ".map");
+}
+
+bool CookedMap::IsValid() const {
+    if (size < sizeof(CookedMapHeader)) return false;
+    auto fileHeader = (const CookedMapHeader*)data;
+    if (fileHeader->magic != MAP_CACHE_MAGIC || fileHeader->version != MAP_CACHE_VERSION) return false;
+
+    if (!CookedSource::IsInside(fileHeader->objectsOffset, (uint64_t)fileHeader->objectsCount * sizeof(CookedMapObject), size) ||
+        !CookedSource::IsInside(fileHeader->stringsOffset, fileHeader->stringsSize, size)) return false;
+
+    auto objects = (const CookedMapObject*)(data + fileHeader->objectsOffset);
+    for (uint32_t i = 0; i < fileHeader->objectsCount; ++i) {
+        if (!CookedSource::IsInside(objects[i].uniqueName, fileHeader->stringsSize) ||
+            !CookedSource::IsInside(objects[i].modelPath, fileHeader->stringsSize) ||
+            objects[i].prefab > PrefabType::InvisibleBlock) return false;
+    }
+    return true;
+}
+
+void MapCooker::AddObject(const StaticObjectData& object) {
+    CookedMapObject cookedObject{};
+    cookedObject.uniqueName = AddString(object.uniqueName);
+    cookedObject.modelPath = AddString(object.modelPath);
+    cookedObject.prefab = GetPrefabType(object.name);
+    std::memcpy(cookedObject.position, &object.position, sizeof(cookedObject.position));
+    std::memcpy(cookedObject.rotation, &object.rotation, sizeof(cookedObject.rotation));
+    std::memcpy(cookedObject.scale, &object.scale, sizeof(cookedObject.scale));
+    std::memcpy(cookedObject.coliderSize, &object.coliderSize, sizeof(cookedObject.coliderSize));
+    std::memcpy(cookedObject.coliderOffset, &object.coliderOffset, sizeof(cookedObject.coliderOffset));
+    objects.push_back(cookedObject);
+}
+
+std::vector<unsigned char> MapCooker::Cook(const std::string& path) {
+#ifdef DEBUG
+    ZoneScopedNC("Cook map", 0xDC143C);
+#endif
+    CookedMapHeader header{};
+    // a zero stamp never matches, so the map is cooked again on the next load
+    if (!CookedSource::GetStamp(path, header.stamp)) header.stamp = {};
+    header.magic = MAP_CACHE_MAGIC;
+    header.version = MAP_CACHE_VERSION;
+    header.objectsCount = (uint32_t)objects.size();
+    header.objectsOffset = sizeof(CookedMapHeader);
+    header.stringsOffset = header.objectsOffset + objects.size() * sizeof(CookedMapObject);
+    header.stringsSize = strings.size();
+
+    std::vector<unsigned char> content(header.stringsOffset + header.stringsSize);
+    std::memcpy(content.data(), &header, sizeof(header));
+    std::memcpy(content.data() + header.objectsOffset, objects.data(), objects.size() * sizeof(CookedMapObject));
+    std::memcpy(content.data() + header.stringsOffset, strings.data(), strings.size());
+    return content;
+}
+
+bool MapCooker::Write(const std::string& path) {
+    return CookedSource::Write(CookedMap::GetCookedPath(path), Cook(path));
+}
+
+PrefabType MapCooker::GetPrefabType(std::string_view name) {
+    if (name == "House") return PrefabType::House;
+    if (name == "Shop") return PrefabType::Shop;
+    if (name == "SavePoint") return PrefabType::SavePoint;
+    if (name == "InvisibleBlock") return PrefabType::InvisibleBlock;
+    return PrefabType::None;
+}
+
+CookedString MapCooker::AddString(const std::string& string) {
+    auto cached = stringsIndex.find(string);
+    if (cached != stringsIndex.end()) return cached->second;
+    CookedString cookedString = {(uint32_t)strings.size(), (uint32_t)string.size()};
+    strings += string;
+    stringsIndex.insert({string, cookedString});
+    return cookedString;
+}
@@ -0,0 +1,109 @@
+#include "LowLevelClasses/MappedFile.h"
+
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(const std::string& path) {
+    Open(path);
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept {
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this == &other) return *this;
+    Close();
+    data = std::exchange(other.data, nullptr);
+    size = std::exchange(other.size, 0);
+#ifdef _WIN32
+    file = std::exchange(other.file, nullptr);
+    mapping = std::exchange(other.mapping, nullptr);
+#endif
+    return *this;
+}
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+bool MappedFile::Open(const std::string& path) {
+    Close();
+#ifdef _WIN32
+    HANDLE fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                    FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0) {
+        CloseHandle(fileHandle);
+        return false;
+    }
+    HANDLE mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mappingHandle == nullptr) {
+        CloseHandle(fileHandle);
+        return false;
+    }
+    void* view = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+    if (view == nullptr) {
+        CloseHandle(mappingHandle);
+        CloseHandle(fileHandle);
+        return false;
+    }
+    file = fileHandle;
+    mapping = mappingHandle;
+    data = (const unsigned char*)view;
+    size = (size_t)fileSize.QuadPart;
+#else
+    int descriptor = open(path.c_str(), O_RDONLY);
+    if (descriptor == -1) return false;
+    struct stat fileStat{};
+    if (fstat(descriptor, &fileStat) == -1 || fileStat.st_size == 0) {
+        close(descriptor);
+        return false;
+    }
+    void* view = mmap(nullptr, (size_t)fileStat.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    // the mapping keeps its own reference to the file
+    close(descriptor);
+    if (view == MAP_FAILED) return false;
+    data = (const unsigned char*)view;
+    size = (size_t)fileStat.st_size;
+#endif
+    return true;
+}
+
+void MappedFile::Close() {
+    if (data == nullptr) return;
+#ifdef _WIN32
+    UnmapViewOfFile(data);
+    CloseHandle(mapping);
+    CloseHandle(file);
+    file = nullptr;
+    mapping = nullptr;
+#else
+    munmap((void*)data, size);
+#endif
+    data = nullptr;
+    size = 0;
+}
+
+bool MappedFile::IsOpen() const {
+    return data != nullptr;
+}
+
+const unsigned char* MappedFile::GetData() const {
+    return data;
+}
+
+size_t MappedFile::GetSize() const {
+    return size;
+}
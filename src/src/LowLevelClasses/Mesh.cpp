@@ -6,101 +6,212 @@
 
 #include "LowLevelClasses/Mesh.h"
 #include "EngineManagers/ShadowManager.h"
+#include "EngineManagers/RendererManager.h"
+#include "glm/gtc/packing.hpp"
 
-Mesh::Mesh(std::vector<Vertex> vertices, std::vector<unsigned int> indices, std::vector<Texture> textures) {
-    this->vertices = std::move(vertices);
-    this->indices = std::move(indices);
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+Mesh::Mesh(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices, std::vector<Texture> textures,
+           VertexLayout layout) : Mesh(std::move(textures), layout) {
+    // now that we have all the required data, set the vertex buffers and its attribute pointers.
+    setupMesh(vertices, indices, GL_STATIC_DRAW);
+}
+
+Mesh::Mesh(const unsigned char* packedVertices, unsigned int vertexCount, const unsigned int* indices, unsigned int indexCount,
+           const glm::vec3& minPosition, const glm::vec3& maxPosition, std::vector<Texture> textures, VertexLayout layout)
+           : Mesh(std::move(textures), layout) {
+    this->vertexCount = vertexCount;
+    this->indexCount = indexCount;
+    this->minPosition = minPosition;
+    this->maxPosition = maxPosition;
+    setupPackedMesh(packedVertices, indices, GL_STATIC_DRAW);
+}
+
+Mesh::Mesh(std::vector<Texture> textures, VertexLayout layout) : layout(layout) {
     this->textures = std::move(textures);
-    
+
     // create buffers/arrays
     glGenVertexArrays(1, &vao);
     glGenBuffers(1, &vbo);
     glGenBuffers(1, &ebo);
+}
 
-    // now that we have all the required data, set the vertex buffers and its attribute pointers.
-    setupMesh();
+Mesh::Mesh(Mesh&& other) noexcept : vao(0), vbo(0), ebo(0) {
+    *this = std::move(other);
 }
 
-Mesh::~Mesh() {
-    for (int i = 0; i < textures.size(); ++i) {
-        glDeleteTextures(1, &textures[i].id);
-    }
+Mesh& Mesh::operator=(Mesh&& other) noexcept {
+    if (this == &other) return *this;
+    glDeleteVertexArrays(1, &vao);
+    glDeleteBuffers(1, &vbo);
+    glDeleteBuffers(1, &ebo);
+
+    textures = std::move(other.textures);
+    vao = std::exchange(other.vao, 0);
+    vbo = std::exchange(other.vbo, 0);
+    ebo = std::exchange(other.ebo, 0);
+    layout = other.layout;
+    vertexCount = std::exchange(other.vertexCount, 0);
+    indexCount = std::exchange(other.indexCount, 0);
+    minPosition = other.minPosition;
+    maxPosition = other.maxPosition;
+    return *this;
+}
 
+// textures are shared through TextureManager and released by the model which loaded them
+Mesh::~Mesh() {
     glDeleteVertexArrays(1, &vao);
     glDeleteBuffers(1, &vbo);
     glDeleteBuffers(1, &ebo);
 };
 
 void Mesh::Draw(std::shared_ptr<Shader> &shader, int type) {
-    // bind appropriate textures
-    for (unsigned int i = 0; i < textures.size(); i++) {
-        glActiveTexture(GL_TEXTURE1 + i); // active proper texture unit before binding
-        // retrieve texture number (the N in diffuse_textureN)
-        std::string name = textures[i].type;
-        // now set the sampler to the correct texture unit
-        glUniform1i(glGetUniformLocation(
-                shader->GetShader(),
-                name.c_str()),i+1);
-        // and finally bind the texture
-        glBindTexture(GL_TEXTURE_2D, textures[i].id);
-    }
+    auto rendererManager = RendererManager::GetInstance();
+
+    // bind appropriate textures, units which already hold them are skipped
+    rendererManager->BindTextures(shader, textures);
 
     // draw mesh
-    glBindVertexArray(vao);
-    glDrawElements(type, (int)indices.size(), GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0);
+    rendererManager->BindVertexArray(vao);
+    glDrawElements(type, (int)indexCount, GL_UNSIGNED_INT, 0);
+    ++rendererManager->requestedStats.drawCalls;
+    ++rendererManager->issuedStats.drawCalls;
+}
+
+void Mesh::DrawInstanced(std::shared_ptr<Shader> &shader, int type, int instanceCount, unsigned int firstInstance) {
+    auto rendererManager = RendererManager::GetInstance();
+
+    rendererManager->BindTextures(shader, textures);
+
+    rendererManager->BindVertexArray(vao);
+    glDrawElementsInstancedBaseInstance(type, (int)indexCount, GL_UNSIGNED_INT, 0, instanceCount, firstInstance);
+    rendererManager->requestedStats.drawCalls += instanceCount;
+    ++rendererManager->issuedStats.drawCalls;
+}
 
-    for (unsigned int i = 0; i < textures.size(); i++) {
-        std::string name = textures[i].type;
+void Mesh::setupMesh(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices, int usage)
+{
+    vertexCount = (unsigned int)vertices.size();
+    indexCount = (unsigned int)indices.size();
 
-        // now set the sampler to the correct texture unit
-        glUniform1i(glGetUniformLocation(
-                shader->GetShader(),
-                name.c_str()), GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS);
+    // bounds are all that is left of the vertices once they are on GPU
+    if (!vertices.empty()) {
+        minPosition = vertices[0].position;
+        maxPosition = vertices[0].position;
+    }
+    for (const auto& vertex : vertices) {
+        minPosition = glm::min(minPosition, vertex.position);
+        maxPosition = glm::max(maxPosition, vertex.position);
     }
-    if (!textures.empty()) glBindTexture(GL_TEXTURE_2D, 0);
 
-    // always good practice to set everything back to defaults once configured.
-    glActiveTexture(GL_TEXTURE0);
+    // vertices are packed into the smallest format their layout allows
+    std::vector<unsigned char> packedVertices = PackVertices(vertices, layout);
+    setupPackedMesh(packedVertices.data(), indices.data(), usage);
 }
 
-void Mesh::setupMesh()
+// counts have to be set before
+void Mesh::setupPackedMesh(const unsigned char* packedVertices, const unsigned int* indices, int usage)
 {
     glBindVertexArray(vao);
     // load data into vertex buffers
     glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    // A great thing about structs is that their memory layout is sequential for all its items.
-    // The effect is that we can simply pass a pointer to the struct and it translates perfectly to a glm::vec3/2 array which
-    // again translates to 3/2 floats which translates to a byte array.
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), &vertices[0], GL_STATIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, (long long)GetVertexBufferSize(), packedVertices, usage);
 
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), &indices[0], GL_STATIC_DRAW);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, (long long)indexCount * sizeof(unsigned int), indices, usage);
+
+    SetupVertexAttributes(layout);
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+}
 
-    // set the vertex attribute pointers
-    // vertex Positions
+size_t Mesh::GetVertexBufferSize() const {
+    return (size_t)vertexCount * GetVertexSize(layout);
+}
+
+void Mesh::CopyBuffers(unsigned int vertexBuffer, size_t vertexOffset, unsigned int indexBuffer, size_t indexOffset) const {
+    glCopyNamedBufferSubData(vbo, vertexBuffer, 0, (long long)vertexOffset, (long long)GetVertexBufferSize());
+    glCopyNamedBufferSubData(ebo, indexBuffer, 0, (long long)indexOffset, (long long)indexCount * sizeof(unsigned int));
+}
+
+unsigned int Mesh::GetVertexSize(VertexLayout vertexLayout) {
+    switch (vertexLayout) {
+        case VertexLayout::Static: return sizeof(StaticVertex);
+        case VertexLayout::Skinned: return sizeof(SkinnedVertex);
+    }
+    return sizeof(Vertex);
+}
+
+// weights are rounded to 1/255, rounding error goes to the biggest one so they still sum up to one
+static void PackWeights(const Vertex& vertex, SkinnedVertex& packed) {
+    int sum = 0, biggest = 0;
+    for (int i = 0; i < MAX_BONE_INFLUENCE; ++i) {
+        bool isUsed = vertex.boneIDs[i] >= 0;
+        packed.boneIDs[i] = isUsed ? (uint8_t)vertex.boneIDs[i] : 0;
+        packed.weights[i] = isUsed ? (uint8_t)std::round(std::clamp(vertex.weights[i], 0.0f, 1.0f) * 255.0f) : 0;
+        sum += packed.weights[i];
+        if (packed.weights[i] > packed.weights[biggest]) biggest = i;
+    }
+    if (sum > 0) packed.weights[biggest] = (uint8_t)std::clamp(packed.weights[biggest] + 255 - sum, 0, 255);
+}
+
+std::vector<unsigned char> Mesh::PackVertices(const std::vector<Vertex>& source, VertexLayout vertexLayout) {
+    std::vector<unsigned char> packed(source.size() * GetVertexSize(vertexLayout));
+    unsigned char* destination = packed.data();
+
+    for (const auto& vertex : source) {
+        uint32_t normal = glm::packSnorm3x10_1x2(glm::vec4(vertex.normal, 0.0f));
+        uint32_t texCoords = glm::packHalf2x16(vertex.texCoords);
+
+        switch (vertexLayout) {
+            case VertexLayout::Static: {
+                StaticVertex packedVertex = {vertex.position, normal, texCoords};
+                std::memcpy(destination, &packedVertex, sizeof(packedVertex));
+                break;
+            }
+            case VertexLayout::Skinned: {
+                SkinnedVertex packedVertex = {vertex.position, normal, texCoords};
+                PackWeights(vertex, packedVertex);
+                std::memcpy(destination, &packedVertex, sizeof(packedVertex));
+                break;
+            }
+        }
+        destination += GetVertexSize(vertexLayout);
+    }
+    return packed;
+}
+
+/**
+ * @attention Needs to be called with vertex array and buffer holding vertices of given layout bound
+ */
+void Mesh::SetupVertexAttributes(VertexLayout vertexLayout) {
+    const int stride = (int)GetVertexSize(vertexLayout);
+
+    // vertex Positions, first member of every layout
     glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)0);
+
+    // normals and texture coords are on the same offsets in static and skinned layouts
     // vertex normals
     glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
+    glVertexAttribPointer(1, 4, GL_INT_2_10_10_10_REV, GL_TRUE, stride, (void*)offsetof(StaticVertex, normal));
     // vertex texture coords
     glEnableVertexAttribArray(2);
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, texCoords));
-    // vertex tangent
-    glEnableVertexAttribArray(3);
-    glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, tangent));
-    // vertex bitangent
-    glEnableVertexAttribArray(4);
-    glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, biTangent));
-    // ids
-    glEnableVertexAttribArray(5);
-    glVertexAttribIPointer(5, 4, GL_INT, sizeof(Vertex), (void*)offsetof(Vertex, boneIDs));
-
-    // weights
-    glEnableVertexAttribArray(6);
-    glVertexAttribPointer(6, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, weights));
-    glBindVertexArray(0);
+    glVertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE, stride, (void*)offsetof(StaticVertex, texCoords));
+
+    if (vertexLayout == VertexLayout::Skinned) {
+        // ids
+        glEnableVertexAttribArray(5);
+        glVertexAttribIPointer(5, 4, GL_UNSIGNED_BYTE, stride, (void*)offsetof(SkinnedVertex, boneIDs));
+        // weights
+        glEnableVertexAttribArray(6);
+        glVertexAttribPointer(6, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride, (void*)offsetof(SkinnedVertex, weights));
+    }
+
+    // per instance data
+    RendererManager::GetInstance()->SetupInstanceAttributes();
 }
 
 unsigned int Mesh::GetVBO(){
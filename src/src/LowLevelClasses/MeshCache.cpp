@@ -0,0 +1,191 @@
+#include "LowLevelClasses/MeshCache.h"
+
+#include <cstddef>
+#include <cstring>
+
+#ifdef DEBUG
+#include <tracy/Tracy.hpp>
+#endif
+
+static uint64_t AlignOffset(uint64_t offset) {
+    return (offset + MESH_CACHE_ALIGNMENT - 1) / MESH_CACHE_ALIGNMENT * MESH_CACHE_ALIGNMENT;
+}
+
+bool CookedModel::Open(const std::string& path, bool isSkinned) {
+#ifdef DEBUG
+    ZoneScopedNC("Open cooked model", 0xDC143C);
+#endif
+    header = nullptr;
+    std::string cookedPath = GetCookedPath(path, isSkinned);
+    if (!file.Open(cookedPath)) return false;
+    if (!IsValid() || ((const CookedMeshHeader*)file.GetData())->isSkinned != (uint32_t)isSkinned) {
+        file.Close();
+        return false;
+    }
+    header = (const CookedMeshHeader*)file.GetData();
+
+    CookedStamp stamp{};
+    CookedState state = CookedSource::Compare(path, header->stamp, stamp);
+    if (state == CookedState::Current) return true;
+    file.Close();
+    header = nullptr;
+    if (state == CookedState::Changed) return false;
+
+    CookedSource::WriteStamp(cookedPath, offsetof(CookedMeshHeader, stamp), stamp);
+    if (!file.Open(cookedPath) || !IsValid()) {
+        file.Close();
+        return false;
+    }
+    header = (const CookedMeshHeader*)file.GetData();
+    return true;
+}
+
+uint32_t CookedModel::GetMeshesCount() const {
+    return header->meshesCount;
+}
+
+const CookedMesh& CookedModel::GetMesh(uint32_t index) const {
+    return ((const CookedMesh*)(file.GetData() + header->meshesOffset))[index];
+}
+
+const CookedTexture& CookedModel::GetTexture(uint32_t index) const {
+    return ((const CookedTexture*)(file.GetData() + header->texturesOffset))[index];
+}
+
+uint32_t CookedModel::GetBonesCount() const {
+    return header->bonesCount;
+}
+
+const CookedBone& CookedModel::GetBone(uint32_t index) const {
+    return ((const CookedBone*)(file.GetData() + header->bonesOffset))[index];
+}
+
+std::string_view CookedModel::GetString(const CookedString& string) const {
+    return {(const char*)(file.GetData() + header->stringsOffset + string.offset), string.length};
+}
+
+const unsigned char* CookedModel::GetVertices(const CookedMesh& mesh) const {
+    return file.GetData() + mesh.verticesOffset;
+}
+
+const unsigned int* CookedModel::GetIndices(const CookedMesh& mesh) const {
+    return (const unsigned int*)(file.GetData() + mesh.indicesOffset);
+}
+
+std::string CookedModel::GetCookedPath(const std::string& path, bool isSkinned) {
+    return CookedSource::GetCookedPath(path, isSkinned ? ".skin.mesh" : ".mesh");
+}
+
+bool CookedModel::IsValid() const {
+    const uint64_t size = file.GetSize();
+    if (size < sizeof(CookedMeshHeader)) return false;
+    auto fileHeader = (const CookedMeshHeader*)file.GetData();
+    if (fileHeader->magic != MESH_CACHE_MAGIC || fileHeader->version != MESH_CACHE_VERSION) return false;
+
+    if (!CookedSource::IsInside(fileHeader->meshesOffset, (uint64_t)fileHeader->meshesCount * sizeof(CookedMesh), size) ||
+        !CookedSource::IsInside(fileHeader->texturesOffset, (uint64_t)fileHeader->texturesCount * sizeof(CookedTexture), size) ||
+        !CookedSource::IsInside(fileHeader->bonesOffset, (uint64_t)fileHeader->bonesCount * sizeof(CookedBone), size) ||
+        !CookedSource::IsInside(fileHeader->stringsOffset, fileHeader->stringsSize, size)) return false;
+
+    auto meshes = (const CookedMesh*)(file.GetData() + fileHeader->meshesOffset);
+    for (uint32_t i = 0; i < fileHeader->meshesCount; ++i) {
+        const CookedMesh& mesh = meshes[i];
+        if (mesh.layout > (uint32_t)VertexLayout::Skinned ||
+            !CookedSource::IsInside(mesh.verticesOffset, (uint64_t)mesh.vertexCount * Mesh::GetVertexSize((VertexLayout)mesh.layout), size) ||
+            !CookedSource::IsInside(mesh.indicesOffset, (uint64_t)mesh.indexCount * sizeof(unsigned int), size) ||
+            (uint64_t)mesh.firstTexture + mesh.texturesCount > fileHeader->texturesCount) return false;
+    }
+    auto textures = (const CookedTexture*)(file.GetData() + fileHeader->texturesOffset);
+    for (uint32_t i = 0; i < fileHeader->texturesCount; ++i) {
+        if (!CookedSource::IsInside(textures[i].type, fileHeader->stringsSize) ||
+            !CookedSource::IsInside(textures[i].path, fileHeader->stringsSize)) return false;
+    }
+    auto bones = (const CookedBone*)(file.GetData() + fileHeader->bonesOffset);
+    for (uint32_t i = 0; i < fileHeader->bonesCount; ++i) {
+        if (!CookedSource::IsInside(bones[i].name, fileHeader->stringsSize)) return false;
+    }
+    return true;
+}
+
+void ModelCooker::AddMesh(VertexLayout layout, const std::vector<Texture>& meshTextures, const std::vector<Vertex>& vertices,
+                          const std::vector<unsigned int>& indices) {
+    CookedMesh cookedMesh{};
+    cookedMesh.layout = (uint32_t)layout;
+    cookedMesh.vertexCount = (uint32_t)vertices.size();
+    cookedMesh.indexCount = (uint32_t)indices.size();
+    cookedMesh.firstTexture = (uint32_t)textures.size();
+    cookedMesh.texturesCount = (uint32_t)meshTextures.size();
+    for (const auto& texture : meshTextures) {
+        textures.push_back({AddString(texture.type), AddString(texture.path)});
+    }
+    // the same bounds Mesh computes on upload
+    glm::vec3 minPosition(0.0f), maxPosition(0.0f);
+    if (!vertices.empty()) minPosition = maxPosition = vertices[0].position;
+    for (const auto& vertex : vertices) {
+        minPosition = glm::min(minPosition, vertex.position);
+        maxPosition = glm::max(maxPosition, vertex.position);
+    }
+    std::memcpy(cookedMesh.minPosition, &minPosition, sizeof(cookedMesh.minPosition));
+    std::memcpy(cookedMesh.maxPosition, &maxPosition, sizeof(cookedMesh.maxPosition));
+
+    std::vector<unsigned char> packedVertices = Mesh::PackVertices(vertices, layout);
+    data.resize(AlignOffset(data.size()));
+    cookedMesh.verticesOffset = data.size();
+    data.insert(data.end(), packedVertices.begin(), packedVertices.end());
+
+    data.resize(AlignOffset(data.size()));
+    cookedMesh.indicesOffset = data.size();
+    auto indicesData = (const unsigned char*)indices.data();
+    data.insert(data.end(), indicesData, indicesData + indices.size() * sizeof(unsigned int));
+
+    meshes.push_back(cookedMesh);
+}
+
+void ModelCooker::AddBone(const std::string& name, int id, const glm::mat4& offset) {
+    CookedBone bone{};
+    bone.name = AddString(name);
+    bone.id = id;
+    std::memcpy(bone.offset, &offset, sizeof(bone.offset));
+    bones.push_back(bone);
+}
+
+bool ModelCooker::Write(const std::string& path, bool isSkinned) {
+#ifdef DEBUG
+    ZoneScopedNC("Write cooked model", 0xDC143C);
+#endif
+    CookedMeshHeader header{};
+    if (!CookedSource::GetStamp(path, header.stamp)) return false;
+    header.magic = MESH_CACHE_MAGIC;
+    header.version = MESH_CACHE_VERSION;
+    header.isSkinned = isSkinned;
+    header.meshesCount = (uint32_t)meshes.size();
+    header.texturesCount = (uint32_t)textures.size();
+    header.bonesCount = (uint32_t)bones.size();
+    header.meshesOffset = sizeof(CookedMeshHeader);
+    header.texturesOffset = header.meshesOffset + meshes.size() * sizeof(CookedMesh);
+    header.bonesOffset = header.texturesOffset + textures.size() * sizeof(CookedTexture);
+    header.stringsOffset = header.bonesOffset + bones.size() * sizeof(CookedBone);
+    header.stringsSize = strings.size();
+    const uint64_t dataOffset = AlignOffset(header.stringsOffset + header.stringsSize);
+
+    std::vector<CookedMesh> fileMeshes = meshes;
+    for (auto& mesh : fileMeshes) {
+        mesh.verticesOffset += dataOffset;
+        mesh.indicesOffset += dataOffset;
+    }
+
+    std::vector<unsigned char> content(dataOffset + data.size());
+    std::memcpy(content.data(), &header, sizeof(header));
+    std::memcpy(content.data() + header.meshesOffset, fileMeshes.data(), fileMeshes.size() * sizeof(CookedMesh));
+    std::memcpy(content.data() + header.texturesOffset, textures.data(), textures.size() * sizeof(CookedTexture));
+    std::memcpy(content.data() + header.bonesOffset, bones.data(), bones.size() * sizeof(CookedBone));
+    std::memcpy(content.data() + header.stringsOffset, strings.data(), strings.size());
+    std::memcpy(content.data() + dataOffset, data.data(), data.size());
+    return CookedSource::Write(CookedModel::GetCookedPath(path, isSkinned), content);
+}
+
+CookedString ModelCooker::AddString(const std::string& string) {
+    CookedString cookedString = {(uint32_t)strings.size(), (uint32_t)string.size()};
+    strings += string;
+    return cookedString;
+}
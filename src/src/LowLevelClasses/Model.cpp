@@ -3,46 +3,20 @@
 //
 
 #include "LowLevelClasses/Model.h"
+#include "LowLevelClasses/MeshCache.h"
+#include "EngineManagers/TextureManager.h"
 
 #include "assimp/Importer.hpp"
 #include "assimp/postprocess.h"
 #include "glad/glad.h"
-#include "stb_image.h"
-#include "spdlog/spdlog.h"
+#include <cstring>
 #include <filesystem>
 
 unsigned int Model::TextureFromFile(const char *path, const std::string &textureDir, bool gamma) {
     std::string filename = std::string(path);
     filename = textureDir + '/' + filename;
-    unsigned int textureID;
-    glGenTextures(1, &textureID);
-
-    int width, height, nrComponents;
-    unsigned char *data = stbi_load(filename.c_str(), &width, &height, &nrComponents, 0);
-    if (data) {
-        GLenum format;
-        if (nrComponents == 1)
-            format = GL_RED;
-        else if (nrComponents == 3)
-            format = GL_RGB;
-        else if (nrComponents == 4)
-            format = GL_RGBA;
-
-        glBindTexture(GL_TEXTURE_2D, textureID);
-        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
-
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-        stbi_image_free(data);
-    } else {
-        spdlog::info("Texture failed to load at path: " + (std::string)path);
-        stbi_image_free(data);
-    }
-    return textureID;
+    // models sharing a texture, e.g. buildings using BasicTexture.png, get the same one
+    return TextureManager::GetInstance()->LoadTexture(filename);
 }
 
 Model::Model(std::string const &path, std::shared_ptr<Shader> &shader,
@@ -54,10 +28,18 @@ Model::Model(const Mesh& mesh, std::shared_ptr<Shader> &shader,
 
 Model::~Model() {
     for (int i = 0; i < texturesLoaded.size(); ++i) {
-        glDeleteTextures(1, &texturesLoaded[i].id);
+        TextureManager::GetInstance()->Release(texturesLoaded[i].id);
     }
 }
 
+size_t Model::GetMemory() const {
+    size_t memory = 0;
+    for (const auto& mesh : meshes) {
+        memory += mesh.GetVertexBufferSize() + mesh.indexCount * sizeof(unsigned int);
+    }
+    return memory;
+}
+
 void Model::Draw() {
     for(auto & mesh : meshes) mesh.Draw(shader, type);
 }
@@ -66,6 +48,10 @@ void Model::Draw(std::shared_ptr<Shader> useShader) {
     for(auto & mesh : meshes) mesh.Draw(useShader, type);
 }
 
+void Model::DrawInstanced(std::shared_ptr<Shader> useShader, int instanceCount, unsigned int firstInstance) {
+    for(auto & mesh : meshes) mesh.DrawInstanced(useShader, type, instanceCount, firstInstance);
+}
+
 std::vector<Texture> Model::LoadMaterialTextures(aiMaterial *mat, aiTextureType textureType, std::string typeName) {
     std::vector<Texture> textures;
     for(unsigned int i = 0; i < mat->GetTextureCount(textureType); i++)
@@ -74,26 +60,47 @@ std::vector<Texture> Model::LoadMaterialTextures(aiMaterial *mat, aiTextureType
         mat->GetTexture(textureType, i, &str);
         std::string path = std::filesystem::path(str.C_Str()).generic_string();
         path = path.substr(path.find_last_of('/') + 1);
-        // check if texture was loaded before and if so, continue to next iteration: skip loading a new texture
-        bool skip = false;
-        for(auto & texture : texturesLoaded)
+        textures.push_back(LoadMaterialTexture(path, typeName));
+    }
+    return textures;
+}
+
+Texture Model::LoadMaterialTexture(std::string_view path, std::string_view typeName) {
+    // check if texture was loaded before and if so, skip loading a new texture
+    for(auto & texture : texturesLoaded)
+    {
+        if(texture.path == path)
         {
-            if(std::strcmp(texture.path.data(), path.c_str()) == 0)
-            {
-                textures.push_back(texture);
-                skip = true; // a texture with the same filepath has already been loaded, continue to next one. (optimization)
-                break;
-            }
+            // a texture with the same filepath has already been loaded for another mesh (optimization)
+            return texture;
         }
-        if(!skip)
-        {   // if texture hasn't been loaded already, load it
-            Texture texture;
-            texture.id = TextureFromFile(path.c_str(), this->directory);
-            texture.type = typeName;
-            texture.path = path;
-            textures.push_back(texture);
-            texturesLoaded.push_back(texture);  // store it as texture loaded for entire model, to ensure we won't unnecesery load duplicate textures.
+    }
+    // if texture hasn't been loaded already, load it
+    Texture texture;
+    texture.path = path;
+    texture.type = typeName;
+    texture.id = 0;
+    if (isCookingOnly) return texture;
+    texture.id = TextureFromFile(texture.path.c_str(), this->directory);
+    texturesLoaded.push_back(texture);  // store it as texture loaded for entire model, to ensure we won't unnecesery load duplicate textures.
+    return texture;
+}
+
+void Model::LoadCookedMeshes(const CookedModel& cooked) {
+    // meshes own GL objects, so they can't be copied when the vector grows
+    meshes.reserve(cooked.GetMeshesCount());
+    for (uint32_t i = 0; i < cooked.GetMeshesCount(); ++i) {
+        const CookedMesh& cookedMesh = cooked.GetMesh(i);
+        std::vector<Texture> textures;
+        textures.reserve(cookedMesh.texturesCount);
+        for (uint32_t j = 0; j < cookedMesh.texturesCount; ++j) {
+            const CookedTexture& texture = cooked.GetTexture(cookedMesh.firstTexture + j);
+            textures.push_back(LoadMaterialTexture(cooked.GetString(texture.path), cooked.GetString(texture.type)));
         }
+        glm::vec3 minPosition, maxPosition;
+        std::memcpy(&minPosition, cookedMesh.minPosition, sizeof(minPosition));
+        std::memcpy(&maxPosition, cookedMesh.maxPosition, sizeof(maxPosition));
+        meshes.emplace_back(cooked.GetVertices(cookedMesh), cookedMesh.vertexCount, cooked.GetIndices(cookedMesh),
+                            cookedMesh.indexCount, minPosition, maxPosition, textures, (VertexLayout)cookedMesh.layout);
     }
-    return textures;
 }
@@ -0,0 +1,80 @@
+#include "LowLevelClasses/PackFile.h"
+
+#include <algorithm>
+
+bool PackFile::Open(const std::string& path) {
+    header = nullptr;
+    if (!file.Open(path)) return false;
+    header = (const PackHeader*)file.GetData();
+    if (!IsValid()) {
+        header = nullptr;
+        file.Close();
+        return false;
+    }
+    return true;
+}
+
+bool PackFile::IsOpen() const {
+    return header != nullptr;
+}
+
+const PackEntry* PackFile::Find(std::string_view path) const {
+    if (header == nullptr) return nullptr;
+    uint64_t pathHash = Hash(path.data(), path.size());
+    auto entries = (const PackEntry*)(file.GetData() + header->entriesOffset);
+    auto end = entries + header->entriesCount;
+    auto entry = std::lower_bound(entries, end, pathHash, [](const PackEntry& entry, uint64_t hash) {
+        return entry.pathHash < hash;
+    });
+    // paths sharing a hash are next to each other
+    for (; entry != end && entry->pathHash == pathHash; ++entry) {
+        if (GetPath(*entry) == path) return entry;
+    }
+    return nullptr;
+}
+
+uint32_t PackFile::GetEntriesCount() const {
+    return header == nullptr ? 0 : header->entriesCount;
+}
+
+const PackEntry& PackFile::GetEntry(uint32_t index) const {
+    return ((const PackEntry*)(file.GetData() + header->entriesOffset))[index];
+}
+
+std::string_view PackFile::GetPath(const PackEntry& entry) const {
+    return {(const char*)file.GetData() + header->pathsOffset + entry.pathOffset, entry.pathLength};
+}
+
+const unsigned char* PackFile::GetContent(const PackEntry& entry) const {
+    return file.GetData() + entry.offset;
+}
+
+uint64_t PackFile::Hash(const void* data, size_t size, uint64_t hash) {
+    auto bytes = (const unsigned char*)data;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3;
+    }
+    return hash;
+}
+
+// a truncated archive fails here instead of reading past the mapping later
+bool PackFile::IsValid() const {
+    size_t size = file.GetSize();
+    if (size < sizeof(PackHeader)) return false;
+    if (header->magic != PACK_FILE_MAGIC || header->version != PACK_FILE_VERSION) return false;
+
+    // written without sums, so offsets and sizes of a corrupt table can't overflow past the check
+    auto isInside = [](uint64_t offset, uint64_t rangeSize, uint64_t limit) {
+        return offset <= limit && rangeSize <= limit - offset;
+    };
+    if (!isInside(header->entriesOffset, (uint64_t)header->entriesCount * sizeof(PackEntry), size) ||
+        !isInside(header->pathsOffset, header->pathsSize, size)) return false;
+
+    for (uint32_t i = 0; i < header->entriesCount; ++i) {
+        const PackEntry& entry = GetEntry(i);
+        if (!isInside(entry.offset, entry.size, size)) return false;
+        if (!isInside(entry.pathOffset, entry.pathLength, header->pathsSize)) return false;
+    }
+    return true;
+}
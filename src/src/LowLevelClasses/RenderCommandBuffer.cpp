@@ -0,0 +1,21 @@
+#include "LowLevelClasses/RenderCommandBuffer.h"
+#include "LowLevelClasses/Model.h"
+
+void RenderCommandBuffer::Clear() {
+    commands.clear();
+}
+
+void RenderCommandBuffer::Add(const RenderCommand& command) {
+    commands.push_back(command);
+}
+
+void RenderCommandBuffer::AddModel(Model* model, const RenderCommand& objectCommand) {
+    RenderCommand command = objectCommand;
+    command.primitive = model->GetType();
+    command.setsObjectUniforms = true;
+    for (const auto& mesh : model->GetMeshes()) {
+        command.mesh = &mesh;
+        commands.push_back(command);
+        command.setsObjectUniforms = false;
+    }
+}
@@ -3,10 +3,9 @@
 //
 
 #include "LowLevelClasses/Shader.h"
+#include "LowLevelClasses/VirtualFileSystem.h"
 #include "spdlog/spdlog.h"
-
-#include <sstream>
-#include <fstream>
+#include <string_view>
 
 // Prefix for any path given as shader source
 #define BASE_PATH "res/shaders/"
@@ -71,21 +70,56 @@ Shader::Shader(std::string vertexShaderSource, std::string fragmentShaderSource,
 
 
 void Shader::LoadShader(std::string& shaderPath, std::string& shaderCode) {
-    std::ifstream ShaderFile;
-
-    ShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-
-    try {
-        ShaderFile.open(BASE_PATH + shaderPath);
-        std::stringstream ShaderStream;
-
-        ShaderStream << ShaderFile.rdbuf();
-        ShaderFile.close();
-
-        shaderCode = ShaderStream.str();
-    } catch (std::ifstream::failure& e) {
+    std::set<std::string> includingPaths;
+    LoadShader(shaderPath, shaderCode, includingPaths);
+}
+
+/**
+ * @annotation
+ * GLSL has no includes, lines starting with #include "file" are replaced with the code of the file
+ * @param includingPaths - files whose includes are being expanded, one of them included again is a cycle
+ */
+bool Shader::LoadShader(const std::string& shaderPath, std::string& shaderCode, std::set<std::string>& includingPaths) {
+    VirtualFile shaderFile;
+    if (!VirtualFileSystem::GetInstance()->Open(BASE_PATH + shaderPath, shaderFile)) {
         spdlog::error("Shader file loading failure");
+        return false;
+    }
+    std::string_view source = shaderFile.GetText();
+    includingPaths.insert(shaderPath);
+
+    const std::string directive = "#include";
+    size_t lineStart = 0;
+    while (lineStart < source.size()) {
+        size_t lineEnd = source.find('\n', lineStart);
+        if (lineEnd == std::string_view::npos) lineEnd = source.size();
+        std::string_view line = source.substr(lineStart, lineEnd - lineStart);
+        lineStart = lineEnd + 1;
+
+        size_t first = line.find_first_not_of(" \t");
+        if (first == std::string_view::npos || line.compare(first, directive.size(), directive) != 0) {
+            shaderCode.append(line);
+            shaderCode.push_back('\n');
+            continue;
+        }
+
+        size_t pathStart = line.find('"', first + directive.size());
+        size_t pathEnd = pathStart == std::string_view::npos ? pathStart : line.find('"', pathStart + 1);
+        if (pathEnd == std::string_view::npos) {
+            spdlog::error("Shader include without quoted path in " + shaderPath);
+            return false;
+        }
+
+        std::string includePath(line.substr(pathStart + 1, pathEnd - pathStart - 1));
+        if (includingPaths.contains(includePath)) {
+            spdlog::error("Shader include cycle, " + shaderPath + " includes " + includePath);
+            return false;
+        }
+        if (!LoadShader(includePath, shaderCode, includingPaths)) return false;
     }
+
+    includingPaths.erase(shaderPath);
+    return true;
 }
 
 
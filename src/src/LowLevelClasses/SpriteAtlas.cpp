@@ -0,0 +1,188 @@
+#include "LowLevelClasses/SpriteAtlas.h"
+#include "EngineManagers/TextureManager.h"
+#include "glad/glad.h"
+#include "stb_image.h"
+#include "spdlog/spdlog.h"
+
+#include <algorithm>
+
+#define BASE_PATH "res/textures/"
+
+SpriteAtlas::SpriteAtlas() = default;
+
+SpriteAtlas::~SpriteAtlas() = default;
+
+/**
+ * @annotation
+ * Loads the image and packs it if it's small enough, otherwise takes a shared texture from TextureManager,
+ * which decodes it asynchronously
+ * @param path - path of the image relative to res/textures
+ * @returns sprite with texture 0 if the image couldn't be loaded
+ */
+Sprite SpriteAtlas::Load(const std::string& path) {
+    auto packedSprite = packedSprites.find(path);
+    if (packedSprite != packedSprites.end()) return packedSprite->second;
+
+    Sprite sprite;
+    int nrChannels;
+    std::string file = BASE_PATH + path;
+    // sizes and translucency of big images are remembered, so a cached texture doesn't need decoding
+    auto textureSprite = textureSprites.find(path);
+    if (textureSprite != textureSprites.end()) {
+        sprite = textureSprite->second;
+        sprite.texture = TextureManager::GetInstance()->Acquire(file, TextureWrap::ClampWithAlpha);
+        if (sprite.texture != 0) return sprite;
+    }
+    if (!TextureManager::GetImageInfo(file, sprite.width, sprite.height, nrChannels)) {
+        spdlog::info("Failed to load texture at path: " + file);
+        return sprite;
+    }
+    // big images, e.g. backgrounds and cheat sheets, are decoded on workers and show nothing until uploaded
+    if (sprite.width > MAX_PACKED_SPRITE_SIZE || sprite.height > MAX_PACKED_SPRITE_SIZE) {
+        sprite.texture = TextureManager::GetInstance()->LoadTextureAsync(file, TextureWrap::ClampWithAlpha,
+                                                                         sprite.width, sprite.height, nrChannels);
+        if (sprite.texture == 0) return sprite;
+        // pixels aren't known yet, so images with alpha are drawn as if they blend
+        sprite.isTranslucent = nrChannels == 4;
+        textureSprites.insert({path, sprite});
+        return sprite;
+    }
+
+    unsigned char* data = TextureManager::LoadImage(file, sprite.width, sprite.height, nrChannels, 0);
+    if (!data) {
+        spdlog::info("Failed to load texture at path: " + file);
+        return sprite;
+    }
+
+    const int texelsCount = sprite.width * sprite.height;
+    // alpha test discards texels below 0.5, everything between it and 1 blends
+    if (nrChannels == 4) {
+        for (int i = 0; i < texelsCount; ++i) {
+            if (data[i * 4 + 3] >= 128 && data[i * 4 + 3] < 255) {
+                sprite.isTranslucent = true;
+                break;
+            }
+        }
+    }
+
+    // pages are RGBA, missing channels are filled the same way GL fills them for GL_RED and GL_RGB textures
+    std::vector<unsigned char> pixels(texelsCount * 4);
+    for (int i = 0; i < texelsCount; ++i) {
+        pixels[i * 4 + 0] = data[i * nrChannels];
+        pixels[i * 4 + 1] = nrChannels >= 3 ? data[i * nrChannels + 1] : 0;
+        pixels[i * 4 + 2] = nrChannels >= 3 ? data[i * nrChannels + 2] : 0;
+        pixels[i * 4 + 3] = nrChannels == 4 ? data[i * nrChannels + 3] : 255;
+    }
+    if (Pack(pixels.data(), sprite.width, sprite.height, sprite)) {
+        packedSprites.insert({path, sprite});
+        stbi_image_free(data);
+        return sprite;
+    }
+
+    // only happens once the atlas can't fit the sprite at all
+    sprite.texture = TextureManager::GetInstance()->AddTexture(file, TextureWrap::ClampWithAlpha, data,
+                                                               sprite.width, sprite.height, nrChannels);
+    textureSprites.insert({path, sprite});
+
+    stbi_image_free(data);
+    return sprite;
+}
+
+void SpriteAtlas::Release(Sprite& sprite) {
+    if (!sprite.isPacked && sprite.texture != 0) {
+        TextureManager::GetInstance()->Release(sprite.texture);
+    }
+    sprite.texture = 0;
+}
+
+void SpriteAtlas::Update() {
+    for (auto& page : pages) {
+        if (!page.isDirty) continue;
+        glBindTexture(GL_TEXTURE_2D, page.texture);
+        glGenerateMipmap(GL_TEXTURE_2D);
+        page.isDirty = false;
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+size_t SpriteAtlas::GetMemory() const {
+    // RGBA8 with a third more for mipmaps
+    return pages.size() * SPRITE_ATLAS_SIZE * SPRITE_ATLAS_SIZE * 4 * 4 / 3;
+}
+
+size_t SpriteAtlas::GetPagesCount() const {
+    return pages.size();
+}
+
+void SpriteAtlas::Free() {
+    for (auto& page : pages) {
+        glDeleteTextures(1, &page.texture);
+    }
+    pages.clear();
+    packedSprites.clear();
+    textureSprites.clear();
+}
+
+/**
+ * @annotation
+ * Places the image into a row of the last page, border texels are repeated into the padding
+ * so neither linear filtering nor mipmaps mix neighbouring sprites
+ */
+bool SpriteAtlas::Pack(const unsigned char* pixels, int width, int height, Sprite& sprite) {
+    // sizes stay multiples of the last mip level's texel, so sprites never share a texel of any level
+    const int alignment = 1 << (SPRITE_ATLAS_LEVELS - 1);
+    const int paddedWidth = (width + 2 * SPRITE_PADDING + alignment - 1) / alignment * alignment;
+    const int paddedHeight = (height + 2 * SPRITE_PADDING + alignment - 1) / alignment * alignment;
+    if (paddedWidth > SPRITE_ATLAS_SIZE || paddedHeight > SPRITE_ATLAS_SIZE) return false;
+
+    if (pages.empty()) AddPage();
+    SpriteAtlasPage* page = &pages.back();
+    if (page->cursor.x + paddedWidth > SPRITE_ATLAS_SIZE) {
+        page->cursor = {0, page->cursor.y + page->rowHeight};
+        page->rowHeight = 0;
+    }
+    if (page->cursor.y + paddedHeight > SPRITE_ATLAS_SIZE) {
+        AddPage();
+        page = &pages.back();
+    }
+
+    std::vector<unsigned char> padded(paddedWidth * paddedHeight * 4);
+    for (int y = 0; y < paddedHeight; ++y) {
+        int sourceY = std::clamp(y - SPRITE_PADDING, 0, height - 1);
+        for (int x = 0; x < paddedWidth; ++x) {
+            int sourceX = std::clamp(x - SPRITE_PADDING, 0, width - 1);
+            std::copy_n(pixels + (sourceY * width + sourceX) * 4, 4, padded.data() + (y * paddedWidth + x) * 4);
+        }
+    }
+
+    glBindTexture(GL_TEXTURE_2D, page->texture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, page->cursor.x, page->cursor.y, paddedWidth, paddedHeight,
+                    GL_RGBA, GL_UNSIGNED_BYTE, padded.data());
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glm::vec2 origin = glm::vec2(page->cursor + SPRITE_PADDING);
+    sprite.texture = page->texture;
+    sprite.uvMin = origin / (float)SPRITE_ATLAS_SIZE;
+    sprite.uvMax = (origin + glm::vec2(width, height)) / (float)SPRITE_ATLAS_SIZE;
+    sprite.isPacked = true;
+
+    page->cursor.x += paddedWidth;
+    page->rowHeight = std::max(page->rowHeight, paddedHeight);
+    page->isDirty = true;
+    return true;
+}
+
+void SpriteAtlas::AddPage() {
+    SpriteAtlasPage page;
+    glGenTextures(1, &page.texture);
+    glBindTexture(GL_TEXTURE_2D, page.texture);
+    glTexStorage2D(GL_TEXTURE_2D, SPRITE_ATLAS_LEVELS, GL_RGBA8, SPRITE_ATLAS_SIZE, SPRITE_ATLAS_SIZE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, SPRITE_ATLAS_LEVELS - 1);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    pages.push_back(page);
+}
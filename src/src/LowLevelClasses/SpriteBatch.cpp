@@ -0,0 +1,175 @@
+#include "LowLevelClasses/SpriteBatch.h"
+#include "LowLevelClasses/SpriteAtlas.h"
+#include "LowLevelClasses/GlyphAtlas.h"
+#include "LowLevelClasses/Shader.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+#ifdef DEBUG
+#include <tracy/Tracy.hpp>
+#endif
+
+SpriteBatch::SpriteBatch() {
+    opaqueQuads.reserve(MAX_SPRITE_QUADS);
+    translucentQuads.reserve(MAX_SPRITE_QUADS);
+
+    // indices never change, every quad uses the same pattern offset by its first vertex
+    std::vector<unsigned int> indices(MAX_SPRITE_QUADS * 6);
+    for (unsigned int i = 0; i < MAX_SPRITE_QUADS; ++i) {
+        indices[i * 6 + 0] = i * 4 + 0;
+        indices[i * 6 + 1] = i * 4 + 1;
+        indices[i * 6 + 2] = i * 4 + 3;
+        indices[i * 6 + 3] = i * 4 + 0;
+        indices[i * 6 + 4] = i * 4 + 2;
+        indices[i * 6 + 5] = i * 4 + 3;
+    }
+
+    glGenVertexArrays(1, &vao);
+    glGenBuffers(1, &vbo);
+    glGenBuffers(1, &ebo);
+
+    glBindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferData(GL_ARRAY_BUFFER, MAX_SPRITE_QUADS * 4 * sizeof(SpriteVertex), nullptr, GL_STREAM_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)(indices.size() * sizeof(unsigned int)), indices.data(), GL_STATIC_DRAW);
+
+    // position and texture coords on the same locations as in Mesh layouts, color and text flag on locations 3 and 4
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(SpriteVertex), (void*)offsetof(SpriteVertex, position));
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(SpriteVertex), (void*)offsetof(SpriteVertex, texCoords));
+    glEnableVertexAttribArray(3);
+    glVertexAttribPointer(3, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(SpriteVertex), (void*)offsetof(SpriteVertex, color));
+    glEnableVertexAttribArray(4);
+    glVertexAttribPointer(4, 1, GL_FLOAT, GL_FALSE, sizeof(SpriteVertex), (void*)offsetof(SpriteVertex, isText));
+    glBindVertexArray(0);
+}
+
+SpriteBatch::~SpriteBatch() = default;
+
+void SpriteBatch::NextComponent() {
+    ++componentsCount;
+}
+
+void SpriteBatch::AddSprite(const Sprite& sprite, const glm::vec2 corners[4], const glm::vec4& color, float z) {
+    if (sprite.texture == 0) return;
+    SpriteQuad* quad = AddQuad(sprite.texture, z, sprite.isTranslucent || color.a < 1.0f);
+    if (quad == nullptr) return;
+
+    glm::u8vec4 packedColor = glm::u8vec4(glm::clamp(color, 0.0f, 1.0f) * 255.0f + 0.5f);
+    glm::vec2 texCoords[4] = {sprite.uvMin, {sprite.uvMin.x, sprite.uvMax.y}, {sprite.uvMax.x, sprite.uvMin.y}, sprite.uvMax};
+    for (int i = 0; i < 4; ++i) {
+        quad->vertices[i] = {{corners[i].x / 960 - 1, corners[i].y / 540 - 1, quad->depth}, texCoords[i], packedColor, 0.0f};
+    }
+}
+
+void SpriteBatch::AddText(const GlyphAtlas& atlas, const std::string& text, float x, float y, float z, const glm::vec3& color) {
+    glm::u8vec4 packedColor = glm::u8vec4(glm::vec4(glm::clamp(color, 0.0f, 1.0f), 1.0f) * 255.0f + 0.5f);
+    for (char character : text) {
+        const Glyph& glyph = atlas.GetGlyph(character);
+        if (glyph.size.x > 0 && glyph.size.y > 0) {
+            // alpha tested glyphs are always opaque
+            SpriteQuad* quad = AddQuad(atlas.texture, z, false);
+            if (quad == nullptr) return;
+
+            float left = (x + (float)glyph.bearing.x) / 960 - 1;
+            float right = (x + (float)(glyph.bearing.x + glyph.size.x)) / 960 - 1;
+            float bottom = (y - (float)(glyph.size.y - glyph.bearing.y)) / 540 - 1;
+            float top = (y + (float)glyph.bearing.y) / 540 - 1;
+
+            // rows of the atlas go from the top of glyphs down
+            quad->vertices[0] = {{left, bottom, quad->depth}, {glyph.uvMin.x, glyph.uvMax.y}, packedColor, 1.0f};
+            quad->vertices[1] = {{left, top, quad->depth}, {glyph.uvMin.x, glyph.uvMin.y}, packedColor, 1.0f};
+            quad->vertices[2] = {{right, bottom, quad->depth}, {glyph.uvMax.x, glyph.uvMax.y}, packedColor, 1.0f};
+            quad->vertices[3] = {{right, top, quad->depth}, {glyph.uvMax.x, glyph.uvMin.y}, packedColor, 1.0f};
+        }
+        x += (float)glyph.advance;
+    }
+}
+
+/**
+ * @annotation
+ * Sorts quads of the frame, uploads them into the streaming vertex buffer and draws runs sharing a texture with one call
+ */
+void SpriteBatch::Draw(const std::shared_ptr<Shader>& shader) {
+#ifdef DEBUG
+    ZoneScopedNC("Sprite batch", 0x800080);
+#endif
+    drawCallsCount = 0;
+    quadsCount = opaqueQuads.size() + translucentQuads.size();
+    componentsCount = 0;
+    if (quadsCount == 0) return;
+
+    std::stable_sort(opaqueQuads.begin(), opaqueQuads.end(), [](const SpriteQuad& a, const SpriteQuad& b) {
+        return a.texture < b.texture;
+    });
+    std::stable_sort(translucentQuads.begin(), translucentQuads.end(), [](const SpriteQuad& a, const SpriteQuad& b) {
+        return a.depth > b.depth;
+    });
+
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    // invalidating lets the driver hand out new storage instead of waiting for last frame's draws
+    auto destination = (SpriteVertex*)glMapBufferRange(GL_ARRAY_BUFFER, 0, (GLsizeiptr)(quadsCount * sizeof(SpriteQuad::vertices)),
+                                                       GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    for (const auto& quads : {&opaqueQuads, &translucentQuads}) {
+        for (const auto& quad : *quads) {
+            std::memcpy(destination, quad.vertices, sizeof(quad.vertices));
+            destination += 4;
+        }
+    }
+    glUnmapBuffer(GL_ARRAY_BUFFER);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    shader->Activate();
+    shader->SetInt("texture1", 0);
+    glActiveTexture(GL_TEXTURE0);
+    glBindVertexArray(vao);
+
+    size_t offset = 0;
+    for (const auto& quads : {&opaqueQuads, &translucentQuads}) {
+        size_t first = 0;
+        while (first < quads->size()) {
+            size_t last = first + 1;
+            while (last < quads->size() && (*quads)[last].texture == (*quads)[first].texture) ++last;
+
+            glBindTexture(GL_TEXTURE_2D, (*quads)[first].texture);
+            glDrawElements(GL_TRIANGLES, (GLsizei)((last - first) * 6), GL_UNSIGNED_INT,
+                           (void*)((offset + first) * 6 * sizeof(unsigned int)));
+            ++drawCallsCount;
+            first = last;
+        }
+        offset += quads->size();
+    }
+
+    glBindVertexArray(0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    opaqueQuads.clear();
+    translucentQuads.clear();
+}
+
+unsigned int SpriteBatch::GetDrawCallsCount() const {
+    return drawCallsCount;
+}
+
+unsigned int SpriteBatch::GetQuadsCount() const {
+    return quadsCount;
+}
+
+void SpriteBatch::Free() {
+    glDeleteVertexArrays(1, &vao);
+    glDeleteBuffers(1, &vbo);
+    glDeleteBuffers(1, &ebo);
+}
+
+SpriteQuad* SpriteBatch::AddQuad(unsigned int texture, float z, bool isTranslucent) {
+    if (opaqueQuads.size() + translucentQuads.size() >= MAX_SPRITE_QUADS) return nullptr;
+
+    SpriteQuad& quad = isTranslucent ? translucentQuads.emplace_back() : opaqueQuads.emplace_back();
+    quad.texture = texture;
+    quad.depth = z + (float)componentsCount * SPRITE_ORDER_BIAS;
+    quad.isTranslucent = isTranslucent;
+    return &quad;
+}
@@ -0,0 +1,188 @@
+#include "LowLevelClasses/StaticGeometryPool.h"
+#include "LowLevelClasses/StaticModel.h"
+#include "EngineManagers/RendererManager.h"
+#include "spdlog/spdlog.h"
+
+#include <algorithm>
+
+#ifdef DEBUG
+#include <tracy/Tracy.hpp>
+#endif
+
+StaticGeometryPool::StaticGeometryPool() {
+    glGenBuffers(1, &indirectBuffer);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer);
+    glBufferData(GL_DRAW_INDIRECT_BUFFER, sizeof(commands), nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
+StaticGeometryPool::~StaticGeometryPool() {
+    Clear();
+    glDeleteBuffers(1, &indirectBuffer);
+}
+
+/**
+ * @annotation
+ * Packs meshes of given models into one vertex and index buffer, replaces previous content of the pool
+ * @param models - models drawn with GL_TRIANGLES, e.g. Renderer::models
+ */
+void StaticGeometryPool::Build(const std::unordered_map<int, AssetHandle<StaticModel>>& models) {
+#ifdef DEBUG
+    ZoneScopedNC("Build static geometry pool", 0xDC143C);
+#endif
+    Clear();
+
+    // ranges are laid out first, so the pool's buffers can be allocated once
+    unsigned int verticesCount = 0;
+    unsigned int indicesCount = 0;
+
+    for (const auto& model : models) {
+        std::vector<PoolRange> modelRanges;
+        for (const auto& mesh : model.second->GetMeshes()) {
+            modelRanges.push_back({indicesCount, mesh.indexCount, (int)verticesCount, &mesh.textures});
+            verticesCount += mesh.vertexCount;
+            indicesCount += mesh.indexCount;
+        }
+        ranges.insert({model.second.Get(), modelRanges});
+    }
+
+    if (verticesCount == 0) return;
+
+    glGenVertexArrays(1, &vao);
+    glGenBuffers(1, &vbo);
+    glGenBuffers(1, &ebo);
+
+    glBindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferData(GL_ARRAY_BUFFER, (long long)verticesCount * sizeof(StaticVertex), nullptr, GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, (long long)indicesCount * sizeof(unsigned int), nullptr, GL_STATIC_DRAW);
+    Mesh::SetupVertexAttributes(VertexLayout::Static);
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    // meshes don't keep their vertices after upload, their buffers are copied without leaving the GPU,
+    // indices stay relative to the mesh because draws use its base vertex
+    for (const auto& model : models) {
+        const auto& meshes = model.second->GetMeshes();
+        const auto& modelRanges = ranges[model.second.Get()];
+        for (size_t i = 0; i < meshes.size(); ++i) {
+            meshes[i].CopyBuffers(vbo, (size_t)modelRanges[i].baseVertex * sizeof(StaticVertex),
+                                  ebo, (size_t)modelRanges[i].firstIndex * sizeof(unsigned int));
+        }
+    }
+
+    spdlog::info("Static geometry pool: " + std::to_string(ranges.size()) + " models, " +
+                 std::to_string(verticesCount) + " vertices, " + std::to_string(indicesCount) + " indices");
+}
+
+void StaticGeometryPool::Clear() {
+    ranges.clear();
+    pendingCount = 0;
+    drawsCount = 0;
+
+    if (vao == 0) return;
+    glDeleteVertexArrays(1, &vao);
+    glDeleteBuffers(1, &vbo);
+    glDeleteBuffers(1, &ebo);
+    vao = 0;
+    vbo = 0;
+    ebo = 0;
+}
+
+bool StaticGeometryPool::Contains(Model* model) const {
+    return ranges.contains(model);
+}
+
+void StaticGeometryPool::BeginFrame() {
+    pendingCount = 0;
+    drawsCount = 0;
+}
+
+/**
+ * @annotation
+ * Adds one indirect command per mesh of the model, instances are read from RendererManager's instance buffer
+ * @returns false if model isn't in the pool or there is no space left for its commands
+ */
+bool StaticGeometryPool::AddInstances(Model* model, const Material& material, bool drawShadows,
+                                      unsigned int firstInstance, unsigned int instanceCount) {
+    auto modelRanges = ranges.find(model);
+    if (modelRanges == ranges.end()) return false;
+    if (pendingCount + modelRanges->second.size() > MAX_POOL_COMMANDS) return false;
+
+    for (const auto& range : modelRanges->second) {
+        unsigned int textureKey = range.textures->empty() ? 0 : range.textures->front().id;
+        uint64_t key = (uint64_t)RendererManager::CreateMaterialKey(material, glm::vec2(1.0f), false) << 32 |
+                       (uint64_t)(drawShadows ? 1 : 0) << 31 | (textureKey & 0x7FFFFFFF);
+
+        pending[pendingCount] = {key, range.textures, material, drawShadows,
+                                 {range.indexCount, instanceCount, range.firstIndex, range.baseVertex, firstInstance}};
+        ++pendingCount;
+    }
+    return true;
+}
+
+/**
+ * @annotation
+ * Orders added commands by material and textures, merges them into draws and uploads them to the indirect buffer
+ */
+void StaticGeometryPool::EndFrame() {
+    if (pendingCount == 0) return;
+
+    std::sort(pending, pending + pendingCount, [](const PendingCommand& a, const PendingCommand& b) {
+        return a.key < b.key;
+    });
+
+    for (unsigned int i = 0; i < pendingCount; ++i) {
+        const PendingCommand& command = pending[i];
+        commands[i] = command.command;
+
+        if (drawsCount > 0) {
+            PoolDraw& last = draws[drawsCount - 1];
+            bool sameTextures = last.textures->size() == command.textures->size() &&
+                    std::equal(last.textures->begin(), last.textures->end(), command.textures->begin(),
+                               [](const Texture& a, const Texture& b) { return a.id == b.id; });
+            if (sameTextures && last.drawShadows == command.drawShadows &&
+                last.material.shininess == command.material.shininess &&
+                last.material.reflection == command.material.reflection &&
+                last.material.refraction == command.material.refraction) {
+                ++last.commandsCount;
+                continue;
+            }
+        }
+        draws[drawsCount] = {command.textures, command.material, command.drawShadows, i, 1};
+        ++drawsCount;
+    }
+
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer);
+    glBufferData(GL_DRAW_INDIRECT_BUFFER, sizeof(commands), nullptr, GL_DYNAMIC_DRAW);
+    glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, pendingCount * sizeof(DrawElementsIndirectCommand), commands);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
+void StaticGeometryPool::Draw(const std::shared_ptr<Shader>& shader, bool isShadowPass) {
+    if (drawsCount == 0) return;
+
+    auto rendererManager = RendererManager::GetInstance();
+    rendererManager->BindShader(shader);
+    rendererManager->BindVertexArray(vao);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer);
+
+    for (unsigned int i = 0; i < drawsCount; ++i) {
+        const PoolDraw& draw = draws[i];
+        if (isShadowPass && !draw.drawShadows) continue;
+
+        rendererManager->ApplyMaterial(shader, draw.material, glm::vec2(1.0f), false, true);
+        rendererManager->BindTextures(shader, *draw.textures);
+        glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT,
+                                    (void*)(draw.firstCommand * sizeof(DrawElementsIndirectCommand)),
+                                    (int)draw.commandsCount, 0);
+
+        for (unsigned int j = draw.firstCommand; j < draw.firstCommand + draw.commandsCount; ++j) {
+            rendererManager->requestedStats.drawCalls += commands[j].instanceCount;
+        }
+        ++rendererManager->issuedStats.drawCalls;
+    }
+
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
@@ -1,5 +1,8 @@
 #include "LowLevelClasses/StaticModel.h"
 
+#include "LowLevelClasses/MeshCache.h"
+#include "LowLevelClasses/AssimpFileSystem.h"
+
 #include "assimp/Importer.hpp"
 #include "assimp/postprocess.h"
 #include "glad/glad.h"
@@ -15,21 +18,52 @@ StaticModel::StaticModel(const std::string &path, std::shared_ptr<Shader> &shade
 StaticModel::StaticModel(const Mesh &mesh, std::shared_ptr<Shader> &shader,
                          int type) : Model(mesh, shader, type) {}
 
+StaticModel::StaticModel(std::shared_ptr<Shader> &shader) : Model("", shader) {}
+
 void StaticModel::LoadModel(std::string const &path)
+{
+    // retrieve the directory path of the filepath
+    directory = path.substr(0, path.find_last_of('/'));
+    // cooked meshes are uploaded straight from the mapped file, Assimp only runs when there is none or the source changed
+    CookedModel cooked;
+    if (cooked.Open(path, false)) {
+        LoadCookedMeshes(cooked);
+        return;
+    }
+    Import(path);
+}
+
+bool StaticModel::Cook(const std::string &path) {
+    CookedModel cooked;
+    if (cooked.Open(path, false)) return true;
+    std::shared_ptr<Shader> shader;
+    StaticModel model(shader);
+    model.directory = path.substr(0, path.find_last_of('/'));
+    model.isCookingOnly = true;
+    return model.Import(path);
+}
+
+bool StaticModel::Import(const std::string &path)
 {
     // read file via ASSIMP
     Assimp::Importer importer;
+    importer.SetIOHandler(new AssimpFileSystem());
     const aiScene* scene = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_GenNormals | aiProcess_CalcTangentSpace | aiProcess_FixInfacingNormals);
     // check for errors
     if(!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) // if is Not Zero
     {
         spdlog::error("ERROR::ASSIMP:: ", importer.GetErrorString());
-        return;
+        return false;
     }
-    // retrieve the directory path of the filepath
-    directory = path.substr(0, path.find_last_of('/'));
-    // process ASSIMP's root node recursively
+    // nodes may share meshes, so there can be more, the vector then grows by moving them
+    if (!isCookingOnly) meshes.reserve(scene->mNumMeshes);
+    // process ASSIMP's root node recursively, cooking every mesh for the next load
+    ModelCooker modelCooker;
+    cooker = &modelCooker;
     ProcessNode(scene->mRootNode, scene);
+    cooker = nullptr;
+    modelCooker.Write(path, false);
+    return true;
 }
 
 void StaticModel::ProcessNode(aiNode *node, const aiScene *scene)
@@ -131,5 +165,6 @@ void StaticModel::ProcessMesh(aiMesh *mesh, const aiScene *scene)
     textures.insert(textures.end(), heightMaps.begin(), heightMaps.end());
 
     // return a mesh object created from the extracted mesh data
-    meshes.emplace_back(vertices, indices, textures);
+    if (cooker != nullptr) cooker->AddMesh(VertexLayout::Static, textures, vertices, indices);
+    if (!isCookingOnly) meshes.emplace_back(vertices, indices, textures, VertexLayout::Static);
 }
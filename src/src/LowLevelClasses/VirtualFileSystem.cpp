@@ -0,0 +1,214 @@
+#include "LowLevelClasses/VirtualFileSystem.h"
+#include "spdlog/spdlog.h"
+#include "lz4.h"
+
+#include <filesystem>
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+VirtualFile::VirtualFile(VirtualFile&& other) noexcept {
+    *this = std::move(other);
+}
+
+// mapped and decompressed content don't move in memory, so data stays valid
+VirtualFile& VirtualFile::operator=(VirtualFile&& other) noexcept {
+    if (this == &other) return *this;
+    file = std::move(other.file);
+    content = std::move(other.content);
+    data = std::exchange(other.data, nullptr);
+    size = std::exchange(other.size, 0);
+    return *this;
+}
+
+bool VirtualFile::IsOpen() const {
+    return data != nullptr;
+}
+
+const unsigned char* VirtualFile::GetData() const {
+    return data;
+}
+
+size_t VirtualFile::GetSize() const {
+    return size;
+}
+
+std::string_view VirtualFile::GetText() const {
+    return {(const char*)data, size};
+}
+
+void VirtualFile::Close() {
+    file.Close();
+    content.clear();
+    content.shrink_to_fit();
+    data = nullptr;
+    size = 0;
+}
+
+// data of empty files, so they are open
+static const unsigned char emptyContent[1] = {0};
+
+VirtualFileSystem::VirtualFileSystem() = default;
+
+VirtualFileSystem::~VirtualFileSystem() {
+    delete virtualFileSystem;
+}
+
+VirtualFileSystem* VirtualFileSystem::GetInstance() {
+    if (virtualFileSystem == nullptr) {
+        virtualFileSystem = new VirtualFileSystem();
+    }
+    return virtualFileSystem;
+}
+
+bool VirtualFileSystem::Mount(const std::string& packPath) {
+    if (!pack.Open(packPath)) return false;
+    spdlog::info("Mounted " + packPath + " with " + std::to_string(pack.GetEntriesCount()) + " files");
+
+#ifdef DEBUG
+    // loose files are checked once here, reads only look the result up
+    editedEntries.clear();
+    for (uint32_t i = 0; i < pack.GetEntriesCount(); ++i) {
+        const PackEntry& entry = pack.GetEntry(i);
+        if (IsEdited(std::string(pack.GetPath(entry)), entry)) editedEntries.insert(&entry);
+    }
+    if (!editedEntries.empty()) {
+        spdlog::info(std::to_string(editedEntries.size()) + " loose files edited after packing override packed ones");
+    }
+#endif
+    return true;
+}
+
+bool VirtualFileSystem::Open(const std::string& path, VirtualFile& file) {
+    file.Close();
+    const PackEntry* entry = pack.Find(NormalizePath(path));
+    if (entry == nullptr || editedEntries.contains(entry)) {
+        if (file.file.Open(path)) {
+            file.data = file.file.GetData();
+            file.size = file.file.GetSize();
+        }
+        // empty files can't be mapped, they are opened without content instead of reading a stale packed copy
+        else if (IsEmpty(path)) {
+            file.data = emptyContent;
+            file.size = 0;
+        }
+        else {
+            return false;
+        }
+        ++looseCount;
+        return true;
+    }
+    ++packedCount;
+
+    if (entry->compression == PackCompression::None) {
+        file.data = pack.GetContent(*entry);
+        file.size = entry->size;
+        return true;
+    }
+
+    file.content.resize(entry->originalSize);
+    int decompressedSize = LZ4_decompress_safe((const char*)pack.GetContent(*entry), (char*)file.content.data(),
+                                               (int)entry->size, (int)entry->originalSize);
+    if (decompressedSize != (int)entry->originalSize) {
+        spdlog::error("Failed to decompress packed file: " + path);
+        file.Close();
+        return false;
+    }
+    ++decompressedCount;
+    file.data = file.content.data();
+    file.size = file.content.size();
+    return true;
+}
+
+bool VirtualFileSystem::Exists(const std::string& path) {
+    if (pack.Find(NormalizePath(path)) != nullptr) return true;
+    std::error_code error;
+    return std::filesystem::is_regular_file(path, error);
+}
+
+bool VirtualFileSystem::GetInfo(const std::string& path, VirtualFileInfo& info) {
+    const PackEntry* entry = pack.Find(NormalizePath(path));
+    if (entry != nullptr && !editedEntries.contains(entry)) {
+        info.size = entry->originalSize;
+        info.writeTime = entry->writeTime;
+        info.contentHash = entry->contentHash;
+        info.isPacked = true;
+        return true;
+    }
+
+    std::error_code error;
+    if (std::filesystem::is_regular_file(path, error)) {
+        info.size = std::filesystem::file_size(path, error);
+        if (error) return false;
+        info.writeTime = (int64_t)std::filesystem::last_write_time(path, error).time_since_epoch().count();
+        if (error) return false;
+        info.contentHash = 0;
+        info.isPacked = false;
+        return true;
+    }
+    return false;
+}
+
+bool VirtualFileSystem::IsMounted() const {
+    return pack.IsOpen();
+}
+
+uint32_t VirtualFileSystem::GetPackedFilesCount() const {
+    return pack.GetEntriesCount();
+}
+
+unsigned int VirtualFileSystem::GetLooseCount() const {
+    return looseCount;
+}
+
+unsigned int VirtualFileSystem::GetPackedCount() const {
+    return packedCount;
+}
+
+unsigned int VirtualFileSystem::GetDecompressedCount() const {
+    return decompressedCount;
+}
+
+std::string VirtualFileSystem::NormalizePath(const std::string& path) {
+    std::filesystem::path normalizedPath(path);
+    if (normalizedPath.is_absolute()) {
+        std::error_code error;
+        normalizedPath = normalizedPath.lexically_relative(std::filesystem::current_path(error));
+    }
+    return normalizedPath.lexically_normal().generic_string();
+}
+
+std::string VirtualFileSystem::GetExecutableDirectory() {
+    std::error_code error;
+#ifdef _WIN32
+    char executablePath[MAX_PATH];
+    DWORD length = GetModuleFileNameA(nullptr, executablePath, MAX_PATH);
+    if (length > 0 && length < MAX_PATH) {
+        return std::filesystem::path(std::string(executablePath, length)).parent_path().string();
+    }
+#else
+    std::filesystem::path executablePath = std::filesystem::read_symlink("/proc/self/exe", error);
+    if (!error) return executablePath.parent_path().string();
+#endif
+    return std::filesystem::current_path(error).string();
+}
+
+// packed files keep the write time of their source, so a symlinked or copied res isn't read instead of the archive
+bool VirtualFileSystem::IsEdited(const std::string& path, const PackEntry& entry) {
+    std::error_code error;
+    auto writeTime = std::filesystem::last_write_time(path, error);
+    if (error) return false;
+    if ((int64_t)writeTime.time_since_epoch().count() > entry.writeTime) return true;
+    uint64_t size = std::filesystem::file_size(path, error);
+    return !error && size != entry.originalSize;
+}
+
+bool VirtualFileSystem::IsEmpty(const std::string& path) {
+    std::error_code error;
+    if (!std::filesystem::is_regular_file(path, error)) return false;
+    return std::filesystem::file_size(path, error) == 0 && !error;
+}
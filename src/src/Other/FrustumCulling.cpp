@@ -81,16 +81,8 @@ std::shared_ptr<AABB> FrustumCulling::GenerateAABB(const std::shared_ptr<Model>
     auto maxAABB = glm::vec3(std::numeric_limits<float>::min());
     for (auto&& mesh : model->GetMeshes())
     {
-        for (auto&& vertex : mesh.vertices)
-        {
-            minAABB.x = std::min(minAABB.x, vertex.position.x);
-            minAABB.y = std::min(minAABB.y, vertex.position.y);
-            minAABB.z = std::min(minAABB.z, vertex.position.z);
-
-            maxAABB.x = std::max(maxAABB.x, vertex.position.x);
-            maxAABB.y = std::max(maxAABB.y, vertex.position.y);
-            maxAABB.z = std::max(maxAABB.z, vertex.position.z);
-        }
+        minAABB = glm::min(minAABB, mesh.minPosition);
+        maxAABB = glm::max(maxAABB, mesh.maxPosition);
     }
     return std::make_shared<AABB>(minAABB, maxAABB);
 }
@@ -0,0 +1,148 @@
+/**
+ * @annotation
+ * Bundles every file under res into one archive read by VirtualFileSystem, paths are stored as "res/...".
+ * Cooked files, saves and files only the build uses are left out, the game makes them again next to the archive.
+ * With --compress text files are stored LZ4 compressed if that saves enough, images, block compressed textures
+ * and sounds stay uncompressed, so they are still read in place from the mapped archive.
+ * Usage: PackFiles <res directory> <output pack> [--compress]
+ */
+
+#include "LowLevelClasses/PackFile.h"
+#include "lz4hc.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+// compressed content has to be at most this part of the original to be stored compressed
+#define PACK_COMPRESSION_RATIO 0.9f
+
+struct PackedFile {
+    std::string path;
+    std::vector<char> content;
+    PackEntry entry{};
+};
+
+static bool IsExcluded(const std::string& relativePath, const std::string& extension) {
+    if (relativePath.starts_with("cooked/") || relativePath.starts_with("ProjectConfig/Saves/")) return true;
+    return extension == ".rc" || extension == ".ico";
+}
+
+// already compressed or read in place by the engine
+static bool IsStored(const std::string& extension) {
+    return extension == ".png" || extension == ".jpg" || extension == ".jpeg" || extension == ".dds" ||
+           extension == ".wav";
+}
+
+static bool ReadFile(const std::filesystem::path& path, std::vector<char>& content) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) return false;
+    content.resize((size_t)file.tellg());
+    file.seekg(0);
+    file.read(content.data(), (std::streamsize)content.size());
+    return (bool)file;
+}
+
+static void Compress(PackedFile& file) {
+    int bound = LZ4_compressBound((int)file.content.size());
+    std::vector<char> compressed(bound);
+    int size = LZ4_compress_HC(file.content.data(), compressed.data(), (int)file.content.size(), bound,
+                               LZ4HC_CLEVEL_MAX);
+    if (size <= 0 || (float)size > (float)file.content.size() * PACK_COMPRESSION_RATIO) return;
+    compressed.resize(size);
+    file.content = std::move(compressed);
+    file.entry.compression = PackCompression::LZ4;
+}
+
+static uint64_t Align(uint64_t offset) {
+    return (offset + PACK_FILE_ALIGNMENT - 1) / PACK_FILE_ALIGNMENT * PACK_FILE_ALIGNMENT;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cout << "Usage: PackFiles <res directory> <output pack> [--compress]" << std::endl;
+        return 1;
+    }
+    const std::filesystem::path resPath = argv[1];
+    const std::filesystem::path outputPath = argv[2];
+    const bool isCompressing = argc > 3 && std::strcmp(argv[3], "--compress") == 0;
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<PackedFile> files;
+    size_t originalSize = 0;
+    unsigned int compressedCount = 0;
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(resPath)) {
+        if (!entry.is_regular_file()) continue;
+        std::string relativePath = std::filesystem::relative(entry.path(), resPath).generic_string();
+        std::string extension = entry.path().extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+        if (IsExcluded(relativePath, extension)) continue;
+
+        PackedFile file;
+        file.path = "res/" + relativePath;
+        if (!ReadFile(entry.path(), file.content)) {
+            std::cout << "Failed to read " << entry.path().string() << std::endl;
+            return 1;
+        }
+        file.entry.pathHash = PackFile::Hash(file.path.data(), file.path.size());
+        file.entry.originalSize = file.content.size();
+        file.entry.contentHash = PackFile::Hash(file.content.data(), file.content.size());
+        file.entry.writeTime = (int64_t)entry.last_write_time().time_since_epoch().count();
+        file.entry.compression = PackCompression::None;
+        if (isCompressing && !IsStored(extension)) Compress(file);
+        if (file.entry.compression != PackCompression::None) ++compressedCount;
+        file.entry.size = file.content.size();
+        originalSize += file.entry.originalSize;
+        files.push_back(std::move(file));
+    }
+    std::sort(files.begin(), files.end(), [](const PackedFile& a, const PackedFile& b) {
+        return a.entry.pathHash < b.entry.pathHash;
+    });
+
+    // header, content of every file, then the entries and their paths
+    PackHeader header{};
+    header.magic = PACK_FILE_MAGIC;
+    header.version = PACK_FILE_VERSION;
+    header.entriesCount = (uint32_t)files.size();
+    uint64_t offset = Align(sizeof(PackHeader));
+    for (auto& file : files) {
+        file.entry.offset = offset;
+        offset = Align(offset + file.entry.size);
+    }
+    std::string paths;
+    for (auto& file : files) {
+        file.entry.pathOffset = (uint32_t)paths.size();
+        file.entry.pathLength = (uint32_t)file.path.size();
+        paths += file.path;
+    }
+    header.entriesOffset = offset;
+    header.pathsOffset = header.entriesOffset + files.size() * sizeof(PackEntry);
+    header.pathsSize = paths.size();
+
+    std::ofstream output(outputPath, std::ios::binary);
+    const char padding[PACK_FILE_ALIGNMENT] = {};
+    output.write((const char*)&header, sizeof(header));
+    output.write(padding, (std::streamsize)(Align(sizeof(header)) - sizeof(header)));
+    for (const auto& file : files) {
+        output.write(file.content.data(), (std::streamsize)file.content.size());
+        output.write(padding, (std::streamsize)(Align(file.entry.size) - file.entry.size));
+    }
+    for (const auto& file : files) {
+        output.write((const char*)&file.entry, sizeof(PackEntry));
+    }
+    output.write(paths.data(), (std::streamsize)paths.size());
+    if (!output) {
+        std::cout << "Failed to write " << outputPath.string() << std::endl;
+        return 1;
+    }
+
+    float seconds = std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Packed " << files.size() << " files in " << seconds << " s, " << compressedCount
+              << " compressed. Archive: " << (float)(header.pathsOffset + header.pathsSize) / 1000000.0f
+              << " Mb of " << (float)originalSize / 1000000.0f << " Mb of files" << std::endl;
+    return 0;
+}
@@ -0,0 +1,315 @@
+/**
+ * @annotation
+ * Converts every .png and .jpg under res/textures and res/models into a .dds file with block compressed mip levels.
+ * Outputs mirror the paths below res, e.g. res/textures/UI/a.png becomes <output>/textures/UI/a.dds,
+ * which is where TextureManager looks for a compressed variant before decoding the image.
+ * Images are flipped like at runtime and keep their channels: 1 -> BC4, 2 -> BC5, 3 -> BC1, 4 -> BC3.
+ * Usage: TextureCompressor <res directory> <output directory>
+ */
+
+#include "LowLevelClasses/DDS.h"
+#include "stb_image.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+struct Image {
+    int width = 0, height = 0, nrChannels = 0;
+    std::vector<unsigned char> pixels;
+};
+
+static Image Downsample(const Image& source) {
+    Image level;
+    level.width = std::max(source.width / 2, 1);
+    level.height = std::max(source.height / 2, 1);
+    level.nrChannels = source.nrChannels;
+    level.pixels.resize((size_t)level.width * level.height * level.nrChannels);
+
+    for (int y = 0; y < level.height; ++y) {
+        for (int x = 0; x < level.width; ++x) {
+            int x0 = std::min(x * 2, source.width - 1), x1 = std::min(x * 2 + 1, source.width - 1);
+            int y0 = std::min(y * 2, source.height - 1), y1 = std::min(y * 2 + 1, source.height - 1);
+            for (int c = 0; c < source.nrChannels; ++c) {
+                int sum = source.pixels[(y0 * source.width + x0) * source.nrChannels + c] +
+                          source.pixels[(y0 * source.width + x1) * source.nrChannels + c] +
+                          source.pixels[(y1 * source.width + x0) * source.nrChannels + c] +
+                          source.pixels[(y1 * source.width + x1) * source.nrChannels + c];
+                level.pixels[(y * level.width + x) * level.nrChannels + c] = (unsigned char)((sum + 2) / 4);
+            }
+        }
+    }
+    return level;
+}
+
+// 4x4 texels of the block, texels outside of the image repeat the border
+static void GetBlock(const Image& image, int blockX, int blockY, unsigned char block[16][4]) {
+    for (int y = 0; y < 4; ++y) {
+        for (int x = 0; x < 4; ++x) {
+            int sourceX = std::min(blockX * 4 + x, image.width - 1);
+            int sourceY = std::min(blockY * 4 + y, image.height - 1);
+            const unsigned char* texel = &image.pixels[(sourceY * image.width + sourceX) * image.nrChannels];
+            for (int c = 0; c < 4; ++c) {
+                block[y * 4 + x][c] = c < image.nrChannels ? texel[c] : (c == 3 ? 255 : 0);
+            }
+        }
+    }
+}
+
+static uint16_t To565(const float color[3]) {
+    int r = std::clamp((int)std::lround(color[0] * 31.0f / 255.0f), 0, 31);
+    int g = std::clamp((int)std::lround(color[1] * 63.0f / 255.0f), 0, 63);
+    int b = std::clamp((int)std::lround(color[2] * 31.0f / 255.0f), 0, 31);
+    return (uint16_t)((r << 11) | (g << 5) | b);
+}
+
+static void From565(uint16_t color, float result[3]) {
+    result[0] = (float)((color >> 11) & 31) * 255.0f / 31.0f;
+    result[1] = (float)((color >> 5) & 63) * 255.0f / 63.0f;
+    result[2] = (float)(color & 31) * 255.0f / 31.0f;
+}
+
+/**
+ * Endpoints are the extremes of the texels projected on their principal axis,
+ * always in the four color mode, so BC1 stays opaque and the block is valid inside BC3
+ */
+static void EncodeColorBlock(const unsigned char block[16][4], unsigned char* output) {
+    float mean[3] = {0, 0, 0};
+    for (int i = 0; i < 16; ++i)
+        for (int c = 0; c < 3; ++c) mean[c] += (float)block[i][c] / 16.0f;
+
+    float covariance[6] = {0, 0, 0, 0, 0, 0};
+    for (int i = 0; i < 16; ++i) {
+        float r = block[i][0] - mean[0], g = block[i][1] - mean[1], b = block[i][2] - mean[2];
+        covariance[0] += r * r; covariance[1] += r * g; covariance[2] += r * b;
+        covariance[3] += g * g; covariance[4] += g * b; covariance[5] += b * b;
+    }
+    float axis[3] = {1.0f, 1.0f, 1.0f};
+    for (int iteration = 0; iteration < 8; ++iteration) {
+        float next[3] = {covariance[0] * axis[0] + covariance[1] * axis[1] + covariance[2] * axis[2],
+                         covariance[1] * axis[0] + covariance[3] * axis[1] + covariance[4] * axis[2],
+                         covariance[2] * axis[0] + covariance[4] * axis[1] + covariance[5] * axis[2]};
+        float length = std::sqrt(next[0] * next[0] + next[1] * next[1] + next[2] * next[2]);
+        if (length < 1e-6f) break;
+        for (int c = 0; c < 3; ++c) axis[c] = next[c] / length;
+    }
+
+    float minProjection = 1e9f, maxProjection = -1e9f;
+    for (int i = 0; i < 16; ++i) {
+        float projection = 0.0f;
+        for (int c = 0; c < 3; ++c) projection += ((float)block[i][c] - mean[c]) * axis[c];
+        minProjection = std::min(minProjection, projection);
+        maxProjection = std::max(maxProjection, projection);
+    }
+    float maxColor[3], minColor[3];
+    for (int c = 0; c < 3; ++c) {
+        maxColor[c] = mean[c] + axis[c] * maxProjection;
+        minColor[c] = mean[c] + axis[c] * minProjection;
+    }
+
+    uint16_t color0 = To565(maxColor), color1 = To565(minColor);
+    if (color0 < color1) std::swap(color0, color1);
+
+    float palette[4][3];
+    From565(color0, palette[0]);
+    From565(color1, palette[1]);
+    for (int c = 0; c < 3; ++c) {
+        palette[2][c] = (2.0f * palette[0][c] + palette[1][c]) / 3.0f;
+        palette[3][c] = (palette[0][c] + 2.0f * palette[1][c]) / 3.0f;
+    }
+
+    uint32_t indices = 0;
+    if (color0 != color1) {
+        for (int i = 0; i < 16; ++i) {
+            int best = 0;
+            float bestDistance = 1e9f;
+            for (int p = 0; p < 4; ++p) {
+                float distance = 0.0f;
+                for (int c = 0; c < 3; ++c) {
+                    float difference = (float)block[i][c] - palette[p][c];
+                    distance += difference * difference;
+                }
+                if (distance < bestDistance) {
+                    bestDistance = distance;
+                    best = p;
+                }
+            }
+            indices |= (uint32_t)best << (i * 2);
+        }
+    }
+
+    std::memcpy(output, &color0, 2);
+    std::memcpy(output + 2, &color1, 2);
+    std::memcpy(output + 4, &indices, 4);
+}
+
+// BC4 block of one channel, also the alpha block of BC3, uses the eight value mode
+static void EncodeChannelBlock(const unsigned char block[16][4], int channel, unsigned char* output) {
+    int minValue = 255, maxValue = 0;
+    for (int i = 0; i < 16; ++i) {
+        minValue = std::min(minValue, (int)block[i][channel]);
+        maxValue = std::max(maxValue, (int)block[i][channel]);
+    }
+    output[0] = (unsigned char)maxValue;
+    output[1] = (unsigned char)minValue;
+
+    uint64_t indices = 0;
+    if (maxValue != minValue) {
+        int palette[8];
+        palette[0] = maxValue;
+        palette[1] = minValue;
+        for (int p = 1; p < 7; ++p) palette[p + 1] = ((7 - p) * maxValue + p * minValue) / 7;
+
+        for (int i = 0; i < 16; ++i) {
+            int best = 0;
+            for (int p = 1; p < 8; ++p) {
+                if (std::abs(block[i][channel] - palette[p]) < std::abs(block[i][channel] - palette[best])) best = p;
+            }
+            indices |= (uint64_t)best << (i * 3);
+        }
+    }
+    for (int i = 0; i < 6; ++i) output[2 + i] = (unsigned char)(indices >> (i * 8));
+}
+
+static void EncodeLevel(const Image& image, uint32_t fourCC, std::vector<unsigned char>& output) {
+    const int blocksX = (image.width + 3) / 4, blocksY = (image.height + 3) / 4;
+    const uint32_t blockSize = GetDDSBlockSize(fourCC);
+    size_t offset = output.size();
+    output.resize(offset + (size_t)blocksX * blocksY * blockSize);
+
+    unsigned char block[16][4];
+    for (int blockY = 0; blockY < blocksY; ++blockY) {
+        for (int blockX = 0; blockX < blocksX; ++blockX) {
+            GetBlock(image, blockX, blockY, block);
+            unsigned char* destination = &output[offset];
+            if (fourCC == DDS_BC1) {
+                EncodeColorBlock(block, destination);
+            } else if (fourCC == DDS_BC3) {
+                EncodeChannelBlock(block, 3, destination);
+                EncodeColorBlock(block, destination + 8);
+            } else if (fourCC == DDS_BC4) {
+                EncodeChannelBlock(block, 0, destination);
+            } else {
+                EncodeChannelBlock(block, 0, destination);
+                EncodeChannelBlock(block, 1, destination + 8);
+            }
+            offset += blockSize;
+        }
+    }
+}
+
+// decodedSize is what the image takes in VRAM when uploaded uncompressed with mipmaps
+static bool Compress(const std::filesystem::path& input, const std::filesystem::path& output, size_t& decodedSize,
+                     size_t& compressedSize) {
+    Image image;
+    unsigned char* data = stbi_load(input.string().c_str(), &image.width, &image.height, &image.nrChannels, 0);
+    if (!data) {
+        std::cout << "Failed to load texture at path: " << input.string() << std::endl;
+        return false;
+    }
+    image.pixels.assign(data, data + (size_t)image.width * image.height * image.nrChannels);
+    stbi_image_free(data);
+    decodedSize = image.pixels.size() * 4 / 3;
+
+    uint32_t fourCC = DDS_BC3;
+    if (image.nrChannels == 1)
+        fourCC = DDS_BC4;
+    else if (image.nrChannels == 2)
+        fourCC = DDS_BC5;
+    else if (image.nrChannels == 3)
+        fourCC = DDS_BC1;
+
+    const uint32_t width = image.width, height = image.height;
+    // the same chain glGenerateMipmap would create
+    std::vector<unsigned char> levels;
+    uint32_t levelsCount = 1;
+    EncodeLevel(image, fourCC, levels);
+    while (image.width > 1 || image.height > 1) {
+        image = Downsample(image);
+        EncodeLevel(image, fourCC, levels);
+        ++levelsCount;
+    }
+
+    DDSHeader header{};
+    header.size = sizeof(DDSHeader);
+    header.flags = DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT | DDSD_MIPMAPCOUNT | DDSD_LINEARSIZE;
+    header.width = width;
+    header.height = height;
+    header.pitchOrLinearSize = GetDDSLevelSize(fourCC, width, height);
+    header.mipMapCount = levelsCount;
+    header.pixelFormat.size = sizeof(DDSPixelFormat);
+    header.pixelFormat.flags = DDPF_FOURCC;
+    header.pixelFormat.fourCC = fourCC;
+    header.caps = DDSCAPS_TEXTURE | DDSCAPS_MIPMAP | DDSCAPS_COMPLEX;
+
+    std::filesystem::create_directories(output.parent_path());
+    std::ofstream file(output, std::ios::binary);
+    if (!file) {
+        std::cout << "Failed to write a file at path: " << output.string() << std::endl;
+        return false;
+    }
+    uint32_t magic = DDS_MAGIC;
+    file.write((const char*)&magic, sizeof(magic));
+    file.write((const char*)&header, sizeof(header));
+    file.write((const char*)levels.data(), (std::streamsize)levels.size());
+    compressedSize = levels.size();
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cout << "Usage: TextureCompressor <res directory> <output directory>" << std::endl;
+        return 1;
+    }
+    const std::filesystem::path resPath = argv[1];
+    const std::filesystem::path outputPath = argv[2];
+    // rows go bottom up like in every texture the engine loads
+    stbi_set_flip_vertically_on_load(true);
+
+    auto start = std::chrono::steady_clock::now();
+    unsigned int compressedCount = 0, skippedCount = 0, failedCount = 0;
+    size_t decodedSize = 0, compressedSize = 0;
+    for (const auto& directory : {"textures", "models"}) {
+        if (!std::filesystem::exists(resPath / directory)) continue;
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(resPath / directory)) {
+            if (!entry.is_regular_file()) continue;
+            std::string extension = entry.path().extension().string();
+            std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+            if (extension != ".png" && extension != ".jpg" && extension != ".jpeg") continue;
+
+            std::filesystem::path relativePath = std::filesystem::relative(entry.path(), resPath);
+            // cube map faces aren't flipped at runtime, so they keep being loaded from the images
+            if (relativePath.generic_string().starts_with("textures/skybox/")) continue;
+
+            std::filesystem::path output = outputPath / relativePath;
+            output.replace_extension(".dds");
+            // only images changed since the last run are compressed again
+            if (std::filesystem::exists(output) &&
+                std::filesystem::last_write_time(output) >= std::filesystem::last_write_time(entry.path())) {
+                ++skippedCount;
+                continue;
+            }
+
+            size_t imageDecodedSize = 0, imageCompressedSize = 0;
+            if (Compress(entry.path(), output, imageDecodedSize, imageCompressedSize)) {
+                ++compressedCount;
+                decodedSize += imageDecodedSize;
+                compressedSize += imageCompressedSize;
+            }
+            else {
+                ++failedCount;
+            }
+        }
+    }
+
+    float seconds = std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Compressed " << compressedCount << " textures in " << seconds << " s, " << skippedCount
+              << " up to date, " << failedCount << " failed. VRAM with mipmaps: " << (float)compressedSize / 1000000.0f
+              << " Mb instead of " << (float)decodedSize / 1000000.0f << " Mb decoded" << std::endl;
+    return failedCount > 0 ? 1 : 0;
+}